@@ -0,0 +1,54 @@
+#include <Wire.h>
+#include <EEPROM.h>
+#include <Miniquad.h>
+
+// The global instance for Miniquad
+Miniquad copter;
+
+
+// Print the sensor offsets
+void printCalibration(MiniquadCalibration& calibration)
+{
+  Serial.print("accel offsets: ");
+  Serial.print(calibration.accelOffset[0]); Serial.print("\t");
+  Serial.print(calibration.accelOffset[1]); Serial.print("\t");
+  Serial.print(calibration.accelOffset[2]); Serial.print("\n");
+  Serial.print("gyro offsets: ");
+  Serial.print(calibration.gyroOffset[0]); Serial.print("\t");
+  Serial.print(calibration.gyroOffset[1]); Serial.print("\t");
+  Serial.print(calibration.gyroOffset[2]); Serial.print("\n");
+}
+
+void setup()
+{
+  // Serial initialization (just for data displayment)
+  Serial.begin(115200);
+
+  // Miniquad Zero initialization (applies the calibration kept in the EEPROM)
+  copter.Initialize();
+  if (copter.IsCalibrated())
+  {
+    Serial.println("calibration loaded from EEPROM");
+    printCalibration(copter.GetCalibration());
+  }
+
+  // Calibrate again, the copter has to stand still and level
+  Serial.println("calibrating, keep the copter still and level...");
+  delay(1000);
+  while (!copter.CalibrateSensors())
+  {
+    Serial.println("moved during calibration, retrying...");
+  }
+  Serial.println("calibration saved to EEPROM");
+  printCalibration(copter.GetCalibration());
+}
+
+void loop()
+{
+  // Show the calibrated rotation, which should stay around 0 when still
+  copter.RefreshDmpData();
+  Rotation& rot = copter.GetRotation();
+  Serial.print(rot.getX()); Serial.print("\t");
+  Serial.print(rot.getY()); Serial.print("\t");
+  Serial.print(rot.getZ()); Serial.print("\n");
+}
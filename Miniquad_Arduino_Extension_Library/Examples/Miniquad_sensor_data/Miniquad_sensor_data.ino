@@ -1,4 +1,5 @@
 #include <Wire.h>
+#include <EEPROM.h>
 #include <Miniquad.h>
 
 // The global instance for Miniquad
@@ -0,0 +1,57 @@
+#include <Wire.h>
+#include <EEPROM.h>
+#include <Miniquad.h>
+
+// The global instance for Miniquad
+Miniquad copter;
+
+// The last reported initialization stage
+uint8_t reportedStage = MINIQUAD_INIT_IDLE;
+
+
+void setup()
+{
+  // Serial initialization (comes up before the DMP firmware is loaded)
+  Serial.begin(115200);
+  Serial.println("Miniquad booting");
+  
+  // Miniquad Zero staged initialization (carried on in loop)
+  copter.BeginInitialize();
+}
+
+void loop()
+{
+  // Carry on the initialization until it is done or failed
+  uint8_t stage = copter.StepInitialize();
+  
+  // Report each finished stage with its elapsed time
+  if (stage != reportedStage)
+  {
+    Serial.print("stage "); Serial.print(reportedStage);
+    Serial.print(" done in "); Serial.print(copter.GetInitStageTime(reportedStage));
+    Serial.print(" ms\n");
+    reportedStage = stage;
+    
+    if (stage == MINIQUAD_INIT_DONE)
+    {
+      Serial.print(copter.IsDmpWarmStart() ? "warm" : "cold"); Serial.print(" start, DMP upload ");
+      Serial.print(copter.GetDmpUploadTime()); Serial.print(" us\n");
+    }
+    if (stage == MINIQUAD_INIT_FAILED)
+    {
+      Serial.print("failed in stage "); Serial.print(copter.GetInitErrorStage());
+      Serial.print(", error "); Serial.print(copter.GetInitError()); Serial.print("\n");
+    }
+  }
+  if (stage != MINIQUAD_INIT_DONE) return;
+  
+  // Telemetry once the DMP is running
+  if (copter.TryRefreshDmpData())
+  {
+    Quaternion& quat = copter.GetQuaternion();
+    Serial.print(quat.w); Serial.print("\t");
+    Serial.print(quat.x); Serial.print("\t");
+    Serial.print(quat.y); Serial.print("\t");
+    Serial.print(quat.z); Serial.print("\n");
+  }
+}
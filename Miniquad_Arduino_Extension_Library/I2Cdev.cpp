@@ -3,6 +3,15 @@
 // 6/9/2012 by Jeff Rowberg <jeff@rowberg.net>
 //
 // Changelog:
+//     2026-10-16 - add I2CDEV_HOST_SIMULATION implementation (device models on a Linux host)
+//                - add optional transaction tracer and per-register traffic counters (I2CDEV_TRACE)
+//                - add setClock()/getClock() for every implementation, and probeClock()
+//                - add asynchronous transaction queue with completion callbacks (submit/poll/wait)
+//                - NBWire: queued transactions chained in the TWI ISR with repeated start reads
+//                - NBWire: readBytes()/readWords() implemented, blocking calls hold the bus throughout
+//                - add readStream() for the registers that do not advance (FIFO), the address sent once
+//     2026-10-17 - readBit*()/readBits*() no longer use an unset value when the read fails
+//                - host simulation: readBytes()/readWords() read in Wire sized chunks
 //     2013-05-05 - fix issue with writing bit values to words (Sasquatch/Farzanegan)
 //     2012-06-09 - fix major issue with reading > 32 bytes at a time with Arduino Wire
 //                - add compiler warnings when using outdated or IDE or limited I2Cdev implementation
@@ -45,6 +54,9 @@ THE SOFTWARE.
 
 #include "I2Cdev.h"
 
+// the library runs without a heap (see "make heapcheck" of the host tools)
+#pragma GCC poison malloc calloc realloc free
+
 #if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
 
     #ifdef I2CDEV_IMPLEMENTATION_WARNINGS
@@ -79,7 +91,7 @@ THE SOFTWARE.
     #ifdef I2CDEV_IMPLEMENTATION_WARNINGS
         #warning Using I2CDEV_BUILTIN_NBWIRE implementation may adversely affect interrupt detection.
         #warning This I2Cdev implementation does not support:
-        #warning - Repeated starts conditions
+        #warning - Repeated starts conditions (except in queued I2Cdev transactions)
     #endif
 
     // NBWire implementation based heavily on code by Gene Knight <Gene@Telobot.com>
@@ -87,10 +99,18 @@ THE SOFTWARE.
     // Originally offered to the i2cdevlib project at http://arduino.cc/forum/index.php/topic,68210.30.html
     TwoWire Wire;
 
+    static void twi_holdBus();
+    static void twi_releaseHold();
+
 #elif I2CDEV_IMPLEMENTATION == I2CDEV_I2CMASTER_LIBRARY
 
     #warning Dunno, just don't want it to feel left out ^_^'
 
+#elif I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION
+
+    // device models by 7-bit address, the empty addresses nack
+    static I2Cdev_HostDevice *i2cdev_hostDevices[128];
+
 #endif
 
 /** Default constructor.
@@ -98,6 +118,73 @@ THE SOFTWARE.
 I2Cdev::I2Cdev() {
 }
 
+#ifdef I2CDEV_TRACE
+    /* Trace ring and per-register counters. The NBWire TWI interrupt records
+     * the queued transactions, so that implementation updates and copies them
+     * with interrupts off.
+     */
+    static I2Cdev_TraceEntry i2cdev_traceRing[I2CDEV_TRACE_LENGTH];
+    static uint8_t i2cdev_traceNext = 0;
+    static uint32_t i2cdev_traceTotal = 0;
+    static I2Cdev_RegisterStats i2cdev_traceStats[I2CDEV_TRACE_REGISTERS];
+    static uint8_t i2cdev_traceStatsCount = 0;
+
+    /** Record a transaction in the trace ring and in the counters of its
+     * (device, register) pair. Pairs beyond I2CDEV_TRACE_REGISTERS are only
+     * counted in the total.
+     * @param devAddr I2C slave device address
+     * @param regAddr First register address
+     * @param direction I2CDEV_READ or I2CDEV_WRITE
+     * @param length Number of data bytes requested
+     * @param count Number of data bytes transferred
+     * @param error Error code (0 = success)
+     * @param start micros() at the start of the transaction
+     */
+    static void i2cdev_trace(uint8_t devAddr, uint8_t regAddr, uint8_t direction, uint8_t length, uint8_t count, uint8_t error, uint32_t start) {
+        uint32_t elapsed = micros() - start;
+        uint16_t duration = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+        I2Cdev_RegisterStats *stats = 0;
+
+        #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+            uint8_t sreg = SREG;
+            cli();
+        #endif
+        I2Cdev_TraceEntry *entry = &i2cdev_traceRing[i2cdev_traceNext];
+        entry -> start = start;
+        entry -> duration = duration;
+        entry -> devAddr = devAddr;
+        entry -> regAddr = regAddr;
+        entry -> direction = direction;
+        entry -> length = length;
+        entry -> count = count;
+        entry -> error = error;
+        i2cdev_traceNext = (i2cdev_traceNext + 1) % I2CDEV_TRACE_LENGTH;
+        i2cdev_traceTotal++;
+
+        for (uint8_t i = 0; i < i2cdev_traceStatsCount && stats == 0; i++) {
+            if (i2cdev_traceStats[i].devAddr == devAddr && i2cdev_traceStats[i].regAddr == regAddr) stats = &i2cdev_traceStats[i];
+        }
+        if (stats == 0 && i2cdev_traceStatsCount < I2CDEV_TRACE_REGISTERS) {
+            stats = &i2cdev_traceStats[i2cdev_traceStatsCount++];
+            stats -> devAddr = devAddr;
+            stats -> regAddr = regAddr;
+            stats -> errors = stats -> maxTime = 0;
+            stats -> reads = stats -> writes = stats -> bytes = stats -> time = 0;
+        }
+        if (stats != 0) {
+            if (direction == I2CDEV_READ) stats -> reads++;
+            else stats -> writes++;
+            if (error != 0) stats -> errors++;
+            stats -> bytes += count;
+            stats -> time += elapsed;
+            if (duration > stats -> maxTime) stats -> maxTime = duration;
+        }
+        #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+            SREG = sreg;
+        #endif
+    }
+#endif
+
 /** Read a single bit from an 8-bit device register.
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to read from
@@ -107,7 +194,7 @@ I2Cdev::I2Cdev() {
  * @return Status of read operation (true = success)
  */
 int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout) {
-    uint8_t b;
+    uint8_t b = 0;
     uint8_t count = readByte(devAddr, regAddr, &b, timeout);
     *data = b & (1 << bitNum);
     return count;
@@ -122,7 +209,7 @@ int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t
  * @return Status of read operation (true = success)
  */
 int8_t I2Cdev::readBitW(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint16_t *data, uint16_t timeout) {
-    uint16_t b;
+    uint16_t b = 0;
     uint8_t count = readWord(devAddr, regAddr, &b, timeout);
     *data = b & (1 << bitNum);
     return count;
@@ -143,7 +230,7 @@ int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint
     //    xxx   args: bitStart=4, length=3
     //    010   masked
     //   -> 010 shifted
-    uint8_t count, b;
+    uint8_t count, b = 0;
     if ((count = readByte(devAddr, regAddr, &b, timeout)) != 0) {
         uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         b &= mask;
@@ -169,7 +256,7 @@ int8_t I2Cdev::readBitsW(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uin
     //    010           masked
     //           -> 010 shifted
     uint8_t count;
-    uint16_t w;
+    uint16_t w = 0;
     if ((count = readWord(devAddr, regAddr, &w, timeout)) != 0) {
         uint16_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         w &= mask;
@@ -222,6 +309,9 @@ int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8
 
     int8_t count = 0;
     uint32_t t1 = millis();
+    #ifdef I2CDEV_TRACE
+        uint32_t traceStart = micros();
+    #endif
 
     #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
 
@@ -298,6 +388,28 @@ int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8
             }
         #endif
 
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
+        // NBWire, Wire library API of Arduino v00xx
+
+        // the bus stays held from the register address to the last chunk, so
+        // that no queued transaction moves the register pointer in between
+        twi_holdBus();
+        for (uint8_t k = 0; k < length; k += min(length, NBWIRE_BUFFER_LENGTH)) {
+            Wire.beginTransmission(devAddr);
+            Wire.send(regAddr);
+            Wire.endTransmission(timeout);
+            Wire.requestFrom(devAddr, (uint8_t)min(length - k, NBWIRE_BUFFER_LENGTH), timeout);
+
+            for (; Wire.available() && (timeout == 0 || millis() - t1 < timeout); count++) {
+                data[count] = Wire.receive();
+                #ifdef I2CDEV_SERIAL_DEBUG
+                    Serial.print(data[count], HEX);
+                    if (count + 1 < length) Serial.print(" ");
+                #endif
+            }
+        }
+        twi_releaseHold();
+
     #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE)
         // Fastwire library (STILL UNDER DEVELOPMENT, NON-FUNCTIONAL!)
 
@@ -318,6 +430,17 @@ int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8
           count = -1 * status;
         }
 
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+
+        // chunks like the Wire library, the register address sent again for each one
+        I2Cdev_HostDevice *device = i2cdev_hostDevices[devAddr & 0x7F];
+        for (uint8_t k = 0; device != 0 && k < length; k += I2CDEV_READ_CHUNK_LENGTH) {
+            uint8_t chunk = (length - k < I2CDEV_READ_CHUNK_LENGTH) ? length - k : I2CDEV_READ_CHUNK_LENGTH;
+            uint8_t received = device -> read(regAddr, chunk, data + k);
+            count += received;
+            if (received < chunk) break;
+        }
+
     #endif
 
     // check for timeout
@@ -329,6 +452,11 @@ int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8
         Serial.println(" read).");
     #endif
 
+    #ifdef I2CDEV_TRACE
+        i2cdev_trace(devAddr, regAddr, I2CDEV_READ, length, count < 0 ? 0 : count,
+            count == length ? 0 : (count < 0 ? 5 : 4), traceStart);
+    #endif
+
     return count;
 }
 
@@ -353,6 +481,9 @@ int8_t I2Cdev::readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint1
 
     int8_t count = 0;
     uint32_t t1 = millis();
+    #ifdef I2CDEV_TRACE
+        uint32_t traceStart = micros();
+    #endif
 
     #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
 
@@ -456,6 +587,36 @@ int8_t I2Cdev::readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint1
             }
         #endif
 
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
+        // NBWire, Wire library API of Arduino v00xx
+
+        // the bus stays held from the register address to the last chunk (see readBytes())
+        twi_holdBus();
+        for (uint8_t k = 0; k < length * 2; k += min(length * 2, NBWIRE_BUFFER_LENGTH)) {
+            Wire.beginTransmission(devAddr);
+            Wire.send(regAddr);
+            Wire.endTransmission(timeout);
+            Wire.requestFrom(devAddr, (uint8_t)min(length * 2 - k, NBWIRE_BUFFER_LENGTH), timeout); // length=words, this wants bytes
+
+            bool msb = true; // starts with MSB, then LSB
+            for (; Wire.available() && count < length && (timeout == 0 || millis() - t1 < timeout);) {
+                if (msb) {
+                    // first byte is bits 15-8 (MSb=15)
+                    data[count] = Wire.receive() << 8;
+                } else {
+                    // second byte is bits 7-0 (LSb=0)
+                    data[count] |= Wire.receive();
+                    #ifdef I2CDEV_SERIAL_DEBUG
+                        Serial.print(data[count], HEX);
+                        if (count + 1 < length) Serial.print(" ");
+                    #endif
+                    count++;
+                }
+                msb = !msb;
+            }
+        }
+        twi_releaseHold();
+
     #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE)
         // Fastwire library (STILL UNDER DEVELOPMENT, NON-FUNCTIONAL!)
 
@@ -483,6 +644,23 @@ int8_t I2Cdev::readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint1
         } else {
            count = -1 * status;
         }
+
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+
+        // words arrive MSB first in Wire sized chunks (see readBytes()), each one swapped in place
+        I2Cdev_HostDevice *device = i2cdev_hostDevices[devAddr & 0x7F];
+        uint8_t *bytes = (uint8_t *)data;
+        uint16_t received = 0;
+        for (uint16_t k = 0; device != 0 && k < length * 2; k += I2CDEV_READ_CHUNK_LENGTH) {
+            uint8_t chunk = (length * 2 - k < I2CDEV_READ_CHUNK_LENGTH) ? length * 2 - k : I2CDEV_READ_CHUNK_LENGTH;
+            uint8_t part = device -> read(regAddr, chunk, bytes + k);
+            received += part;
+            if (part < chunk) break;
+        }
+        count = received / 2;
+        for (uint8_t i = 0; i < count; i++) {
+            data[i] = (bytes[2*i] << 8) | bytes[2*i + 1];
+        }
     #endif
 
     if (timeout > 0 && millis() - t1 >= timeout && count < length) count = -1; // timeout
@@ -492,10 +670,100 @@ int8_t I2Cdev::readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint1
         Serial.print(count, DEC);
         Serial.println(" read).");
     #endif
+
+    #ifdef I2CDEV_TRACE
+        i2cdev_trace(devAddr, regAddr, I2CDEV_READ, length * 2, count < 0 ? 0 : count * 2,
+            count == length ? 0 : (count < 0 ? 5 : 4), traceStart);
+    #endif
     
     return count;
 }
 
+/** Read a stream of bytes from a register that does not advance, e.g. a FIFO
+ * data register. The register address is sent once, then the bytes are read
+ * back to back in chunks of I2CDEV_READ_CHUNK_LENGTH (the Wire receive buffer),
+ * so a long read costs one address write instead of one per chunk. Other
+ * transactions between the chunks would move the register address, so NBWire
+ * holds the bus throughout. The implementations without a separate address
+ * write (Fastwire, I2C-Master) read the chunks through readBytes().
+ * @param devAddr I2C slave device address
+ * @param regAddr Register regAddr to read from (must not auto-increment)
+ * @param length Number of bytes to read
+ * @param data Buffer to store read data in
+ * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
+ * @return Number of bytes read (-1 indicates failure)
+ */
+int16_t I2Cdev::readStream(uint8_t devAddr, uint8_t regAddr, uint16_t length, uint8_t *data, uint16_t timeout) {
+    int16_t count = 0;
+    uint32_t t1 = millis();
+
+    // send the register address once
+    #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
+        Wire.beginTransmission(devAddr);
+        #if (ARDUINO < 100)
+            Wire.send(regAddr);
+        #else
+            Wire.write(regAddr);
+        #endif
+        if (Wire.endTransmission() != 0) count = -1;
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
+        twi_holdBus();
+        Wire.beginTransmission(devAddr);
+        Wire.send(regAddr);
+        if (Wire.endTransmission(timeout) != 0) count = -1;
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+        I2Cdev_HostDevice *device = i2cdev_hostDevices[devAddr & 0x7F];
+        if (device == 0 || device -> write(regAddr, 0, 0) != 0) count = -1;
+    #endif
+
+    // read the chunks back to back
+    for (uint16_t k = 0; count >= 0 && k < length;) {
+        uint8_t chunk = (length - k < I2CDEV_READ_CHUNK_LENGTH) ? length - k : I2CDEV_READ_CHUNK_LENGTH;
+        uint8_t received = 0;
+        #ifdef I2CDEV_TRACE
+            uint32_t traceStart = micros();
+        #endif
+
+        #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE)
+            Wire.requestFrom(devAddr, chunk);
+            for (; received < chunk && Wire.available() && (timeout == 0 || millis() - t1 < timeout); received++) {
+                #if (ARDUINO < 100)
+                    data[k + received] = Wire.receive();
+                #else
+                    data[k + received] = Wire.read();
+                #endif
+            }
+        #elif (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
+            Wire.requestFrom(devAddr, chunk, timeout);
+            for (; received < chunk && Wire.available() && (timeout == 0 || millis() - t1 < timeout); received++) {
+                data[k + received] = Wire.receive();
+            }
+        #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+            received = device -> readCurrent(chunk, data + k);
+        #else
+            int8_t read = readBytes(devAddr, regAddr, chunk, data + k, timeout);
+            if (read > 0) received = read;
+        #endif
+
+        #if defined(I2CDEV_TRACE) && (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE || I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE || I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+            i2cdev_trace(devAddr, regAddr, I2CDEV_READ, chunk, received, received == chunk ? 0 : 4, traceStart);
+        #endif
+
+        count += received;
+        k += chunk;
+        if (received < chunk) break; // short read
+    }
+
+    #if (I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
+        twi_releaseHold();
+    #endif
+
+    // check for timeout
+    if (timeout > 0 && millis() - t1 >= timeout && count < (int16_t)length) count = -1; // timeout
+
+    return count;
+}
+
 /** write a single bit in an 8-bit device register.
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to write to
@@ -620,6 +888,12 @@ bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_
         Serial.print("...");
     #endif
     uint8_t status = 0;
+    #ifdef I2CDEV_TRACE
+        uint32_t traceStart = micros();
+    #endif
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        twi_holdBus();
+    #endif
     #if ((I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE && ARDUINO < 100) || I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
         Wire.beginTransmission(devAddr);
         Wire.send((uint8_t) regAddr); // send address
@@ -647,10 +921,19 @@ bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_
         Wire.endTransmission();
     #elif (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE && ARDUINO >= 100)
         status = Wire.endTransmission();
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+        I2Cdev_HostDevice *device = i2cdev_hostDevices[devAddr & 0x7F];
+        status = (device != 0) ? device -> write(regAddr, length, data) : 2;
+    #endif
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        twi_releaseHold();
     #endif
     #ifdef I2CDEV_SERIAL_DEBUG
         Serial.println(". Done.");
     #endif
+    #ifdef I2CDEV_TRACE
+        i2cdev_trace(devAddr, regAddr, I2CDEV_WRITE, length, status == 0 ? length : 0, status, traceStart);
+    #endif
     return status == 0;
 }
 
@@ -672,6 +955,12 @@ bool I2Cdev::writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16
         Serial.print("...");
     #endif
     uint8_t status = 0;
+    #ifdef I2CDEV_TRACE
+        uint32_t traceStart = micros();
+    #endif
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        twi_holdBus();
+    #endif
     #if ((I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE && ARDUINO < 100) || I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE)
         Wire.beginTransmission(devAddr);
         Wire.send(regAddr); // send address
@@ -702,10 +991,25 @@ bool I2Cdev::writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16
         Wire.endTransmission();
     #elif (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE && ARDUINO >= 100)
         status = Wire.endTransmission();
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+        // words go out MSB first, the buffer holds the longest write (no variable length array)
+        I2Cdev_HostDevice *device = i2cdev_hostDevices[devAddr & 0x7F];
+        uint8_t bytes[2 * 255];
+        for (uint8_t i = 0; i < length; i++) {
+            bytes[2*i] = (uint8_t)(data[i] >> 8);
+            bytes[2*i + 1] = (uint8_t)data[i];
+        }
+        status = (device != 0) ? device -> write(regAddr, length * 2, bytes) : 2;
+    #endif
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        twi_releaseHold();
     #endif
     #ifdef I2CDEV_SERIAL_DEBUG
         Serial.println(". Done.");
     #endif
+    #ifdef I2CDEV_TRACE
+        i2cdev_trace(devAddr, regAddr, I2CDEV_WRITE, length * 2, status == 0 ? length * 2 : 0, status, traceStart);
+    #endif
     return status == 0;
 }
 
@@ -714,6 +1018,433 @@ bool I2Cdev::writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16
  */
 uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
 
+/* Bus rate set by setClock(), where it cannot be read back from the TWI bit
+ * rate register (non-AVR platforms).
+ */
+static uint32_t i2cdev_clock = I2CDEV_CLOCK_STANDARD;
+
+/** Set the I2C bus rate.
+ * Call after Wire.begin() (or the equivalent), which resets the rate. The
+ * Arduino Wire library of Arduino 1.5.7+ sets it with Wire.setClock(), the
+ * I2C-Master library only knows 100 and 400 kHz, and the other AVR
+ * implementations (older Wire, NBWire, Fastwire) get the TWI bit rate register
+ * rounded down to the highest rate not above the requested one.
+ * @param clock Bus rate in Hz (I2CDEV_CLOCK_STANDARD, I2CDEV_CLOCK_FAST or I2CDEV_CLOCK_FAST_PLUS)
+ * @return True if the bus runs at this rate (see getClock() otherwise)
+ */
+bool I2Cdev::setClock(uint32_t clock) {
+    if (clock == 0) return false;
+
+    #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE && ARDUINO >= 157)
+        Wire.setClock(clock);
+        i2cdev_clock = clock;
+        return getClock() == clock;
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_I2CMASTER_LIBRARY)
+        I2c.setSpeed(clock >= I2CDEV_CLOCK_FAST);
+        i2cdev_clock = (clock >= I2CDEV_CLOCK_FAST) ? I2CDEV_CLOCK_FAST : I2CDEV_CLOCK_STANDARD;
+        return i2cdev_clock == clock;
+    #elif (I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+        i2cdev_clock = clock; // the device models time their transactions at this rate
+        return true;
+    #elif defined(TWBR)
+        // SCL = F_CPU / (16 + 2 * TWBR) with prescaler 1, divider rounded up
+        uint32_t divider = (F_CPU + clock - 1) / clock;
+        uint32_t twbr = (divider > 16) ? (divider - 16 + 1) / 2 : 0;
+        if (twbr > 255) return false; // slower than the divider allows
+        TWSR &= ~(_BV(TWPS0) | _BV(TWPS1));
+        TWBR = twbr;
+        return getClock() == clock;
+    #else
+        i2cdev_clock = clock;
+        return false; // no rate control on this platform
+    #endif
+}
+
+/** Get the I2C bus rate.
+ * @return Bus rate in Hz (read back from the TWI bit rate register on AVR)
+ */
+uint32_t I2Cdev::getClock() {
+    #ifdef TWBR
+        uint8_t prescaler = 1 << (2 * (TWSR & (_BV(TWPS0) | _BV(TWPS1))));
+        return F_CPU / (16 + 2UL * TWBR * prescaler);
+    #else
+        return i2cdev_clock;
+    #endif
+}
+
+/** Find the fastest bus rate a device answers reliably at.
+ * Starting at the given rate, the register is read I2CDEV_PROBE_READS times;
+ * more than I2CDEV_PROBE_MAX_ERRORS failed reads (nack, timeout or a value
+ * differing from the first one) step the rate down to the next standard rate
+ * (1000, 400 then 100 kHz). Use a register holding a constant value, such as
+ * WHO_AM_I.
+ * @param devAddr I2C slave device address
+ * @param regAddr Register regAddr to read from
+ * @param clock Rate to start at in Hz
+ * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
+ * @return Rate the bus is left at, 0 if the device failed at 100 kHz too
+ */
+uint32_t I2Cdev::probeClock(uint8_t devAddr, uint8_t regAddr, uint32_t clock, uint16_t timeout) {
+    while (clock > 0) {
+        uint8_t errors = 0, first = 0, value;
+        bool haveFirst = false;
+        setClock(clock); // a rate beyond the divider runs the nearest one below
+        for (uint8_t i = 0; i < I2CDEV_PROBE_READS && errors <= I2CDEV_PROBE_MAX_ERRORS; i++) {
+            if (readByte(devAddr, regAddr, &value, timeout) != 1) {
+                errors++;
+            } else if (!haveFirst) {
+                first = value;
+                haveFirst = true;
+            } else if (value != first) {
+                errors++;
+            }
+        }
+        if (errors <= I2CDEV_PROBE_MAX_ERRORS) return getClock();
+
+        // next standard rate down
+        if (clock > I2CDEV_CLOCK_FAST) clock = I2CDEV_CLOCK_FAST;
+        else if (clock > I2CDEV_CLOCK_STANDARD) clock = I2CDEV_CLOCK_STANDARD;
+        else clock = 0;
+    }
+    return 0;
+}
+
+/* Queue of the asynchronous transactions: a ring of descriptor pointers, the
+ * head being the active (or next) transaction. Only the NBWire TWI interrupt
+ * touches it from interrupt context, so the other implementations need no
+ * atomic sections.
+ */
+static I2Cdev_Transaction *i2cdev_queue[I2CDEV_QUEUE_LENGTH];
+static volatile uint8_t i2cdev_queueHead = 0;
+static volatile uint8_t i2cdev_queueCount = 0;
+
+#if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+    static void twi_queueStart();
+#endif
+
+/** Remove the head transaction from the queue and publish its result.
+ * The callback is left to the caller, so that the next transaction can be
+ * started first.
+ * @param count Number of data bytes transferred
+ * @param error Error code (0 = success)
+ * @return The completed transaction
+ */
+static I2Cdev_Transaction *i2cdev_complete(uint8_t count, uint8_t error) {
+    I2Cdev_Transaction *transaction = i2cdev_queue[i2cdev_queueHead];
+    i2cdev_queueHead = (i2cdev_queueHead + 1) % I2CDEV_QUEUE_LENGTH;
+    i2cdev_queueCount--;
+    transaction -> count = count;
+    transaction -> error = error;
+    transaction -> status = (error == 0) ? I2CDEV_STATUS_DONE : I2CDEV_STATUS_FAILED;
+    return transaction;
+}
+
+/** Queue an asynchronous transaction.
+ * With NBWire the transactions run from the TWI interrupt, back to back and in
+ * submission order, while the caller goes on. The other implementations have
+ * no interrupt-driven master, so the queued transactions run (blocking) in
+ * poll() or wait(), and writes are limited to I2CDEV_MAX_WRITE_LENGTH bytes.
+ * Every implementation takes at most I2CDEV_MAX_QUEUED_LENGTH bytes.
+ * @param transaction Filled descriptor (devAddr, regAddr, direction, length, data, callback, context)
+ * @return Status of submission (false = queue full, descriptor already queued, empty read or too long)
+ */
+bool I2Cdev::submit(I2Cdev_Transaction *transaction) {
+    bool queued = false;
+    if (transaction -> direction == I2CDEV_READ && transaction -> length == 0) return false;
+    if (transaction -> length > I2CDEV_MAX_QUEUED_LENGTH) return false;
+
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        uint8_t sreg = SREG;
+        cli();
+    #endif
+    if (i2cdev_queueCount < I2CDEV_QUEUE_LENGTH
+            && transaction -> status != I2CDEV_STATUS_QUEUED && transaction -> status != I2CDEV_STATUS_ACTIVE) {
+        transaction -> status = I2CDEV_STATUS_QUEUED;
+        transaction -> count = 0;
+        transaction -> error = 0;
+        i2cdev_queue[(i2cdev_queueHead + i2cdev_queueCount) % I2CDEV_QUEUE_LENGTH] = transaction;
+        i2cdev_queueCount++;
+        queued = true;
+    }
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        SREG = sreg;
+        if (queued) twi_queueStart();
+    #endif
+    return queued;
+}
+
+/** Queue an asynchronous read of multiple bytes from an 8-bit device register.
+ * @param devAddr I2C slave device address
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read (1 to I2CDEV_MAX_QUEUED_LENGTH)
+ * @param data Buffer to store read data in (must stay valid until completion)
+ * @param transaction Descriptor to fill and queue (must stay valid until completion)
+ * @param callback Optional completion callback
+ * @param context Optional pointer stored in the descriptor for the callback
+ * @return Status of submission (true = queued)
+ */
+bool I2Cdev::readBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, I2Cdev_Transaction *transaction, I2Cdev_Callback callback, void *context) {
+    transaction -> devAddr = devAddr;
+    transaction -> regAddr = regAddr;
+    transaction -> direction = I2CDEV_READ;
+    transaction -> length = length;
+    transaction -> data = data;
+    transaction -> callback = callback;
+    transaction -> context = context;
+    return submit(transaction);
+}
+
+/** Queue an asynchronous write of multiple bytes to an 8-bit device register.
+ * @param devAddr I2C slave device address
+ * @param regAddr First register address to write to
+ * @param length Number of bytes to write (I2CDEV_MAX_QUEUED_LENGTH at most)
+ * @param data Buffer to copy new data from (must stay valid until completion)
+ * @param transaction Descriptor to fill and queue (must stay valid until completion)
+ * @param callback Optional completion callback
+ * @param context Optional pointer stored in the descriptor for the callback
+ * @return Status of submission (true = queued)
+ */
+bool I2Cdev::writeBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, I2Cdev_Transaction *transaction, I2Cdev_Callback callback, void *context) {
+    transaction -> devAddr = devAddr;
+    transaction -> regAddr = regAddr;
+    transaction -> direction = I2CDEV_WRITE;
+    transaction -> length = length;
+    transaction -> data = data;
+    transaction -> callback = callback;
+    transaction -> context = context;
+    return submit(transaction);
+}
+
+/** Check whether a transaction is out of the queue (completed or never submitted).
+ * @param transaction Descriptor to check
+ * @return True when the descriptor and its buffer belong to the caller again
+ */
+bool I2Cdev::isDone(const I2Cdev_Transaction *transaction) {
+    uint8_t status = transaction -> status;
+    return status != I2CDEV_STATUS_QUEUED && status != I2CDEV_STATUS_ACTIVE;
+}
+
+/** Wait for the completion of a transaction, running the queue if needed.
+ * Do not call from a completion callback. On timeout the transaction stays
+ * queued and still owns its buffer.
+ * @param transaction Submitted descriptor
+ * @param timeout Optional timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
+ * @return Status of the transaction (true = completed without error)
+ */
+bool I2Cdev::wait(I2Cdev_Transaction *transaction, uint16_t timeout) {
+    uint32_t t1 = millis();
+    while (!isDone(transaction)) {
+        if (timeout > 0 && millis() - t1 >= timeout) return false;
+        poll();
+    }
+    return transaction -> status == I2CDEV_STATUS_DONE;
+}
+
+/** Run the queued transactions.
+ * With NBWire this only restarts the queue if the bus was held by a blocking
+ * transfer; the other implementations run every queued transaction here, in
+ * order, and call the callbacks (which may submit more).
+ */
+void I2Cdev::poll() {
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        twi_queueStart();
+    #else
+        static bool polling = false;
+        if (polling) return; // called from a callback, the loop below goes on
+        polling = true;
+        while (i2cdev_queueCount > 0) {
+            I2Cdev_Transaction *transaction = i2cdev_queue[i2cdev_queueHead];
+            uint8_t count, error;
+            transaction -> status = I2CDEV_STATUS_ACTIVE;
+            if (transaction -> direction == I2CDEV_READ) {
+                // length <= I2CDEV_MAX_QUEUED_LENGTH, so the count is never negative
+                // but on errors (-1); short reads and errors both fail
+                int8_t read = readBytes(transaction -> devAddr, transaction -> regAddr, transaction -> length, transaction -> data);
+                count = (read < 0) ? 0 : read;
+                error = (read == transaction -> length) ? 0 : 5;
+            } else {
+                error = writeBytes(transaction -> devAddr, transaction -> regAddr, transaction -> length, transaction -> data) ? 0 : 4;
+                count = error ? 0 : transaction -> length;
+            }
+            transaction = i2cdev_complete(count, error);
+            if (transaction -> callback) transaction -> callback(transaction);
+        }
+        polling = false;
+    #endif
+}
+
+/** Get the number of queued transactions, the active one included.
+ * @return Number of transactions in the queue
+ */
+uint8_t I2Cdev::getQueued() {
+    return i2cdev_queueCount;
+}
+
+#if I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION
+/** Attach a device model to the simulated bus, replacing the one at its address.
+ * @param devAddr I2C slave device address (7-bit)
+ * @param device Device model (must stay valid until detached)
+ */
+void I2Cdev::attachHostDevice(uint8_t devAddr, I2Cdev_HostDevice *device) {
+    i2cdev_hostDevices[devAddr & 0x7F] = device;
+}
+
+/** Detach the device model at an address, which then nacks.
+ * @param devAddr I2C slave device address (7-bit)
+ */
+void I2Cdev::detachHostDevice(uint8_t devAddr) {
+    i2cdev_hostDevices[devAddr & 0x7F] = 0;
+}
+#endif
+
+#ifdef I2CDEV_TRACE
+/** Get the number of transactions traced since the last reset.
+ * @return Number of traced transactions (older ones have left the ring)
+ */
+uint32_t I2Cdev::getTraceTotal() {
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        uint8_t sreg = SREG;
+        cli();
+    #endif
+    uint32_t total = i2cdev_traceTotal;
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        SREG = sreg;
+    #endif
+    return total;
+}
+
+/** Get the number of transactions in the trace ring.
+ * @return Number of entries (up to I2CDEV_TRACE_LENGTH)
+ */
+uint8_t I2Cdev::getTraceLength() {
+    uint32_t total = getTraceTotal();
+    return (total < I2CDEV_TRACE_LENGTH) ? total : I2CDEV_TRACE_LENGTH;
+}
+
+/** Copy an entry of the trace ring.
+ * @param index Entry index (0 = oldest, getTraceLength() - 1 = latest)
+ * @param entry Container for the entry
+ * @return Status of operation (false if the index is out of the ring)
+ */
+bool I2Cdev::getTraceEntry(uint8_t index, I2Cdev_TraceEntry *entry) {
+    bool found = false;
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        uint8_t sreg = SREG;
+        cli();
+    #endif
+    uint8_t length = (i2cdev_traceTotal < I2CDEV_TRACE_LENGTH) ? i2cdev_traceTotal : I2CDEV_TRACE_LENGTH;
+    if (index < length) {
+        *entry = i2cdev_traceRing[(i2cdev_traceNext + I2CDEV_TRACE_LENGTH - length + index) % I2CDEV_TRACE_LENGTH];
+        found = true;
+    }
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        SREG = sreg;
+    #endif
+    return found;
+}
+
+/** Get the number of (device, register) pairs with counters.
+ * @return Number of pairs (up to I2CDEV_TRACE_REGISTERS)
+ */
+uint8_t I2Cdev::getRegisterStatsCount() {
+    return i2cdev_traceStatsCount;
+}
+
+/** Copy the counters of a (device, register) pair, in order of first use.
+ * @param index Pair index (0 to getRegisterStatsCount() - 1)
+ * @param stats Container for the counters
+ * @return Status of operation (false if the index is out of range)
+ */
+bool I2Cdev::getRegisterStats(uint8_t index, I2Cdev_RegisterStats *stats) {
+    bool found = false;
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        uint8_t sreg = SREG;
+        cli();
+    #endif
+    if (index < i2cdev_traceStatsCount) {
+        *stats = i2cdev_traceStats[index];
+        found = true;
+    }
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        SREG = sreg;
+    #endif
+    return found;
+}
+
+/** Clear the trace ring and the register counters.
+ */
+void I2Cdev::resetTrace() {
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        uint8_t sreg = SREG;
+        cli();
+    #endif
+    i2cdev_traceNext = 0;
+    i2cdev_traceTotal = 0;
+    i2cdev_traceStatsCount = 0;
+    #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+        SREG = sreg;
+    #endif
+}
+
+/** Print the trace ring to Serial, oldest first, one transaction per line:
+ * start (us), device, register, R/W, length, count, duration (us), error.
+ */
+void I2Cdev::printTrace() {
+    I2Cdev_TraceEntry entry;
+    Serial.print("I2C trace (");
+    Serial.print(getTraceTotal(), DEC);
+    Serial.println(" transactions):");
+    for (uint8_t i = 0; getTraceEntry(i, &entry); i++) {
+        Serial.print(entry.start, DEC);
+        Serial.print("\t0x");
+        Serial.print(entry.devAddr, HEX);
+        Serial.print("\t0x");
+        Serial.print(entry.regAddr, HEX);
+        Serial.print(entry.direction == I2CDEV_READ ? "\tR\t" : "\tW\t");
+        Serial.print(entry.length, DEC);
+        Serial.print("\t");
+        Serial.print(entry.count, DEC);
+        Serial.print("\t");
+        Serial.print(entry.duration, DEC);
+        Serial.print("\t");
+        Serial.println(entry.error, DEC);
+    }
+}
+
+/** Print the register counters to Serial, one pair per line: device,
+ * register, reads, writes, bytes, errors, total time (us), longest (us).
+ */
+void I2Cdev::printRegisterStats() {
+    I2Cdev_RegisterStats stats;
+    uint32_t counted = 0;
+    Serial.println("I2C registers (dev reg reads writes bytes errors time_us max_us):");
+    for (uint8_t i = 0; getRegisterStats(i, &stats); i++) {
+        counted += stats.reads + stats.writes;
+        Serial.print("0x");
+        Serial.print(stats.devAddr, HEX);
+        Serial.print("\t0x");
+        Serial.print(stats.regAddr, HEX);
+        Serial.print("\t");
+        Serial.print(stats.reads, DEC);
+        Serial.print("\t");
+        Serial.print(stats.writes, DEC);
+        Serial.print("\t");
+        Serial.print(stats.bytes, DEC);
+        Serial.print("\t");
+        Serial.print(stats.errors, DEC);
+        Serial.print("\t");
+        Serial.print(stats.time, DEC);
+        Serial.print("\t");
+        Serial.println(stats.maxTime, DEC);
+    }
+    uint32_t total = getTraceTotal();
+    if (total > counted) {
+        Serial.print("others\t");
+        Serial.println(total - counted, DEC);
+    }
+}
+#endif
+
 #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE
     /*
     FastWire 0.2
@@ -942,17 +1673,69 @@ uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
         uint8_t i;
     } twi_Write_Vars;
 
+    // one blocking transfer at a time, so a single static descriptor does
+    static twi_Write_Vars twi_vars;
     twi_Write_Vars *ptwv = 0;
     static void (*fNextInterruptFunction)(void) = 0;
     
+    // transaction of the I2Cdev queue on the bus (0 when the queue is idle)
+    static I2Cdev_Transaction * volatile twi_queueActive = 0;
+    static volatile uint8_t twi_queueIndex;
+    #ifdef I2CDEV_TRACE
+        static uint32_t twi_queueStartTime;
+    #endif
+
+    // number of nested holds of the bus by the blocking I2Cdev calls (the
+    // queue does not start while it is set)
+    static volatile uint8_t twi_busHolds = 0;
+
     void twi_Finish(byte bRetVal) {
-        if (ptwv) {
-            free(ptwv);
-            ptwv = 0;
-        }
+        ptwv = 0;
         twi_Done = 0xFF;
         twi_Return_Value = bRetVal;
         fNextInterruptFunction = 0;
+        twi_queueStart(); // transactions submitted during a bare Wire transfer
+    }
+    
+    // let the queued transactions drain, then take the bus for a blocking
+    // transfer (the queue does not start while fNextInterruptFunction is set);
+    // under a hold the queue is already stopped
+    static void twi_claimBus(void (*function)(void)) {
+        for (;;) {
+            uint8_t sreg = SREG;
+            cli();
+            if (i2cdev_queueCount == 0 || twi_busHolds > 0) {
+                fNextInterruptFunction = function;
+                SREG = sreg;
+                return;
+            }
+            SREG = sreg;
+        }
+    }
+
+    // let the queued transactions drain, then keep them off the bus until
+    // twi_releaseHold(), over all the transfers of a blocking I2Cdev call
+    // (a register address write and its reads must not be split)
+    static void twi_holdBus() {
+        for (;;) {
+            uint8_t sreg = SREG;
+            cli();
+            if (i2cdev_queueCount == 0 || twi_busHolds > 0) {
+                twi_busHolds++;
+                SREG = sreg;
+                return;
+            }
+            SREG = sreg;
+        }
+    }
+
+    // end a hold of twi_holdBus(), and start the transactions queued meanwhile
+    static void twi_releaseHold() {
+        uint8_t sreg = SREG;
+        cli();
+        twi_busHolds--;
+        SREG = sreg;
+        twi_queueStart();
     }
     
     uint8_t twii_WaitForDone(uint16_t timeout) {
@@ -1030,13 +1813,12 @@ uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
     }
     
     void twi_writeTo(uint8_t address, uint8_t* data, uint8_t length, uint8_t wait) {
-        uint8_t i;
-        ptwv = (twi_Write_Vars *)malloc(sizeof(twi_Write_Vars));
+        ptwv = &twi_vars;
         ptwv -> address = address;
         ptwv -> data = data;
         ptwv -> length = length;
         ptwv -> wait = wait;
-        fNextInterruptFunction = twi_write00;
+        twi_claimBus(twi_write00);
         return twi_write00();
     }
 
@@ -1051,7 +1833,10 @@ uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
     
     void twi_read00() {
         if (TWI_READY != twi_state) return; // blocking test
-        if (TWI_BUFFER_LENGTH < ptwv -> length) twi_Finish(0); // error return
+        if (TWI_BUFFER_LENGTH < ptwv -> length) {
+            twi_Finish(0); // error return
+            return;
+        }
         twi_Done = 0x00; // show as working
         twii_SetState(TWI_MRX); // reading
         twii_SetError(0xFF); // reset error
@@ -1063,13 +1848,11 @@ uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
     }
 
     void twi_readFrom(uint8_t address, uint8_t* data, uint8_t length) {
-        uint8_t i;
-
-        ptwv = (twi_Write_Vars *)malloc(sizeof(twi_Write_Vars));
+        ptwv = &twi_vars;
         ptwv -> address = address;
         ptwv -> data = data;
         ptwv -> length = length;
-        fNextInterruptFunction = twi_read00;
+        twi_claimBus(twi_read00);
         return twi_read00();
     }
 
@@ -1104,7 +1887,111 @@ uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
         twi_state = TWI_READY;
     }
     
+    // start the head transaction of the I2Cdev queue if the bus is free
+    static void twi_queueStart() {
+        uint8_t sreg = SREG;
+        cli();
+        if (twi_queueActive == 0 && fNextInterruptFunction == 0 && twi_busHolds == 0 && twi_state == TWI_READY && i2cdev_queueCount > 0) {
+            I2Cdev_Transaction *transaction = i2cdev_queue[i2cdev_queueHead];
+            transaction -> status = I2CDEV_STATUS_ACTIVE;
+            twi_queueActive = transaction;
+            twi_queueIndex = 0;
+            #ifdef I2CDEV_TRACE
+                twi_queueStartTime = micros();
+            #endif
+            twii_SetState(transaction -> direction == I2CDEV_READ ? TWI_MRX : TWI_MTX);
+            twii_SetSlaRW((transaction -> devAddr << 1) | TW_WRITE); // register address first
+            twii_SetStart();
+        }
+        SREG = sreg;
+    }
+
+    // complete the active transaction (bus already stopped or released), chain
+    // the next one, then call back
+    static void twi_queueComplete(uint8_t error) {
+        I2Cdev_Transaction *transaction = i2cdev_complete(twi_queueIndex, error);
+        twi_queueActive = 0;
+        #ifdef I2CDEV_TRACE
+            i2cdev_trace(transaction -> devAddr, transaction -> regAddr, transaction -> direction,
+                transaction -> length, transaction -> count, transaction -> error, twi_queueStartTime);
+        #endif
+        twi_queueStart();
+        if (transaction -> callback) transaction -> callback(transaction);
+    }
+
+    // TWI interrupt while a queued transaction is on the bus: the data goes
+    // straight to/from the descriptor buffer (no length limit), and reads
+    // send the register address then a repeated start
+    static void twi_queueService() {
+        I2Cdev_Transaction *transaction = twi_queueActive;
+        switch (TW_STATUS) {
+            case TW_START:     // sent start condition
+            case TW_REP_START: // sent repeated start condition
+                TWDR = twi_slarw;
+                twi_reply(1);
+                break;
+
+            case TW_MT_SLA_ACK: // slave acked address, send register address
+                TWDR = transaction -> regAddr;
+                twi_reply(1);
+                break;
+
+            case TW_MT_DATA_ACK: // slave acked register address or data
+                if (transaction -> direction == I2CDEV_READ) {
+                    twii_SetSlaRW((transaction -> devAddr << 1) | TW_READ);
+                    twii_SetStart();
+                } else if (twi_queueIndex < transaction -> length) {
+                    TWDR = transaction -> data[twi_queueIndex++];
+                    twi_reply(1);
+                } else {
+                    twi_stop();
+                    twi_queueComplete(0);
+                }
+                break;
+
+            case TW_MR_DATA_ACK: // data received, ack sent
+                transaction -> data[twi_queueIndex++] = TWDR;
+
+            case TW_MR_SLA_ACK:  // address sent, ack received
+                // ack if more bytes are expected, otherwise nack
+                twi_reply(twi_queueIndex + 1 < transaction -> length);
+                break;
+
+            case TW_MR_DATA_NACK: // final byte received, nack sent
+                transaction -> data[twi_queueIndex++] = TWDR;
+                twi_stop();
+                twi_queueComplete(0);
+                break;
+
+            case TW_MT_SLA_NACK: // address sent, nack received
+            case TW_MR_SLA_NACK:
+                twi_stop();
+                twi_queueComplete(2);
+                break;
+
+            case TW_MT_DATA_NACK: // register address or data sent, nack received
+                twi_stop();
+                twi_queueComplete(3);
+                break;
+
+            case TW_MT_ARB_LOST: // lost bus arbitration
+                twi_releaseBus();
+                twi_queueComplete(4);
+                break;
+
+            case TW_NO_INFO: // no state information
+                break;
+
+            default: // bus error, illegal stop/start
+                twi_stop();
+                twi_queueComplete(4);
+                break;
+        }
+    }
+
     SIGNAL(TWI_vect) {
+        if (twi_queueActive) return twi_queueService();
+
         switch (TW_STATUS) {
             // All Master
             case TW_START:     // sent start condition
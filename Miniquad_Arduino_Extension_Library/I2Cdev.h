@@ -3,6 +3,12 @@
 // 6/9/2012 by Jeff Rowberg <jeff@rowberg.net>
 //
 // Changelog:
+//     2026-10-16 - add I2CDEV_HOST_SIMULATION implementation (device models on a Linux host)
+//                - add optional transaction tracer and per-register traffic counters (I2CDEV_TRACE)
+//                - add setClock()/getClock() for every implementation, and probeClock()
+//                - add asynchronous transaction queue with completion callbacks (submit/poll/wait)
+//                - NBWire: queued transactions chained in the TWI ISR with repeated start reads
+//                - add readStream() for the registers that do not advance (FIFO), the address sent once
 //     2013-05-05 - fix issue with writing bit values to words (Sasquatch/Farzanegan)
 //     2012-06-09 - fix major issue with reading > 32 bytes at a time with Arduino Wire
 //                - add compiler warnings when using outdated or IDE or limited I2Cdev implementation
@@ -59,17 +65,31 @@ THE SOFTWARE.
                                       // ^^^ FastWire implementation in I2Cdev is INCOMPLETE!
 #define I2CDEV_I2CMASTER_LIBRARY    4 // I2C object from DSSCircuits I2C-Master Library at
                                       //  https://github.com/DSSCircuits/I2C-Master-Library
+#define I2CDEV_HOST_SIMULATION      5 // I2Cdev_HostDevice models attached with I2Cdev::attachHostDevice()
+                                      // ^^^ Linux host builds only (see Miniquad_Host_Tools/Simulator)
 
 // -----------------------------------------------------------------------------
-// I2C interface implementation setting
+// I2C interface implementation setting (host builds may define it on the command line)
 // -----------------------------------------------------------------------------
+#ifndef I2CDEV_IMPLEMENTATION
 #define I2CDEV_IMPLEMENTATION       I2CDEV_ARDUINO_WIRE
+#endif
 
 // -----------------------------------------------------------------------------
 // Arduino-style "Serial.print" debug constant (uncomment to enable)
 // -----------------------------------------------------------------------------
 //#define I2CDEV_SERIAL_DEBUG
 
+// -----------------------------------------------------------------------------
+// Transaction tracer and per-register traffic counters (uncomment to enable,
+// see I2Cdev::printTrace() and I2Cdev::printRegisterStats())
+// -----------------------------------------------------------------------------
+//#define I2CDEV_TRACE
+
+// transactions kept in the trace ring, and (device, register) pairs counted
+#define I2CDEV_TRACE_LENGTH             16
+#define I2CDEV_TRACE_REGISTERS          16
+
 #ifdef ARDUINO
     #if ARDUINO < 100
         #include "WProgram.h"
@@ -90,6 +110,138 @@ THE SOFTWARE.
 // 1000ms default read timeout (modify with "I2Cdev::readTimeout = [ms];")
 #define I2CDEV_DEFAULT_READ_TIMEOUT     1000
 
+// largest number of data bytes writeBytes() can send in a single transaction
+// (the Wire buffers also hold the register address byte)
+#if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
+    #define I2CDEV_MAX_WRITE_LENGTH     (BUFFER_LENGTH - 1)
+#elif I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+    #define I2CDEV_MAX_WRITE_LENGTH     (NBWIRE_BUFFER_LENGTH - 1)
+#else
+    #define I2CDEV_MAX_WRITE_LENGTH     32
+#endif
+
+// largest number of data bytes of a single read transaction (the Wire receive
+// buffer); longer reads go out in chunks of this size, and the host simulation
+// chunks like the Wire library it stands in for
+#if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
+    #define I2CDEV_READ_CHUNK_LENGTH    BUFFER_LENGTH
+#elif I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE
+    #define I2CDEV_READ_CHUNK_LENGTH    NBWIRE_BUFFER_LENGTH
+#else
+    #define I2CDEV_READ_CHUNK_LENGTH    32
+#endif
+
+// -----------------------------------------------------------------------------
+// I2C bus rates (see I2Cdev::setClock())
+// -----------------------------------------------------------------------------
+#define I2CDEV_CLOCK_STANDARD           100000L // standard mode, the Wire default
+#define I2CDEV_CLOCK_FAST               400000L // fast mode, the MPU6050 maximum
+#define I2CDEV_CLOCK_FAST_PLUS          1000000L // fast mode plus, beyond the MPU6050 spec (short buses only)
+
+// reads made at each rate by probeClock(), and failed reads tolerated before stepping down
+#define I2CDEV_PROBE_READS              8
+#define I2CDEV_PROBE_MAX_ERRORS         1
+
+// -----------------------------------------------------------------------------
+// Asynchronous transactions (see I2Cdev::submit())
+// -----------------------------------------------------------------------------
+// number of transactions the queue can hold (queued and active)
+#define I2CDEV_QUEUE_LENGTH             8
+
+// largest number of data bytes of a queued transaction (the queue runs the
+// transactions of most implementations through readBytes(), whose int8_t
+// result keeps -1 for the errors)
+#define I2CDEV_MAX_QUEUED_LENGTH        127
+
+// transaction directions
+#define I2CDEV_WRITE                    0
+#define I2CDEV_READ                     1
+
+// transaction status
+#define I2CDEV_STATUS_IDLE              0 // never submitted
+#define I2CDEV_STATUS_QUEUED            1 // waiting for the bus
+#define I2CDEV_STATUS_ACTIVE            2 // on the bus
+#define I2CDEV_STATUS_DONE              3 // completed, count == length
+#define I2CDEV_STATUS_FAILED            4 // completed with an error (see error)
+
+struct I2Cdev_Transaction;
+
+/** Completion callback of an asynchronous transaction. With NBWire it is called
+ * from the TWI interrupt: keep it short and do not call the blocking I2Cdev
+ * methods from it (submitting the next transaction is fine).
+ */
+typedef void (*I2Cdev_Callback)(I2Cdev_Transaction *transaction);
+
+/** Descriptor of an asynchronous register read or write. The descriptor and
+ * its data buffer stay owned by the caller, and must be left alone (and in
+ * scope) from submit() until the status is DONE or FAILED, so the queue needs
+ * no heap and no copy of the data.
+ */
+struct I2Cdev_Transaction {
+    uint8_t devAddr;            // I2C slave device address
+    uint8_t regAddr;            // first register address
+    uint8_t direction;          // I2CDEV_READ or I2CDEV_WRITE
+    uint8_t length;             // number of data bytes (reads need at least 1, I2CDEV_MAX_QUEUED_LENGTH at most)
+    uint8_t *data;              // data to write or container for the data read
+    I2Cdev_Callback callback;   // called on completion (0 for none)
+    void *context;              // free for the caller
+    volatile uint8_t status;    // I2CDEV_STATUS_*
+    volatile uint8_t count;     // number of data bytes transferred
+    volatile uint8_t error;     // 0, 2 = address nack, 3 = data nack, 4 = other bus error, 5 = timeout
+};
+
+/** Traced transaction (see I2CDEV_TRACE).
+ */
+struct I2Cdev_TraceEntry {
+    uint32_t start;             // micros() at the start of the transaction
+    uint16_t duration;          // microseconds (65535 for longer)
+    uint8_t devAddr;            // I2C slave device address
+    uint8_t regAddr;            // first register address
+    uint8_t direction;          // I2CDEV_READ or I2CDEV_WRITE
+    uint8_t length;             // number of data bytes requested
+    uint8_t count;              // number of data bytes transferred
+    uint8_t error;              // 0, 1 = too long, 2 = address nack, 3 = data nack, 4 = other bus error, 5 = timeout
+};
+
+/** Traffic counters of a (device, register) pair (see I2CDEV_TRACE).
+ */
+struct I2Cdev_RegisterStats {
+    uint8_t devAddr;            // I2C slave device address
+    uint8_t regAddr;            // first register address of the transactions
+    uint16_t errors;            // failed transactions
+    uint32_t reads;             // read transactions
+    uint32_t writes;            // write transactions
+    uint32_t bytes;             // data bytes transferred
+    uint32_t time;              // total bus time in microseconds
+    uint16_t maxTime;           // longest transaction in microseconds
+};
+
+#if I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION
+/** Device model on the simulated host bus (see I2Cdev::attachHostDevice()).
+ * Burst transactions start at regAddr; the model decides how the register
+ * address advances, as the real device does.
+ */
+class I2Cdev_HostDevice {
+    public:
+        /** Read a burst of registers.
+         * @return Number of bytes read (0 = device nack)
+         */
+        virtual uint8_t read(uint8_t regAddr, uint8_t length, uint8_t *data) = 0;
+        /** Read a burst from the register the last transaction has left the
+         * register address at, without sending the address (see readStream()).
+         * @return Number of bytes read (0 = device nack)
+         */
+        virtual uint8_t readCurrent(uint8_t length, uint8_t *data) = 0;
+        /** Write a burst of registers (length 0 only sets the register address).
+         * @return Status as Wire.endTransmission() (0 = success, 2 = address nack, 3 = data nack)
+         */
+        virtual uint8_t write(uint8_t regAddr, uint8_t length, const uint8_t *data) = 0;
+
+    protected:
+        ~I2Cdev_HostDevice() {}
+};
+#endif
+
 class I2Cdev {
     public:
         I2Cdev();
@@ -102,6 +254,7 @@ class I2Cdev {
         static int8_t readWord(uint8_t devAddr, uint8_t regAddr, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
         static int8_t readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
         static int8_t readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
+        static int16_t readStream(uint8_t devAddr, uint8_t regAddr, uint16_t length, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
 
         static bool writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data);
         static bool writeBitW(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint16_t data);
@@ -112,6 +265,34 @@ class I2Cdev {
         static bool writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data);
         static bool writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data);
 
+        static bool setClock(uint32_t clock);
+        static uint32_t getClock();
+        static uint32_t probeClock(uint8_t devAddr, uint8_t regAddr, uint32_t clock=I2CDEV_CLOCK_FAST, uint16_t timeout=I2Cdev::readTimeout);
+
+        static bool submit(I2Cdev_Transaction *transaction);
+        static bool readBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, I2Cdev_Transaction *transaction, I2Cdev_Callback callback=0, void *context=0);
+        static bool writeBytesAsync(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, I2Cdev_Transaction *transaction, I2Cdev_Callback callback=0, void *context=0);
+        static bool isDone(const I2Cdev_Transaction *transaction);
+        static bool wait(I2Cdev_Transaction *transaction, uint16_t timeout=I2Cdev::readTimeout);
+        static void poll();
+        static uint8_t getQueued();
+
+        #if I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION
+            static void attachHostDevice(uint8_t devAddr, I2Cdev_HostDevice *device);
+            static void detachHostDevice(uint8_t devAddr);
+        #endif
+
+        #ifdef I2CDEV_TRACE
+            static uint32_t getTraceTotal();
+            static uint8_t getTraceLength();
+            static bool getTraceEntry(uint8_t index, I2Cdev_TraceEntry *entry);
+            static uint8_t getRegisterStatsCount();
+            static bool getRegisterStats(uint8_t index, I2Cdev_RegisterStats *stats);
+            static void resetTrace();
+            static void printTrace();
+            static void printRegisterStats();
+        #endif
+
         static uint16_t readTimeout;
 };
 
@@ -36,6 +36,9 @@ THE SOFTWARE.
 
 #include "MPU6050.h"
 
+// the library runs without a heap (see "make heapcheck" of the host tools)
+#pragma GCC poison malloc calloc realloc free
+
 /** Default constructor, uses default I2C address.
  * @see MPU6050_DEFAULT_ADDRESS
  */
@@ -2640,7 +2643,27 @@ void MPU6050::setStandbyZGyroEnabled(bool enabled) {
  */
 uint16_t MPU6050::getFIFOCount() {
     I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_COUNTH, 2, buffer);
-    return (((uint16_t)buffer[0]) << 8) | buffer[1];
+    return decodeFIFOCount(buffer);
+}
+/** Queue a read of the FIFO buffer size (see I2Cdev::submit()).
+ * The class buffer is shared by the blocking getters, so the two count bytes
+ * go to a caller buffer; decode them with decodeFIFOCount() on completion.
+ * @param transaction Descriptor to queue (must stay valid until completion)
+ * @param countBuffer Container for the 2 count bytes (must stay valid until completion)
+ * @param callback Optional completion callback
+ * @param context Optional pointer stored in the descriptor for the callback
+ * @return Status of submission (true = queued)
+ * @see getFIFOCount()
+ */
+bool MPU6050::getFIFOCountAsync(I2Cdev_Transaction *transaction, uint8_t *countBuffer, I2Cdev_Callback callback, void *context) {
+    return I2Cdev::readBytesAsync(devAddr, MPU6050_RA_FIFO_COUNTH, 2, countBuffer, transaction, callback, context);
+}
+/** Decode the FIFO buffer size read by getFIFOCountAsync().
+ * @param countBuffer The 2 count bytes (FIFO_COUNTH, FIFO_COUNTL)
+ * @return FIFO buffer size
+ */
+uint16_t MPU6050::decodeFIFOCount(const uint8_t *countBuffer) {
+    return (((uint16_t)countBuffer[0]) << 8) | countBuffer[1];
 }
 
 // FIFO_R_W register
@@ -2674,8 +2697,28 @@ uint8_t MPU6050::getFIFOByte() {
     I2Cdev::readByte(devAddr, MPU6050_RA_FIFO_R_W, buffer);
     return buffer[0];
 }
-void MPU6050::getFIFOBytes(uint8_t *data, uint8_t length) {
-    I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_R_W, length, data);
+/** Read bytes from the FIFO buffer. FIFO_R_W does not advance, so the read is
+ * streamed: the register address goes out once for any length (see
+ * I2Cdev::readStream()).
+ * @param data Container for the bytes read
+ * @param length Number of bytes to read (check getFIFOCount() first)
+ */
+void MPU6050::getFIFOBytes(uint8_t *data, uint16_t length) {
+    I2Cdev::readStream(devAddr, MPU6050_RA_FIFO_R_W, length, data);
+}
+/** Queue a read of bytes from the FIFO buffer (see I2Cdev::submit()).
+ * With NBWire the burst runs from the TWI interrupt while the caller goes on,
+ * e.g. reading the next DMP packet while the last one is decoded.
+ * @param data Container for the bytes read (must stay valid until completion)
+ * @param length Number of bytes to read (check getFIFOCount() first)
+ * @param transaction Descriptor to queue (must stay valid until completion)
+ * @param callback Optional completion callback
+ * @param context Optional pointer stored in the descriptor for the callback
+ * @return Status of submission (true = queued)
+ * @see getFIFOBytes()
+ */
+bool MPU6050::getFIFOBytesAsync(uint8_t *data, uint8_t length, I2Cdev_Transaction *transaction, I2Cdev_Callback callback, void *context) {
+    return I2Cdev::readBytesAsync(devAddr, MPU6050_RA_FIFO_R_W, length, data, transaction, callback, context);
 }
 /** Write byte to FIFO buffer.
  * @see getFIFOByte()
@@ -2923,6 +2966,26 @@ void MPU6050::setMemoryStartAddress(uint8_t address) {
     I2Cdev::writeByte(devAddr, MPU6050_RA_MEM_START_ADDR, address);
 }
 
+// BANK_SEL and MEM_START_ADDR registers
+
+/** Set memory bank (no prefetch, DMP bank) and start address together.
+ * With the Wire implementations and the host simulation this is a single
+ * transaction, as MEM_START_ADDR directly follows BANK_SEL in the register map.
+ * @param bank Memory bank (0-31)
+ * @param address Start address in the bank
+ */
+void MPU6050::setMemoryBankAndStartAddress(uint8_t bank, uint8_t address) {
+    #if (I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE || I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_NBWIRE || I2CDEV_IMPLEMENTATION == I2CDEV_HOST_SIMULATION)
+        buffer[0] = bank & 0x1F;
+        buffer[1] = address;
+        I2Cdev::writeBytes(devAddr, MPU6050_RA_BANK_SEL, 2, buffer);
+    #else
+        // other implementations write every byte to the same register
+        setMemoryBank(bank);
+        setMemoryStartAddress(address);
+    #endif
+}
+
 // MEM_R_W register
 
 uint8_t MPU6050::readMemoryByte() {
@@ -2967,12 +3030,11 @@ bool MPU6050::writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t b
     setMemoryBank(bank);
     setMemoryStartAddress(address);
     uint8_t chunkSize;
-    uint8_t *verifyBuffer;
+    uint8_t verifyBuffer[MPU6050_DMP_MEMORY_CHUNK_SIZE];
+    uint8_t progChunk[MPU6050_DMP_MEMORY_CHUNK_SIZE];
     uint8_t *progBuffer;
     uint16_t i;
     uint8_t j;
-    if (verify) verifyBuffer = (uint8_t *)malloc(MPU6050_DMP_MEMORY_CHUNK_SIZE);
-    if (useProgMem) progBuffer = (uint8_t *)malloc(MPU6050_DMP_MEMORY_CHUNK_SIZE);
     for (i = 0; i < dataSize;) {
         // determine correct chunk size according to bank position and data size
         chunkSize = MPU6050_DMP_MEMORY_CHUNK_SIZE;
@@ -2985,7 +3047,8 @@ bool MPU6050::writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t b
         
         if (useProgMem) {
             // write the chunk of data as specified
-            for (j = 0; j < chunkSize; j++) progBuffer[j] = pgm_read_byte(data + i + j);
+            for (j = 0; j < chunkSize; j++) progChunk[j] = pgm_read_byte(data + i + j);
+            progBuffer = progChunk;
         } else {
             // write the chunk of data as specified
             progBuffer = (uint8_t *)data + i;
@@ -2994,7 +3057,7 @@ bool MPU6050::writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t b
         I2Cdev::writeBytes(devAddr, MPU6050_RA_MEM_R_W, chunkSize, progBuffer);
 
         // verify data if needed
-        if (verify && verifyBuffer) {
+        if (verify) {
             setMemoryBank(bank);
             setMemoryStartAddress(address);
             I2Cdev::readBytes(devAddr, MPU6050_RA_MEM_R_W, chunkSize, verifyBuffer);
@@ -3016,8 +3079,6 @@ bool MPU6050::writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t b
                     Serial.print(verifyBuffer[i + j], HEX);
                 }
                 Serial.print("\n");*/
-                free(verifyBuffer);
-                if (useProgMem) free(progBuffer);
                 return false; // uh oh.
             }
         }
@@ -3035,19 +3096,103 @@ bool MPU6050::writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t b
             setMemoryStartAddress(address);
         }
     }
-    if (verify) free(verifyBuffer);
-    if (useProgMem) free(progBuffer);
     return true;
 }
 bool MPU6050::writeProgMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify) {
     return writeMemoryBlock(data, dataSize, bank, address, verify, true);
 }
-bool MPU6050::writeDMPConfigurationSet(const uint8_t *data, uint16_t dataSize, bool useProgMem) {
-    uint8_t *progBuffer, success, special;
-    uint16_t i, j;
-    if (useProgMem) {
-        progBuffer = (uint8_t *)malloc(8); // assume 8-byte blocks, realloc later if necessary
+
+/** Update a Fletcher-16 checksum ([sum2][sum1]) with a block of data.
+ * @param checksum Checksum so far (0 to start)
+ * @param data Block of data
+ * @param length Length of the block
+ * @return Updated checksum
+ */
+static uint16_t updateMemoryChecksum(uint16_t checksum, const uint8_t *data, uint8_t length) {
+    uint16_t sum1 = checksum & 0xFF;
+    uint16_t sum2 = checksum >> 8;
+    for (uint8_t j = 0; j < length; j++) {
+        sum1 = (sum1 + data[j]) % 255;
+        sum2 = (sum2 + sum1) % 255;
     }
+    return (sum2 << 8) | sum1;
+}
+
+/** Write a block of memory in the largest bursts the I2C implementation allows.
+ * Unlike writeMemoryBlock(), bank and start address are set once per burst in a
+ * single transaction, and verification reads the whole block back once and
+ * compares Fletcher-16 checksums instead of re-reading every chunk.
+ * @param data Block of data (RAM or program memory)
+ * @param dataSize Size of the block, it may cross memory banks
+ * @param bank First memory bank
+ * @param address Start address in the first bank
+ * @param verify Whether the block is read back and its checksum compared
+ * @param useProgMem Whether data is in program memory
+ * @return Whether the block has been written (and verified)
+ */
+bool MPU6050::writeMemoryBurst(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify, bool useProgMem) {
+    uint8_t burst[MPU6050_DMP_MEMORY_BURST_SIZE];
+    uint8_t *burstData;
+    uint8_t burstSize;
+    uint8_t startBank = bank;
+    uint8_t startAddress = address;
+    uint16_t checksum = 0;
+    for (uint16_t i = 0; i < dataSize;) {
+        // determine burst size according to bank position and data size
+        burstSize = MPU6050_DMP_MEMORY_BURST_SIZE;
+        if (i + burstSize > dataSize) burstSize = dataSize - i;
+        if (burstSize > 256 - address) burstSize = 256 - address;
+
+        if (useProgMem) {
+            for (uint8_t j = 0; j < burstSize; j++) burst[j] = pgm_read_byte(data + i + j);
+            burstData = burst;
+        } else {
+            burstData = (uint8_t *)data + i;
+        }
+
+        setMemoryBankAndStartAddress(bank, address);
+        if (!I2Cdev::writeBytes(devAddr, MPU6050_RA_MEM_R_W, burstSize, burstData)) return false;
+        if (verify) checksum = updateMemoryChecksum(checksum, burstData, burstSize);
+
+        // uint8_t automatically wraps to 0 at 256
+        i += burstSize;
+        address += burstSize;
+        if (address == 0) bank++;
+    }
+    if (verify) return getMemoryChecksum(dataSize, startBank, startAddress) == checksum;
+    return true;
+}
+bool MPU6050::writeProgMemoryBurst(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify) {
+    return writeMemoryBurst(data, dataSize, bank, address, verify, true);
+}
+/** Read a block of memory back in bursts and compute its Fletcher-16 checksum.
+ * @param dataSize Size of the block, it may cross memory banks
+ * @param bank First memory bank
+ * @param address Start address in the first bank
+ * @return Checksum of the block
+ */
+uint16_t MPU6050::getMemoryChecksum(uint16_t dataSize, uint8_t bank, uint8_t address) {
+    uint8_t burst[MPU6050_DMP_MEMORY_BURST_SIZE];
+    uint8_t burstSize;
+    uint16_t checksum = 0;
+    for (uint16_t i = 0; i < dataSize;) {
+        burstSize = MPU6050_DMP_MEMORY_BURST_SIZE;
+        if (i + burstSize > dataSize) burstSize = dataSize - i;
+        if (burstSize > 256 - address) burstSize = 256 - address;
+
+        setMemoryBankAndStartAddress(bank, address);
+        I2Cdev::readBytes(devAddr, MPU6050_RA_MEM_R_W, burstSize, burst);
+        checksum = updateMemoryChecksum(checksum, burst, burstSize);
+
+        i += burstSize;
+        address += burstSize;
+        if (address == 0) bank++;
+    }
+    return checksum;
+}
+bool MPU6050::writeDMPConfigurationSet(const uint8_t *data, uint16_t dataSize, bool useProgMem) {
+    uint8_t success, special;
+    uint16_t i;
 
     // config set data is a long string of blocks with the following structure:
     // [bank] [offset] [length] [byte[0], byte[1], ..., byte[length]]
@@ -3072,13 +3217,8 @@ bool MPU6050::writeDMPConfigurationSet(const uint8_t *data, uint16_t dataSize, b
             Serial.print(offset);
             Serial.print(", length=");
             Serial.println(length);*/
-            if (useProgMem) {
-                if (sizeof(progBuffer) < length) progBuffer = (uint8_t *)realloc(progBuffer, length);
-                for (j = 0; j < length; j++) progBuffer[j] = pgm_read_byte(data + i + j);
-            } else {
-                progBuffer = (uint8_t *)data + i;
-            }
-            success = writeMemoryBlock(progBuffer, length, bank, offset, true);
+            // writeMemoryBlock() reads program memory itself, chunk by chunk
+            success = writeMemoryBlock(data + i, length, bank, offset, true, useProgMem);
             i += length;
         } else {
             // special instruction
@@ -3110,16 +3250,77 @@ bool MPU6050::writeDMPConfigurationSet(const uint8_t *data, uint16_t dataSize, b
         }
         
         if (!success) {
-            if (useProgMem) free(progBuffer);
             return false; // uh oh
         }
     }
-    if (useProgMem) free(progBuffer);
     return true;
 }
 bool MPU6050::writeProgDMPConfigurationSet(const uint8_t *data, uint16_t dataSize) {
     return writeDMPConfigurationSet(data, dataSize, true);
 }
+/** Write a DMP configuration set the fast way.
+ * The set is already a flat list of [bank] [offset] [length] [byte[0], ..., byte[length]]
+ * writes, so each block goes out as one address and one data transaction from a stack
+ * buffer. Verification reads every block back once afterwards and compares
+ * Fletcher-16 checksums instead of re-reading each block right after its write.
+ * @param data Configuration set (RAM or program memory)
+ * @param dataSize Size of the configuration set
+ * @param verify Whether the blocks are read back and their checksum compared
+ * @param useProgMem Whether data is in program memory
+ * @return Whether the set has been written (and verified)
+ */
+bool MPU6050::writeDMPConfigurationSetBurst(const uint8_t *data, uint16_t dataSize, bool verify, bool useProgMem) {
+    uint8_t block[MPU6050_DMP_MEMORY_BURST_SIZE];
+    uint8_t bank, offset, length, j;
+    uint16_t i;
+    uint16_t checksum = 0;
+
+    // write pass
+    for (i = 0; i < dataSize;) {
+        bank = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+        offset = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+        length = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+
+        if (length > 0) {
+            // regular block of data to write (blocks of dmpConfig[] are at most 6 bytes)
+            if (length > MPU6050_DMP_MEMORY_BURST_SIZE) return false;
+            for (j = 0; j < length; j++) block[j] = useProgMem ? pgm_read_byte(data + i + j) : data[i + j];
+            setMemoryBankAndStartAddress(bank, offset);
+            if (!I2Cdev::writeBytes(devAddr, MPU6050_RA_MEM_R_W, length, block)) return false;
+            if (verify) checksum = updateMemoryChecksum(checksum, block, length);
+            i += length;
+        } else {
+            // special instruction, see writeDMPConfigurationSet()
+            uint8_t special = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+            if (special != 0x01) return false; // unknown special command
+
+            // enable DMP-related interrupts
+            I2Cdev::writeByte(devAddr, MPU6050_RA_INT_ENABLE, 0x32);  // single operation
+        }
+    }
+    if (!verify) return true;
+
+    // verify pass
+    uint16_t readback = 0;
+    for (i = 0; i < dataSize;) {
+        bank = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+        offset = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+        length = useProgMem ? pgm_read_byte(data + i) : data[i]; i++;
+
+        if (length > 0) {
+            setMemoryBankAndStartAddress(bank, offset);
+            I2Cdev::readBytes(devAddr, MPU6050_RA_MEM_R_W, length, block);
+            readback = updateMemoryChecksum(readback, block, length);
+            i += length;
+        } else {
+            i++; // special instruction
+        }
+    }
+    return readback == checksum;
+}
+bool MPU6050::writeProgDMPConfigurationSetBurst(const uint8_t *data, uint16_t dataSize, bool verify) {
+    return writeDMPConfigurationSetBurst(data, dataSize, verify, true);
+}
 
 // DMP_CFG_1 register
 
@@ -395,6 +395,7 @@ THE SOFTWARE.
 #define MPU6050_DMP_MEMORY_BANKS        8
 #define MPU6050_DMP_MEMORY_BANK_SIZE    256
 #define MPU6050_DMP_MEMORY_CHUNK_SIZE   16
+#define MPU6050_DMP_MEMORY_BURST_SIZE   I2CDEV_MAX_WRITE_LENGTH
 
 // note: DMP code memory blocks defined at end of header file
 
@@ -667,11 +668,14 @@ class MPU6050 {
 
         // FIFO_COUNT_* registers
         uint16_t getFIFOCount();
+        bool getFIFOCountAsync(I2Cdev_Transaction *transaction, uint8_t *countBuffer, I2Cdev_Callback callback=0, void *context=0);
+        static uint16_t decodeFIFOCount(const uint8_t *countBuffer);
 
         // FIFO_R_W register
         uint8_t getFIFOByte();
         void setFIFOByte(uint8_t data);
-        void getFIFOBytes(uint8_t *data, uint8_t length);
+        void getFIFOBytes(uint8_t *data, uint16_t length);
+        bool getFIFOBytesAsync(uint8_t *data, uint8_t length, I2Cdev_Transaction *transaction, I2Cdev_Callback callback=0, void *context=0);
 
         // WHO_AM_I register
         uint8_t getDeviceID();
@@ -757,6 +761,9 @@ class MPU6050 {
         
         // MEM_START_ADDR register
         void setMemoryStartAddress(uint8_t address);
+
+        // BANK_SEL and MEM_START_ADDR registers
+        void setMemoryBankAndStartAddress(uint8_t bank, uint8_t address);
         
         // MEM_R_W register
         uint8_t readMemoryByte();
@@ -764,9 +771,14 @@ class MPU6050 {
         void readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank=0, uint8_t address=0);
         bool writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank=0, uint8_t address=0, bool verify=true, bool useProgMem=false);
         bool writeProgMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank=0, uint8_t address=0, bool verify=true);
+        bool writeMemoryBurst(const uint8_t *data, uint16_t dataSize, uint8_t bank=0, uint8_t address=0, bool verify=true, bool useProgMem=false);
+        bool writeProgMemoryBurst(const uint8_t *data, uint16_t dataSize, uint8_t bank=0, uint8_t address=0, bool verify=true);
+        uint16_t getMemoryChecksum(uint16_t dataSize, uint8_t bank=0, uint8_t address=0);
 
         bool writeDMPConfigurationSet(const uint8_t *data, uint16_t dataSize, bool useProgMem=false);
         bool writeProgDMPConfigurationSet(const uint8_t *data, uint16_t dataSize);
+        bool writeDMPConfigurationSetBurst(const uint8_t *data, uint16_t dataSize, bool verify=true, bool useProgMem=false);
+        bool writeProgDMPConfigurationSetBurst(const uint8_t *data, uint16_t dataSize, bool verify=true);
 
         // DMP_CFG_1 register
         uint8_t getDMPConfig1();
@@ -780,12 +792,28 @@ class MPU6050 {
         #ifdef MPU6050_INCLUDE_DMP_MOTIONAPPS20
             uint8_t *dmpPacketBuffer;
             uint16_t dmpPacketSize;
+            uint8_t dmpPacketContents;
+            uint32_t dmpUploadTime;
 
             uint8_t dmpInitialize();
+            void dmpBeginInitialize();
+            void dmpPrepareUpload(int8_t *gyroOffsetTC);
+            bool dmpUploadCode(uint8_t bank);
+            uint16_t dmpUploadConfig(uint16_t position);
+            bool dmpConfigure(const int8_t *gyroOffsetTC);
+            bool dmpFinishInitialize(uint8_t pass);
+            void dmpDrainFIFO();
+            uint32_t dmpGetUploadTime();
+            bool dmpWriteUpdate(uint8_t update);
+            bool dmpSetSignature(bool valid);
+            bool dmpIsConfigured(uint8_t gyroRange=MPU6050_GYRO_FS_2000);
             bool dmpPacketAvailable();
 
             uint8_t dmpSetFIFORate(uint8_t fifoRate);
             uint8_t dmpGetFIFORate();
+            uint8_t dmpSetPacketContents(uint8_t contents);
+            bool dmpWritePacketBlocks(uint8_t contents);
+            uint8_t dmpGetPacketContents();
             uint8_t dmpGetSampleStepSizeMS();
             uint8_t dmpGetSampleFrequency();
             int32_t dmpDecodeTemperature(int8_t tempReg);
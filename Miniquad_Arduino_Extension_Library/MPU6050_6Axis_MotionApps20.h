@@ -41,6 +41,7 @@ THE SOFTWARE.
 
 #include "MPU6050.h"
 #include <avr/pgmspace.h>
+#include "Miniquad_fastmath.h"
 
 /* Source is from the InvenSense MotionApps v2 demo code. Original source is
  * unavailable, unless you happen to be amazing as decompiling binary by
@@ -69,9 +70,23 @@ THE SOFTWARE.
     #define DEBUG_PRINTLNF(x, y)
 #endif
 
+// Fast DMP upload: the code, the configuration and the update records go out in the
+// largest bursts the I2C implementation allows, with bank and address sent once per burst.
+// MPU6050_DMP_FAST_UPLOAD_VERIFY selects a single checksum read-back pass (true) or
+// no verification at all (false). Comment out to use the chunked upload with
+// byte-for-byte verification.
+#define MPU6050_DMP_FAST_UPLOAD
+#define MPU6050_DMP_FAST_UPLOAD_VERIFY  true
+
 #define MPU6050_DMP_CODE_SIZE       1929    // dmpMemory[]
 #define MPU6050_DMP_CONFIG_SIZE     192     // dmpConfig[]
 #define MPU6050_DMP_UPDATES_SIZE    47      // dmpUpdates[]
+#define MPU6050_DMP_CODE_BANKS      8       // memory banks of dmpMemory[] (256 bytes each)
+
+// Waits of the DMP initialization (see dmpInitialize())
+#define MPU6050_DMP_RESET_DELAY         30  // ms after the device reset
+#define MPU6050_DMP_I2C_MASTER_DELAY    20  // ms after the I2C master reset
+#define MPU6050_DMP_SETTLE_FIFO_COUNT   3   // FIFO bytes of the running DMP before each final pass
 
 /* ================================================================================================ *
  | Default MotionApps v2.0 42-byte FIFO packet structure:                                           |
@@ -83,6 +98,27 @@ THE SOFTWARE.
  |  24  25  26  27  28  29  30  31  32  33  34  35  36  37  38  39  40  41                          |
  * ================================================================================================ */
 
+// Optional FIFO packet contents for dmpSetPacketContents(). The quaternion (16 bytes) and the
+// footer (2 bytes) are always sent, each optional block is 12 bytes and keeps the order above.
+#define MPU6050_DMP_PACKET_GYRO     0x01
+#define MPU6050_DMP_PACKET_ACCEL    0x02
+#define MPU6050_DMP_PACKET_DEFAULT  (MPU6050_DMP_PACKET_GYRO | MPU6050_DMP_PACKET_ACCEL)
+
+// DMP memory locations patched at runtime (bank, address)
+#define MPU6050_DMP_FIFO_RATE_BANK      0x02    // D_0_22 inv_set_fifo_rate
+#define MPU6050_DMP_FIFO_RATE_ADDRESS   0x16
+#define MPU6050_DMP_CFG_GYRO_BANK       0x07    // CFG_9 inv_send_gyro
+#define MPU6050_DMP_CFG_GYRO_ADDRESS    0x47
+#define MPU6050_DMP_CFG_ACCEL_BANK      0x07    // CFG_12 inv_send_accel
+#define MPU6050_DMP_CFG_ACCEL_ADDRESS   0x6C
+
+// Signature marking a completely configured DMP, kept in spare bytes of bank 7 past the
+// end of dmpMemory[] (it survives an MCU reset while the MPU stays powered)
+#define MPU6050_DMP_SIGNATURE_BANK      0x07
+#define MPU6050_DMP_SIGNATURE_ADDRESS   0xFC
+#define MPU6050_DMP_SIGNATURE_SIZE      4
+#define MPU6050_DMP_SIGNATURE           { 'M', 'Q', 0x20, 0x01 }
+
 // this block of memory gets written to the MPU on start-up, and it seems
 // to be volatile memory, so it has to be done each time (it only takes ~1
 // second though)
@@ -278,12 +314,64 @@ const unsigned char dmpUpdates[MPU6050_DMP_UPDATES_SIZE] PROGMEM = {
     0x00,   0x60,   0x04,   0x00, 0x40, 0x00, 0x00
 };
 
+// start of each record of dmpUpdates[] (same layout as dmpConfig[]), and the end
+const unsigned char dmpUpdateOffsets[8] PROGMEM = { 0, 5, 12, 17, 28, 35, 40, MPU6050_DMP_UPDATES_SIZE };
+
+/** Initialize the DMP: reset the MPU, upload the DMP code and configuration and run
+ * the final memory updates (blocking, the upload takes most of the time). The steps are
+ * public as well, so a caller may run them one at a time between other work:
+ * dmpBeginInitialize(), wait MPU6050_DMP_RESET_DELAY ms, dmpPrepareUpload(), wait
+ * MPU6050_DMP_I2C_MASTER_DELAY ms, dmpUploadCode() for each of the MPU6050_DMP_CODE_BANKS
+ * banks, dmpUploadConfig() until the whole configuration is written, dmpConfigure(),
+ * then dmpFinishInitialize(1) and (2), each once the FIFO holds
+ * MPU6050_DMP_SETTLE_FIFO_COUNT bytes.
+ * @return Status (0 = success, 1 = code upload failed, 2 = configuration failed)
+ */
 uint8_t MPU6050::dmpInitialize() {
+    int8_t gyroOffsetTC[3];
+    dmpBeginInitialize();
+    delay(MPU6050_DMP_RESET_DELAY);
+    dmpPrepareUpload(gyroOffsetTC);
+    delay(MPU6050_DMP_I2C_MASTER_DELAY);
+
+    // load DMP code into memory banks, then the configuration
+    uint32_t uploadStart = micros();
+    for (uint8_t bank = 0; bank < MPU6050_DMP_CODE_BANKS; bank++) {
+        if (!dmpUploadCode(bank)) return 1; // main binary block loading failed
+    }
+    for (uint16_t position = 0; position < MPU6050_DMP_CONFIG_SIZE;) {
+        position = dmpUploadConfig(position);
+        if (position == 0) return 2; // configuration block loading failed
+    }
+    dmpUploadTime = micros() - uploadStart;
+    DEBUG_PRINT(F("DMP upload took "));
+    DEBUG_PRINT(dmpUploadTime);
+    DEBUG_PRINTLN(F(" us"));
+
+    if (!dmpConfigure(gyroOffsetTC)) return 2; // configuration update failed
+    for (uint8_t pass = 1; pass <= 2; pass++) {
+        DEBUG_PRINTLN(F("Waiting for FIFO count > 2..."));
+        while (getFIFOCount() < MPU6050_DMP_SETTLE_FIFO_COUNT);
+        if (!dmpFinishInitialize(pass)) return 2; // configuration update failed
+    }
+    return 0; // success
+}
+/** First step of the DMP initialization: reset the device. The caller waits
+ * MPU6050_DMP_RESET_DELAY ms before dmpPrepareUpload().
+ * @see dmpInitialize()
+ */
+void MPU6050::dmpBeginInitialize() {
     // reset device
     DEBUG_PRINTLN(F("\n\nResetting MPU6050..."));
     reset();
-    delay(30); // wait after reset
-
+}
+/** Step of the DMP initialization after the reset: wake the device, save the gyro
+ * offset TCs, set up the I2C master and clear the DMP signature. The caller waits
+ * MPU6050_DMP_I2C_MASTER_DELAY ms before the upload.
+ * @param gyroOffsetTC Container for the X/Y/Z gyro offset TCs, restored by dmpConfigure()
+ * @see dmpInitialize()
+ */
+void MPU6050::dmpPrepareUpload(int8_t *gyroOffsetTC) {
     // enable sleep mode and wake cycle
     /*Serial.println(F("Enabling sleep mode..."));
     setSleepEnabled(true);
@@ -305,24 +393,20 @@ uint8_t MPU6050::dmpInitialize() {
     DEBUG_PRINTLNF(hwRevision, HEX);
     DEBUG_PRINTLN(F("Resetting memory bank selection to 0..."));
     setMemoryBank(0, false, false);
+    (void)hwRevision;
 
     // check OTP bank valid
     DEBUG_PRINTLN(F("Reading OTP bank valid flag..."));
     uint8_t otpValid = getOTPBankValid();
     DEBUG_PRINT(F("OTP bank is "));
     DEBUG_PRINTLN(otpValid ? F("valid!") : F("invalid!"));
+    (void)otpValid;
 
     // get X/Y/Z gyro offsets
     DEBUG_PRINTLN(F("Reading gyro offset TC values..."));
-    int8_t xgOffsetTC = getXGyroOffsetTC();
-    int8_t ygOffsetTC = getYGyroOffsetTC();
-    int8_t zgOffsetTC = getZGyroOffsetTC();
-    DEBUG_PRINT(F("X gyro offset = "));
-    DEBUG_PRINTLN(xgOffset);
-    DEBUG_PRINT(F("Y gyro offset = "));
-    DEBUG_PRINTLN(ygOffset);
-    DEBUG_PRINT(F("Z gyro offset = "));
-    DEBUG_PRINTLN(zgOffset);
+    gyroOffsetTC[0] = getXGyroOffsetTC();
+    gyroOffsetTC[1] = getYGyroOffsetTC();
+    gyroOffsetTC[2] = getZGyroOffsetTC();
 
     // setup weird slave stuff (?)
     DEBUG_PRINTLN(F("Setting slave 0 address to 0x7F..."));
@@ -333,182 +417,322 @@ uint8_t MPU6050::dmpInitialize() {
     setSlaveAddress(0, 0x68);
     DEBUG_PRINTLN(F("Resetting I2C Master control..."));
     resetI2CMaster();
-    delay(20);
-
-    // load DMP code into memory banks
-    DEBUG_PRINT(F("Writing DMP code to MPU memory banks ("));
-    DEBUG_PRINT(MPU6050_DMP_CODE_SIZE);
-    DEBUG_PRINTLN(F(" bytes)"));
-    if (writeProgMemoryBlock(dmpMemory, MPU6050_DMP_CODE_SIZE)) {
-        DEBUG_PRINTLN(F("Success! DMP code written and verified."));
-
-        // write DMP configuration
-        DEBUG_PRINT(F("Writing DMP configuration to MPU memory banks ("));
-        DEBUG_PRINT(MPU6050_DMP_CONFIG_SIZE);
-        DEBUG_PRINTLN(F(" bytes in config def)"));
-        if (writeProgDMPConfigurationSet(dmpConfig, MPU6050_DMP_CONFIG_SIZE)) {
-            DEBUG_PRINTLN(F("Success! DMP configuration written and verified."));
 
-            DEBUG_PRINTLN(F("Setting clock source to Z Gyro..."));
-            setClockSource(MPU6050_CLOCK_PLL_ZGYRO);
-
-            DEBUG_PRINTLN(F("Setting DMP and FIFO_OFLOW interrupts enabled..."));
-            setIntEnabled(0x12);
-
-            DEBUG_PRINTLN(F("Setting sample rate to 200Hz..."));
-            setRate(4); // 1khz / (1 + 4) = 200 Hz
-
-            DEBUG_PRINTLN(F("Setting external frame sync to TEMP_OUT_L[0]..."));
-            setExternalFrameSync(MPU6050_EXT_SYNC_TEMP_OUT_L);
-
-            DEBUG_PRINTLN(F("Setting DLPF bandwidth to 42Hz..."));
-            setDLPFMode(MPU6050_DLPF_BW_42);
-
-            DEBUG_PRINTLN(F("Setting gyro sensitivity to +/- 2000 deg/sec..."));
-            setFullScaleGyroRange(MPU6050_GYRO_FS_2000);
-
-            DEBUG_PRINTLN(F("Setting DMP configuration bytes (function unknown)..."));
-            setDMPConfig1(0x03);
-            setDMPConfig2(0x00);
-
-            DEBUG_PRINTLN(F("Clearing OTP Bank flag..."));
-            setOTPBankValid(false);
-
-            DEBUG_PRINTLN(F("Setting X/Y/Z gyro offset TCs to previous values..."));
-            setXGyroOffsetTC(xgOffsetTC);
-            setYGyroOffsetTC(ygOffsetTC);
-            setZGyroOffsetTC(zgOffsetTC);
+    // invalidate the signature until the DMP has been configured completely
+    DEBUG_PRINTLN(F("Clearing DMP signature..."));
+    dmpSetSignature(false);
+}
+/** Upload one memory bank of the DMP code (256 bytes, the last bank is shorter).
+ * @param bank Memory bank (0 ~ MPU6050_DMP_CODE_BANKS - 1)
+ * @return Whether the bank has been written and verified
+ * @see dmpInitialize()
+ */
+bool MPU6050::dmpUploadCode(uint8_t bank) {
+    uint16_t start = (uint16_t)bank << 8;
+    if (start >= MPU6050_DMP_CODE_SIZE) return false;
+    uint16_t size = MPU6050_DMP_CODE_SIZE - start;
+    if (size > 256) size = 256;
+    DEBUG_PRINT(F("Writing DMP code to MPU memory bank "));
+    DEBUG_PRINTLN(bank);
+    #ifdef MPU6050_DMP_FAST_UPLOAD
+        return writeProgMemoryBurst(dmpMemory + start, size, bank, 0, MPU6050_DMP_FAST_UPLOAD_VERIFY);
+    #else
+        return writeProgMemoryBlock(dmpMemory + start, size, bank);
+    #endif
+}
+/** Upload one record of the DMP configuration ([bank] [offset] [length] [bytes], or a
+ * special instruction with length 0).
+ * @param position Start of the record in dmpConfig[] (0 for the first one)
+ * @return Start of the next record (MPU6050_DMP_CONFIG_SIZE after the last one), or 0 if
+ *         the record has not been written and verified
+ * @see dmpInitialize()
+ */
+uint16_t MPU6050::dmpUploadConfig(uint16_t position) {
+    if (position >= MPU6050_DMP_CONFIG_SIZE) return 0;
+    uint8_t length = pgm_read_byte(dmpConfig + position + 2);
+    uint16_t size = 3 + (length ? length : 1);
+    #ifdef MPU6050_DMP_FAST_UPLOAD
+        bool configLoaded = writeProgDMPConfigurationSetBurst(dmpConfig + position, size, MPU6050_DMP_FAST_UPLOAD_VERIFY);
+    #else
+        bool configLoaded = writeProgDMPConfigurationSet(dmpConfig + position, size);
+    #endif
+    if (!configLoaded) {
+        DEBUG_PRINTLN(F("ERROR! DMP configuration verification failed."));
+        return 0;
+    }
+    return position + size;
+}
+/** Step of the DMP initialization after the upload: set up the sensors and the FIFO,
+ * run the final memory updates 1 ~ 5 and start the DMP. The caller waits for
+ * MPU6050_DMP_SETTLE_FIFO_COUNT bytes in the FIFO before dmpFinishInitialize(1).
+ * @param gyroOffsetTC The X/Y/Z gyro offset TCs saved by dmpPrepareUpload()
+ * @return Whether the memory updates have been written
+ * @see dmpInitialize()
+ */
+bool MPU6050::dmpConfigure(const int8_t *gyroOffsetTC) {
+    DEBUG_PRINTLN(F("Setting clock source to Z Gyro..."));
+    setClockSource(MPU6050_CLOCK_PLL_ZGYRO);
 
-            //DEBUG_PRINTLN(F("Setting X/Y/Z gyro user offsets to zero..."));
-            //setXGyroOffset(0);
-            //setYGyroOffset(0);
-            //setZGyroOffset(0);
+    DEBUG_PRINTLN(F("Setting DMP and FIFO_OFLOW interrupts enabled..."));
+    setIntEnabled(0x12);
 
-            DEBUG_PRINTLN(F("Writing final memory update 1/7 (function unknown)..."));
-            uint8_t dmpUpdate[16], j;
-            uint16_t pos = 0;
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting sample rate to 200Hz..."));
+    setRate(4); // 1khz / (1 + 4) = 200 Hz
 
-            DEBUG_PRINTLN(F("Writing final memory update 2/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting external frame sync to TEMP_OUT_L[0]..."));
+    setExternalFrameSync(MPU6050_EXT_SYNC_TEMP_OUT_L);
 
-            DEBUG_PRINTLN(F("Resetting FIFO..."));
-            resetFIFO();
+    DEBUG_PRINTLN(F("Setting DLPF bandwidth to 42Hz..."));
+    setDLPFMode(MPU6050_DLPF_BW_42);
 
-            DEBUG_PRINTLN(F("Reading FIFO count..."));
-            uint16_t fifoCount = getFIFOCount();
-            uint8_t fifoBuffer[128];
+    DEBUG_PRINTLN(F("Setting gyro sensitivity to +/- 2000 deg/sec..."));
+    setFullScaleGyroRange(MPU6050_GYRO_FS_2000);
 
-            DEBUG_PRINT(F("Current FIFO count="));
-            DEBUG_PRINTLN(fifoCount);
-            getFIFOBytes(fifoBuffer, fifoCount);
+    DEBUG_PRINTLN(F("Setting DMP configuration bytes (function unknown)..."));
+    setDMPConfig1(0x03);
+    setDMPConfig2(0x00);
 
-            DEBUG_PRINTLN(F("Setting motion detection threshold to 2..."));
-            setMotionDetectionThreshold(2);
+    DEBUG_PRINTLN(F("Clearing OTP Bank flag..."));
+    setOTPBankValid(false);
 
-            DEBUG_PRINTLN(F("Setting zero-motion detection threshold to 156..."));
-            setZeroMotionDetectionThreshold(156);
+    DEBUG_PRINTLN(F("Setting X/Y/Z gyro offset TCs to previous values..."));
+    setXGyroOffsetTC(gyroOffsetTC[0]);
+    setYGyroOffsetTC(gyroOffsetTC[1]);
+    setZGyroOffsetTC(gyroOffsetTC[2]);
 
-            DEBUG_PRINTLN(F("Setting motion detection duration to 80..."));
-            setMotionDetectionDuration(80);
+    //DEBUG_PRINTLN(F("Setting X/Y/Z gyro user offsets to zero..."));
+    //setXGyroOffset(0);
+    //setYGyroOffset(0);
+    //setZGyroOffset(0);
 
-            DEBUG_PRINTLN(F("Setting zero-motion detection duration to 0..."));
-            setZeroMotionDetectionDuration(0);
+    DEBUG_PRINTLN(F("Writing final memory update 1/7 (function unknown)..."));
+    if (!dmpWriteUpdate(1)) return false;
 
-            DEBUG_PRINTLN(F("Resetting FIFO..."));
-            resetFIFO();
+    DEBUG_PRINTLN(F("Writing final memory update 2/7 (function unknown)..."));
+    if (!dmpWriteUpdate(2)) return false;
 
-            DEBUG_PRINTLN(F("Enabling FIFO..."));
-            setFIFOEnabled(true);
+    DEBUG_PRINTLN(F("Resetting FIFO..."));
+    resetFIFO();
 
-            DEBUG_PRINTLN(F("Enabling DMP..."));
-            setDMPEnabled(true);
+    DEBUG_PRINTLN(F("Reading FIFO count..."));
+    dmpDrainFIFO();
 
-            DEBUG_PRINTLN(F("Resetting DMP..."));
-            resetDMP();
+    DEBUG_PRINTLN(F("Setting motion detection threshold to 2..."));
+    setMotionDetectionThreshold(2);
 
-            DEBUG_PRINTLN(F("Writing final memory update 3/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting zero-motion detection threshold to 156..."));
+    setZeroMotionDetectionThreshold(156);
 
-            DEBUG_PRINTLN(F("Writing final memory update 4/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting motion detection duration to 80..."));
+    setMotionDetectionDuration(80);
 
-            DEBUG_PRINTLN(F("Writing final memory update 5/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting zero-motion detection duration to 0..."));
+    setZeroMotionDetectionDuration(0);
 
-            DEBUG_PRINTLN(F("Waiting for FIFO count > 2..."));
-            while ((fifoCount = getFIFOCount()) < 3);
+    DEBUG_PRINTLN(F("Resetting FIFO..."));
+    resetFIFO();
 
-            DEBUG_PRINT(F("Current FIFO count="));
-            DEBUG_PRINTLN(fifoCount);
-            DEBUG_PRINTLN(F("Reading FIFO data..."));
-            getFIFOBytes(fifoBuffer, fifoCount);
+    DEBUG_PRINTLN(F("Enabling FIFO..."));
+    setFIFOEnabled(true);
 
-            DEBUG_PRINTLN(F("Reading interrupt status..."));
-            uint8_t mpuIntStatus = getIntStatus();
+    DEBUG_PRINTLN(F("Enabling DMP..."));
+    setDMPEnabled(true);
 
-            DEBUG_PRINT(F("Current interrupt status="));
-            DEBUG_PRINTLNF(mpuIntStatus, HEX);
+    DEBUG_PRINTLN(F("Resetting DMP..."));
+    resetDMP();
 
-            DEBUG_PRINTLN(F("Reading final memory update 6/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            readMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Writing final memory update 3/7 (function unknown)..."));
+    if (!dmpWriteUpdate(3)) return false;
 
-            DEBUG_PRINTLN(F("Waiting for FIFO count > 2..."));
-            while ((fifoCount = getFIFOCount()) < 3);
+    DEBUG_PRINTLN(F("Writing final memory update 4/7 (function unknown)..."));
+    if (!dmpWriteUpdate(4)) return false;
 
-            DEBUG_PRINT(F("Current FIFO count="));
-            DEBUG_PRINTLN(fifoCount);
+    DEBUG_PRINTLN(F("Writing final memory update 5/7 (function unknown)..."));
+    if (!dmpWriteUpdate(5)) return false;
+    return true;
+}
+/** Last steps of the DMP initialization, each once the running DMP has put
+ * MPU6050_DMP_SETTLE_FIFO_COUNT bytes into the FIFO: pass 1 reads the final memory
+ * update 6, pass 2 writes update 7, stops the DMP (you turn it on later) and writes the
+ * signature.
+ * @param pass Pass number (1 or 2)
+ * @return Whether the memory update has been written (pass 2)
+ * @see dmpInitialize()
+ */
+bool MPU6050::dmpFinishInitialize(uint8_t pass) {
+    DEBUG_PRINTLN(F("Reading FIFO data..."));
+    dmpDrainFIFO();
+
+    DEBUG_PRINTLN(F("Reading interrupt status..."));
+    uint8_t mpuIntStatus = getIntStatus();
+    DEBUG_PRINT(F("Current interrupt status="));
+    DEBUG_PRINTLNF(mpuIntStatus, HEX);
+    (void)mpuIntStatus;
+
+    if (pass == 1) {
+        DEBUG_PRINTLN(F("Reading final memory update 6/7 (function unknown)..."));
+        const unsigned char *readUpdate = dmpUpdates + pgm_read_byte(&dmpUpdateOffsets[5]);
+        uint8_t dmpUpdate[16];
+        readMemoryBlock(dmpUpdate, pgm_read_byte(readUpdate + 2), pgm_read_byte(readUpdate), pgm_read_byte(readUpdate + 1));
+        return true;
+    }
 
-            DEBUG_PRINTLN(F("Reading FIFO data..."));
-            getFIFOBytes(fifoBuffer, fifoCount);
+    DEBUG_PRINTLN(F("Writing final memory update 7/7 (function unknown)..."));
+    if (!dmpWriteUpdate(7)) return false;
 
-            DEBUG_PRINTLN(F("Reading interrupt status..."));
-            mpuIntStatus = getIntStatus();
+    DEBUG_PRINTLN(F("DMP is good to go! Finally."));
 
-            DEBUG_PRINT(F("Current interrupt status="));
-            DEBUG_PRINTLNF(mpuIntStatus, HEX);
+    DEBUG_PRINTLN(F("Disabling DMP (you turn it on later)..."));
+    setDMPEnabled(false);
 
-            DEBUG_PRINTLN(F("Writing final memory update 7/7 (function unknown)..."));
-            for (j = 0; j < 4 || j < dmpUpdate[2] + 3; j++, pos++) dmpUpdate[j] = pgm_read_byte(&dmpUpdates[pos]);
-            writeMemoryBlock(dmpUpdate + 3, dmpUpdate[2], dmpUpdate[0], dmpUpdate[1]);
+    DEBUG_PRINTLN(F("Setting up internal 42-byte (default) DMP packet buffer..."));
+    dmpPacketSize = 42;
+    dmpPacketContents = MPU6050_DMP_PACKET_DEFAULT;
+    /*if ((dmpPacketBuffer = (uint8_t *)malloc(42)) == 0) {
+        return 3; // TODO: proper error code for no memory
+    }*/
 
-            DEBUG_PRINTLN(F("DMP is good to go! Finally."));
+    DEBUG_PRINTLN(F("Resetting FIFO and clearing INT status one last time..."));
+    resetFIFO();
+    getIntStatus();
 
-            DEBUG_PRINTLN(F("Disabling DMP (you turn it on later)..."));
-            setDMPEnabled(false);
+    DEBUG_PRINTLN(F("Writing DMP signature..."));
+    dmpSetSignature(true);
+    return true;
+}
+/** Read and discard the bytes in the FIFO during the DMP initialization (at most
+ * the 128 bytes of the stack buffer, the FIFO has just been reset).
+ * @see dmpInitialize()
+ */
+void MPU6050::dmpDrainFIFO() {
+    uint8_t fifoBuffer[128];
+    uint16_t fifoCount = getFIFOCount();
+    DEBUG_PRINT(F("Current FIFO count="));
+    DEBUG_PRINTLN(fifoCount);
+    if (fifoCount > sizeof(fifoBuffer)) fifoCount = sizeof(fifoBuffer);
+    getFIFOBytes(fifoBuffer, fifoCount);
+}
 
-            DEBUG_PRINTLN(F("Setting up internal 42-byte (default) DMP packet buffer..."));
-            dmpPacketSize = 42;
-            /*if ((dmpPacketBuffer = (uint8_t *)malloc(42)) == 0) {
-                return 3; // TODO: proper error code for no memory
-            }*/
+/** Write one of the records of dmpUpdates[] to DMP memory. With MPU6050_DMP_FAST_UPLOAD
+ * the record takes the burst and checksum path of the configuration set, otherwise it is
+ * written and read back through writeMemoryBlock().
+ * @param update Record number (1 ~ 7; dmpInitialize() only reads record 6 back)
+ * @return Whether the record has been written (and verified)
+ */
+bool MPU6050::dmpWriteUpdate(uint8_t update) {
+    uint8_t start = pgm_read_byte(&dmpUpdateOffsets[update - 1]);
+    uint8_t size = pgm_read_byte(&dmpUpdateOffsets[update]) - start;
+    #ifdef MPU6050_DMP_FAST_UPLOAD
+        return writeProgDMPConfigurationSetBurst(dmpUpdates + start, size, MPU6050_DMP_FAST_UPLOAD_VERIFY);
+    #else
+        return writeProgDMPConfigurationSet(dmpUpdates + start, size);
+    #endif
+}
 
-            DEBUG_PRINTLN(F("Resetting FIFO and clearing INT status one last time..."));
-            resetFIFO();
-            getIntStatus();
-        } else {
-            DEBUG_PRINTLN(F("ERROR! DMP configuration verification failed."));
-            return 2; // configuration block loading failed
-        }
-    } else {
-        DEBUG_PRINTLN(F("ERROR! DMP code verification failed."));
-        return 1; // main binary block loading failed
-    }
-    return 0; // success
+/** Write or clear the signature of a configured DMP in spare DMP memory.
+ * @param valid Whether the signature is written (true) or cleared (false)
+ * @return Whether the signature has been written and verified
+ * @see dmpIsConfigured()
+ */
+bool MPU6050::dmpSetSignature(bool valid) {
+    uint8_t signature[MPU6050_DMP_SIGNATURE_SIZE] = MPU6050_DMP_SIGNATURE;
+    if (!valid) memset(signature, 0, MPU6050_DMP_SIGNATURE_SIZE);
+    return writeMemoryBurst(signature, MPU6050_DMP_SIGNATURE_SIZE, MPU6050_DMP_SIGNATURE_BANK, MPU6050_DMP_SIGNATURE_ADDRESS);
+}
+/** Check whether the DMP is already configured and running, e.g. after an MCU reset
+ * while the MPU stayed powered. Both the signature written by dmpInitialize() and a
+ * fingerprint of the registers it programs have to match, and the DMP must be enabled.
+ * @param gyroRange Gyro full scale range set after dmpInitialize() (MPU6050_GYRO_FS_*,
+ *                  dmpInitialize() itself leaves MPU6050_GYRO_FS_2000)
+ * @return Whether dmpInitialize() can be skipped
+ */
+bool MPU6050::dmpIsConfigured(uint8_t gyroRange) {
+    // register fingerprint (cheap, checked first)
+    if (!getDMPEnabled() || getSleepEnabled()) return false;
+    if (getClockSource() != MPU6050_CLOCK_PLL_ZGYRO) return false;
+    if (getIntEnabled() != 0x12) return false;
+    if (getRate() != 4) return false;
+    if (getDLPFMode() != MPU6050_DLPF_BW_42) return false;
+    if (getFullScaleGyroRange() != gyroRange) return false;
+    if (getDMPConfig1() != 0x03) return false;
+
+    // DMP memory signature
+    uint8_t expected[MPU6050_DMP_SIGNATURE_SIZE] = MPU6050_DMP_SIGNATURE;
+    uint8_t signature[MPU6050_DMP_SIGNATURE_SIZE];
+    readMemoryBlock(signature, MPU6050_DMP_SIGNATURE_SIZE, MPU6050_DMP_SIGNATURE_BANK, MPU6050_DMP_SIGNATURE_ADDRESS);
+    return memcmp(signature, expected, MPU6050_DMP_SIGNATURE_SIZE) == 0;
 }
 
 bool MPU6050::dmpPacketAvailable() {
     return getFIFOCount() >= dmpGetFIFOPacketSize();
 }
 
-// uint8_t MPU6050::dmpSetFIFORate(uint8_t fifoRate);
-// uint8_t MPU6050::dmpGetFIFORate();
+/** Set the DMP FIFO output rate, patching D_0_22 in DMP memory.
+ * DMP output frequency is 200Hz / (1 + fifoRate); it may be changed while the DMP runs.
+ * @param fifoRate Output rate divider (0 = 200Hz, 1 = 100Hz, 3 = 50Hz, ...)
+ * @return Status (0 = success, 1 = memory write failed)
+ */
+uint8_t MPU6050::dmpSetFIFORate(uint8_t fifoRate) {
+    uint8_t rate[2] = { 0x00, fifoRate };
+    if (!writeMemoryBlock(rate, 2, MPU6050_DMP_FIFO_RATE_BANK, MPU6050_DMP_FIFO_RATE_ADDRESS)) return 1;
+    return 0;
+}
+/** Get the DMP FIFO output rate divider from DMP memory.
+ * @return Output rate divider
+ * @see dmpSetFIFORate()
+ */
+uint8_t MPU6050::dmpGetFIFORate() {
+    uint8_t rate[2];
+    readMemoryBlock(rate, 2, MPU6050_DMP_FIFO_RATE_BANK, MPU6050_DMP_FIFO_RATE_ADDRESS);
+    return rate[1];
+}
+/** Select the optional blocks of the DMP FIFO packet, patching the inv_send_gyro and
+ * inv_send_accel FIFO constructors in DMP memory. A left out block is replaced with
+ * no-op instructions (0xA3) and the packet shrinks by 12 bytes. If a write fails, the
+ * blocks of the previous contents are written back so the packet size still matches
+ * DMP memory; if that fails as well, the signature is cleared so dmpIsConfigured()
+ * fails and the DMP has to be initialized again. The FIFO is reset in any case, so no
+ * packet of the previous layout is left over.
+ * @param contents Bitmask of MPU6050_DMP_PACKET_GYRO and MPU6050_DMP_PACKET_ACCEL
+ * @return Status (0 = success, 1 = memory write failed and the previous contents
+ *         restored, 2 = memory write failed and the packet layout is unknown)
+ */
+uint8_t MPU6050::dmpSetPacketContents(uint8_t contents) {
+    uint8_t status = 0;
+    if (dmpWritePacketBlocks(contents)) {
+        dmpPacketContents = contents & MPU6050_DMP_PACKET_DEFAULT;
+        dmpPacketSize = 18;
+        if (dmpPacketContents & MPU6050_DMP_PACKET_GYRO) dmpPacketSize += 12;
+        if (dmpPacketContents & MPU6050_DMP_PACKET_ACCEL) dmpPacketSize += 12;
+    } else if (dmpWritePacketBlocks(dmpPacketContents)) {
+        status = 1;
+    } else {
+        dmpSetSignature(false);
+        status = 2;
+    }
+    resetFIFO();
+    return status;
+}
+/** Write the FIFO constructor blocks of the optional packet contents to DMP memory.
+ * @param contents Bitmask of MPU6050_DMP_PACKET_GYRO and MPU6050_DMP_PACKET_ACCEL
+ * @return Whether both blocks have been written and verified
+ * @see dmpSetPacketContents()
+ */
+bool MPU6050::dmpWritePacketBlocks(uint8_t contents) {
+    const uint8_t sendBlock[4] = { 0xF1, 0x28, 0x30, 0x38 };
+    const uint8_t skipBlock[4] = { 0xA3, 0xA3, 0xA3, 0xA3 };
+    return writeMemoryBlock((contents & MPU6050_DMP_PACKET_GYRO) ? sendBlock : skipBlock, 4,
+            MPU6050_DMP_CFG_GYRO_BANK, MPU6050_DMP_CFG_GYRO_ADDRESS) &&
+        writeMemoryBlock((contents & MPU6050_DMP_PACKET_ACCEL) ? sendBlock : skipBlock, 4,
+            MPU6050_DMP_CFG_ACCEL_BANK, MPU6050_DMP_CFG_ACCEL_ADDRESS);
+}
+/** Get the optional blocks of the DMP FIFO packet.
+ * @return Bitmask of MPU6050_DMP_PACKET_GYRO and MPU6050_DMP_PACKET_ACCEL
+ * @see dmpSetPacketContents()
+ */
+uint8_t MPU6050::dmpGetPacketContents() {
+    return dmpPacketContents;
+}
 // uint8_t MPU6050::dmpGetSampleStepSizeMS();
 // uint8_t MPU6050::dmpGetSampleFrequency();
 // int32_t MPU6050::dmpDecodeTemperature(int8_t tempReg);
@@ -637,18 +861,19 @@ uint8_t MPU6050::dmpGetGravity(VectorFloat *v, Quaternion *q) {
 // uint8_t MPU6050::dmpGetEIS(long *data, const uint8_t* packet);
 
 uint8_t MPU6050::dmpGetEuler(float *data, Quaternion *q) {
-    data[0] = atan2(2*q -> x*q -> y - 2*q -> w*q -> z, 2*q -> w*q -> w + 2*q -> x*q -> x - 1);   // psi
-    data[1] = -asin(2*q -> x*q -> z + 2*q -> w*q -> y);                              // theta
-    data[2] = atan2(2*q -> y*q -> z - 2*q -> w*q -> x, 2*q -> w*q -> w + 2*q -> z*q -> z - 1);   // phi
+    // libm or the fast approximations, see MINIQUAD_FAST_MATH in Miniquad_fastmath.h
+    data[0] = AttitudeMath::atan2(2*q -> x*q -> y - 2*q -> w*q -> z, 2*q -> w*q -> w + 2*q -> x*q -> x - 1);   // psi
+    data[1] = -AttitudeMath::asin(2*q -> x*q -> z + 2*q -> w*q -> y);                              // theta
+    data[2] = AttitudeMath::atan2(2*q -> y*q -> z - 2*q -> w*q -> x, 2*q -> w*q -> w + 2*q -> z*q -> z - 1);   // phi
     return 0;
 }
 uint8_t MPU6050::dmpGetYawPitchRoll(float *data, Quaternion *q, VectorFloat *gravity) {
     // yaw: (about Z axis)
-    data[0] = atan2(2*q -> x*q -> y - 2*q -> w*q -> z, 2*q -> w*q -> w + 2*q -> x*q -> x - 1);
+    data[0] = AttitudeMath::atan2(2*q -> x*q -> y - 2*q -> w*q -> z, 2*q -> w*q -> w + 2*q -> x*q -> x - 1);
     // pitch: (nose up/down, about Y axis)
-    data[1] = atan(gravity -> x / sqrt(gravity -> y*gravity -> y + gravity -> z*gravity -> z));
+    data[1] = AttitudeMath::atan(gravity -> x / AttitudeMath::sqrt(gravity -> y*gravity -> y + gravity -> z*gravity -> z));
     // roll: (tilt left/right, about X axis)
-    data[2] = atan(gravity -> y / sqrt(gravity -> x*gravity -> x + gravity -> z*gravity -> z));
+    data[2] = AttitudeMath::atan(gravity -> y / AttitudeMath::sqrt(gravity -> x*gravity -> x + gravity -> z*gravity -> z));
     return 0;
 }
 
@@ -676,7 +901,7 @@ uint8_t MPU6050::dmpReadAndProcessFIFOPacket(uint8_t numPackets, uint8_t *proces
         if ((status = dmpProcessFIFOPacket(buf)) > 0) return status;
         
         // increment external process count variable, if supplied
-        if (processed != 0) *processed++;
+        if (processed != 0) (*processed)++;
     }
     return 0;
 }
@@ -693,5 +918,11 @@ uint8_t MPU6050::dmpReadAndProcessFIFOPacket(uint8_t numPackets, uint8_t *proces
 uint16_t MPU6050::dmpGetFIFOPacketSize() {
     return dmpPacketSize;
 }
+/** Get the time the last dmpInitialize() took to upload the DMP code and configuration.
+ * @return Upload time in microseconds
+ */
+uint32_t MPU6050::dmpGetUploadTime() {
+    return dmpUploadTime;
+}
 
 #endif /* _MPU6050_6AXIS_MOTIONAPPS20_H_ */
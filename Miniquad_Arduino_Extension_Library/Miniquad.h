@@ -7,6 +7,21 @@
 //                    David Qiu <david@davidqiu.com>
 //		- 2013.8.14 : MPU6050 DMP data refreshment program routine changed 
 //					  by David Qiu <david@davidqiu.com>
+//		- 2026.10.16 : Non-blocking DMP data acquisition added
+//		- 2026.10.16 : DMP FIFO burst draining and statistics added
+//		- 2026.10.16 : DMP sample record from a single FIFO packet added
+//		- 2026.10.16 : DMP output rate and packet contents configuration added
+//		- 2026.10.16 : DMP warm restart added
+//		- 2026.10.16 : Staged initialization added
+//		- 2026.10.16 : Raw sensor mode with onboard attitude estimator added
+//		- 2026.10.16 : Gyro propagation of the DMP attitude added
+//		- 2026.10.16 : Sensor bias calibration with EEPROM persistence added
+//		- 2026.10.16 : Fixed-point quaternion and derived attitude data added
+//		- 2026.10.16 : Fast math approximations for the attitude angles added
+//		- 2026.10.16 : Compile-time sensor full scale ranges added
+//		- 2026.10.16 : Rotation matrix cache for the derived attitude data added
+//		- 2026.10.16 : Dependency graph of the lazily calculated data added
+//		- 2026.10.16 : DMP packet validation and FIFO realignment added
 //
 // This is a standard library for the quadaxis copter "Miniquad" (C). The following 
 // functions are included:
@@ -26,21 +41,213 @@
 #include "I2Cdev.h"
 #include "MPU6050_6Axis_MotionApps20.h"
 #include "Miniquad_3dmath.h"
+#include "Miniquad_attitude.h"
+#include "Miniquad_fixmath.h"
+#include "Miniquad_fastmath.h"
+#include "Miniquad_units.h"
+#include "Miniquad_lazy.h"
 
 
 // Config: If the DMP data should be kept for calculation
 #define MINIQUAD_DMP_KEEP_DATA
 
+// Define: Derived DMP data (nodes of the lazy calculation, see Miniquad_lazy.h)
+#define MINIQUAD_OUTPUT_ROTATION (0x01)
+#define MINIQUAD_OUTPUT_ROTATION_MATRIX (0x02)
+#define MINIQUAD_OUTPUT_GRAVITY (0x04)
+#define MINIQUAD_OUTPUT_EULER_ANGLE (0x08)
+#define MINIQUAD_OUTPUT_YAW_PITCH_ROLL (0x10)
+#define MINIQUAD_OUTPUT_LINEAR_ACCELERATION (0x20)
+#define MINIQUAD_OUTPUT_WORLD_ACCELERATION (0x40)
+#define MINIQUAD_OUTPUT_ALL (0x7F)
+
+// Config: Derived DMP data the sketch uses (MINIQUAD_OUTPUT_*), the storage of the others is
+//         compiled out unless they are inputs of the used ones
+#define MINIQUAD_DMP_OUTPUTS (MINIQUAD_OUTPUT_ALL)
+
+// Config: If all the complete packets in the FIFO should be read at each refreshment
+#define MINIQUAD_DMP_DRAIN_FIFO
+
+// Config: If the gyro and acceleration should be averaged over the drained packets
+//#define MINIQUAD_DMP_AVERAGE_DATA
+
+// Config: If the rotation should be sent in the DMP packet instead of an extra register read
+#define MINIQUAD_DMP_FIFO_ROTATION
+
+// Config: Size of the DMP FIFO burst buffer in bytes (six default packets, at most 255). The
+//         packets in the FIFO are read in a single stream up to this size, the register address
+//         sent once (see I2Cdev::readStream()); a smaller buffer saves RAM at the cost of a
+//         burst more after a stall of the loop
+#define MINIQUAD_FIFO_BURST_SIZE (252)
+
+// Config: DMP FIFO output rate divider, the output frequency is 200Hz / (1 + divider)
+#define MINIQUAD_DMP_FIFO_RATE (1)
+
+// Config: Largest change of the rotation (degree/s) and of the acceleration (g) between two
+//         accepted DMP packets, a larger jump is rejected as a spike (0 disables the check)
+#define MINIQUAD_DMP_GYRO_SPIKE (1000)
+#define MINIQUAD_DMP_ACCEL_SPIKE (2)
+
+// Config: Count of consecutive spikes rejected before a jump is taken as a real change
+#define MINIQUAD_DMP_SPIKE_HOLD (2)
+
+// Config: Count of consecutive implausible DMP packets that cannot be realigned before the
+//         FIFO is reset
+#define MINIQUAD_DMP_RESYNC_LIMIT (3)
+
+// Averaging needs the rotation of every packet from the FIFO
+#if defined(MINIQUAD_DMP_AVERAGE_DATA) && !defined(MINIQUAD_DMP_FIFO_ROTATION)
+#define MINIQUAD_DMP_FIFO_ROTATION
+#endif
+
+// Define: DMP FIFO packet contents besides the quaternion (only what is used is sent)
+#ifdef MINIQUAD_DMP_FIFO_ROTATION
+#define MINIQUAD_DMP_PACKET_CONTENTS (MPU6050_DMP_PACKET_GYRO | MPU6050_DMP_PACKET_ACCEL) // 42 bytes
+#else
+#define MINIQUAD_DMP_PACKET_CONTENTS (MPU6050_DMP_PACKET_ACCEL) // 30 bytes
+#endif
+
+// Config: If the derived attitude data (gravity, angles, accelerations) is calculated in fixed
+//         point from the Q14 quaternion instead of in float
+//#define MINIQUAD_FIXED_POINT
+
+// Config: If the attitude is estimated onboard from the raw sensor data instead of the DMP
+//         (raw mode, the DMP firmware is not loaded)
+//#define MINIQUAD_RAW_MODE
+
+// Config: If the Madgwick filter is used as the raw mode estimator instead of the Mahony filter
+//#define MINIQUAD_RAW_MADGWICK
+
+// Config: Raw mode sample rate divider, the sample rate is 1kHz / (1 + divider)
+#define MINIQUAD_RAW_RATE_DIVIDER (1)
+
+// Config: Raw mode digital low pass filter of the MPU6050 (MPU6050_DLPF_BW_*)
+#define MINIQUAD_RAW_DLPF_MODE (MPU6050_DLPF_BW_98)
+
+// Define: Time for the MPU6050 to come out of reset before the raw mode setup (milliseconds)
+#define MINIQUAD_RAW_RESET_DELAY (50)
+
+// Config: Raw mode estimator gains
+#define MINIQUAD_RAW_MAHONY_KP (0.5f)
+#define MINIQUAD_RAW_MAHONY_KI (0.0f)
+#define MINIQUAD_RAW_MADGWICK_BETA (0.1f)
+
+// Define: Raw mode estimator
+#ifdef MINIQUAD_RAW_MADGWICK
+#define MINIQUAD_RAW_ESTIMATOR MadgwickEstimator
+#define MINIQUAD_RAW_ESTIMATOR_GAINS MINIQUAD_RAW_MADGWICK_BETA
+#else
+#define MINIQUAD_RAW_ESTIMATOR MahonyEstimator
+#define MINIQUAD_RAW_ESTIMATOR_GAINS MINIQUAD_RAW_MAHONY_KP, MINIQUAD_RAW_MAHONY_KI
+#endif // MINIQUAD_RAW_MADGWICK
+
+// Config: If the DMP attitude is propagated with the raw gyro between the DMP updates
+//#define MINIQUAD_DMP_PROPAGATE
+
+// Config: Minimum interval of the gyro propagation (microseconds, the gyro sample period)
+#define MINIQUAD_PROPAGATE_INTERVAL (1000)
+
+// Config: Default full scale range of the gyroscope (MPU6050_GYRO_FS_*, the DMP attitude is
+//         calibrated for 2000 degree/s, see BasicMiniquad for other ranges)
+#define MINIQUAD_GYRO_RANGE (MPU6050_GYRO_FS_2000)
+
+// Config: Default full scale range of the accelerometer (MPU6050_ACCEL_FS_*, the DMP attitude
+//         is calibrated for 2g)
+#ifdef MINIQUAD_RAW_MODE
+#define MINIQUAD_ACCEL_RANGE (MPU6050_ACCEL_FS_4)
+#else
+#define MINIQUAD_ACCEL_RANGE (MPU6050_ACCEL_FS_2)
+#endif // MINIQUAD_RAW_MODE
+
+// Define: Sensitivity shift of the sample acceleration (the DMP packet halves the sensitivity)
+#ifdef MINIQUAD_RAW_MODE
+#define MINIQUAD_ACCEL_SAMPLE_SHIFT (0)
+#else
+#define MINIQUAD_ACCEL_SAMPLE_SHIFT (1)
+#endif // MINIQUAD_RAW_MODE
+
+// The raw mode estimator runs at the gyro rate already
+#if defined(MINIQUAD_RAW_MODE) && defined(MINIQUAD_DMP_PROPAGATE)
+#undef MINIQUAD_DMP_PROPAGATE
+#endif
+
+// Config: If the sensor calibration is kept in the EEPROM and applied at initialization
+//         (the sketches have to include EEPROM.h as well, see Documents/ReadMe.txt)
+#define MINIQUAD_CALIBRATION_EEPROM
+
+// Config: EEPROM address of the sensor calibration record (15 bytes)
+#define MINIQUAD_CALIBRATION_ADDRESS (0)
+
+// Config: Count of the stationary samples averaged by the sensor calibration
+#define MINIQUAD_CALIBRATION_SAMPLES (500)
+
+// Config: Largest rotation tolerated as stationary during the sensor calibration (degree/s)
+#define MINIQUAD_CALIBRATION_MOTION_LIMIT (5)
+
+#ifdef MINIQUAD_CALIBRATION_EEPROM
+#include "EEPROM.h"
+#endif // MINIQUAD_CALIBRATION_EEPROM
+
+// Config: I2C bus rate of the MPU6050 (I2CDEV_CLOCK_*, Hz), the FIFO bursts of the refreshment
+//         take about a quarter of the 100kHz time at 400kHz
+#define MINIQUAD_I2C_CLOCK (I2CDEV_CLOCK_FAST)
+
+// Config: If the I2C bus rate is probed at the connection, stepping down from MINIQUAD_I2C_CLOCK
+//         when the MPU6050 fails to answer reliably (comment out to set the rate unchecked)
+#define MINIQUAD_I2C_CLOCK_PROBE
+
+// Config: Attempts of an initialization stage before the initialization fails
+#define MINIQUAD_INIT_RETRIES (5)
+
+// Config: Time to wait for the first DMP data in an attempt (milliseconds)
+#define MINIQUAD_INIT_DATA_TIMEOUT (500)
+
+// Define: Miniquad initialization stages
+#define MINIQUAD_INIT_IDLE (0)
+#define MINIQUAD_INIT_PROPELLERS (1)
+#define MINIQUAD_INIT_CONNECT (2)
+#define MINIQUAD_INIT_DMP_LOAD (3)
+#define MINIQUAD_INIT_DMP_START (4)
+#define MINIQUAD_INIT_FIRST_DATA (5)
+#define MINIQUAD_INIT_DONE (6)
+#define MINIQUAD_INIT_FAILED (7)
+#define MINIQUAD_INIT_STAGES (8)
+
+// Define: Steps of the DMP loading stage (a memory bank or a configuration record per step)
+#define MINIQUAD_DMP_LOAD_RESET (0)
+#define MINIQUAD_DMP_LOAD_PREPARE (1)
+#define MINIQUAD_DMP_LOAD_CODE (2)
+#define MINIQUAD_DMP_LOAD_CONFIG (3)
+#define MINIQUAD_DMP_LOAD_CONFIGURE (4)
+#define MINIQUAD_DMP_LOAD_SETTLE (5)
+#define MINIQUAD_DMP_LOAD_DONE (6)
+
+// Define: Miniquad initialization errors (1 ~ 15 are the errors of MPU6050::dmpInitialize())
+#define MINIQUAD_INIT_ERROR_NONE (0)
+#define MINIQUAD_INIT_ERROR_CONNECTION (16)
+#define MINIQUAD_INIT_ERROR_DMP_SETUP (17)
+#define MINIQUAD_INIT_ERROR_NO_DATA (18)
+#define MINIQUAD_INIT_ERROR_RAW_SETUP (19)
+
+// Define: Sensor calibration record in the EEPROM (magic, 6 offsets, checksum)
+#define MINIQUAD_CALIBRATION_MAGIC0 ('M')
+#define MINIQUAD_CALIBRATION_MAGIC1 ('C')
+#define MINIQUAD_CALIBRATION_RECORD_SIZE (15)
+
 // Define: Miniquad-MPU6050 interrupt pin
 #define MPU6050_INT_PIN (0)
 
-// Define: MPU6050 sensor detection data transformation units and skewing
-#define MPU6050_ACCELERATION_UNIT (16384.0f) // AFS_0: ([+-RawAccel] / (65536(int16)/2)) * 2g  ==>  65536/4 = 16384 per g
-#define MPU6050_ROTATION_UNIT (131.0f) // FS_0: ([+-RawRotation] / (65536(int16)/2)) * 250 degree/s ==>  131 per degree/s
+// Define: MPU6050 sensor detection data transformation units and skewing (the rotation and
+//         acceleration units depend on the full scale ranges, see Miniquad_units.h)
 #define MPU6050_QUATERNION_UNIT (16384.0f) // Quaternion conversion unit
-#define MPU6050_GRAVITY_UNIT (8192.0f) // Gravity conversion unit
+#define MPU6050_GRAVITY_UNIT (8192.0f) // Gravity conversion unit (Q13 acceleration, 8192 per g)
+#define MPU6050_QUATERNION_SCALE (1.0f / MPU6050_QUATERNION_UNIT) // Q14 to float, multiplied instead of divided
+#define MPU6050_GRAVITY_SCALE (1.0f / MPU6050_GRAVITY_UNIT) // Q13 to float, multiplied instead of divided
 #define MPU6050_TEMPERATURE_UNIT (340.0f) // 65536 / Range([RawTemp]) = 340 per degree Celsius
 #define MPU6050_TEMPERATURE_SKEWING (-12412.0f) // -512 - (340 * 35) = -12412  <=>  0 degree Celsius
+#define MPU6050_QUATERNION_MAGNITUDE_MIN (((uint32_t)1 << 28) / 100 * 81) // Q28 of 0.9^2
+#define MPU6050_QUATERNION_MAGNITUDE_MAX (((uint32_t)1 << 28) / 100 * 121) // Q28 of 1.1^2
+#define MPU6050_QUATERNION_CONSISTENCY_MIN (((int32_t)1 << 28) / 100 * 90) // Q28 of 0.9, a turn of 52 degree
 
 // Define: Propellers
 #define PROPELLER1 (3)
@@ -53,8 +260,13 @@
 #define PPL4 PROPELLER4
 
 
+// Define: Compiler memory barrier keeping the published DMP sample in order with its sequence
+#define MINIQUAD_MEMORY_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+
 // Global: MPU6050 interrupt (INT 1)
-// @Function:		Signal that the DMP module of MPU6050 is ready
+// @Function:		Signal that the DMP module of MPU6050 is ready. It only marks the work
+//					pending; the FIFO is read later by Miniquad::TryRefreshDmpData().
 // @Contributor:	David Qiu (2013.7.1)
 volatile bool MpuInterrupt = false; // Indicates whether MPU interrupt pin has gone high
 void MpuDataReady()
@@ -63,32 +275,204 @@ void MpuDataReady()
 }
 
 
-// Class: Quadaxis copter "Miniquad"
-class Miniquad
+// Struct: Statistics of the DMP FIFO draining
+struct MiniquadFifoStatistics
+{
+	uint32_t packets;		// Count of the packets read from the FIFO
+	uint32_t dropped;		// Count of the packets thrown away (invalid or lost in FIFO resets)
+	uint16_t resets;		// Count of the FIFO resets
+	uint16_t overflows;		// Count of the FIFO overflows signalled by the MPU6050
+	uint16_t rejected;		// Count of the implausible packets (quaternion off the unit sphere, spikes)
+	uint16_t realigned;		// Count of the realignments of a FIFO read from the wrong offset
+};
+
+
+// Struct: Offsets of the MPU6050 sensors (values of the XA_OFFS_* and XG_OFFS_USR* registers)
+struct MiniquadCalibration
+{
+	int16_t accelOffset[3];		// The accelerometer offsets (2048 per g, bit 0 reserved)
+	int16_t gyroOffset[3];		// The gyroscope offsets (32.8 per degree/s)
+};
+
+
+// Struct: A DMP sample of the MPU6050 with all the data taken from the same FIFO packet
+struct MiniquadSample
+{
+	Quaternion quaternion;		// The quaternion (DMP)
+	VectorInt16 rotation;		// The raw Int16-form rotation (gyro)
+	VectorInt16 acceleration;	// The raw Int16-form acceleration
+	uint32_t timestamp;			// The time the packet has been read from the FIFO (micros)
+	uint16_t sequence;			// The sequence number of the sample
+};
+
+
+// Class: Quadaxis copter "Miniquad" with the full scale ranges of the gyroscope
+//        (MPU6050_GYRO_FS_*) and the accelerometer (MPU6050_ACCEL_FS_*), programmed at
+//        initialization. The DMP attitude expects 2000 degree/s and 2g, other ranges only
+//        suit the raw mode or the raw sensor data.
+template <uint8_t GyroRange = MINIQUAD_GYRO_RANGE, uint8_t AccelRange = MINIQUAD_ACCEL_RANGE>
+class BasicMiniquad
 {
 public:
+	typedef MiniquadGyroUnit<GyroRange> GyroUnit;		// The rotation units
+	typedef MiniquadAccelUnit<AccelRange, MINIQUAD_ACCEL_SAMPLE_SHIFT> AccelUnit;	// The sample acceleration units
 
-	// @Params:			(void)
-	// @Return:			(void)
-	// @Function:		Initialize the quadaxis copter.
+	// @Params:			forceColdStart: Whether the DMP is initialized even if it is already running
+	// @Return:			A bool indicating whether the initialization has succeeded
+	// @Function:		Initialize the quadaxis copter, stepping all the initialization stages until
+	//					done or failed (blocking). If the MPU6050 stayed powered over an MCU reset and
+	//					its DMP is still configured, the DMP initialization and firmware upload are
+	//					skipped (warm start) unless a cold start is forced.
 	// @Contributor:	David Qiu (2013.6.30)
-	void Initialize()
+	bool Initialize(bool forceColdStart = false)
 	{
-		// Initialize the propeller motors
-		pinMode(PROPELLER1, OUTPUT); analogWrite(PROPELLER1, 0);
-		pinMode(PROPELLER2, OUTPUT); analogWrite(PROPELLER2, 0);
-		pinMode(PROPELLER3, OUTPUT); analogWrite(PROPELLER3, 0);
-		pinMode(PROPELLER4, OUTPUT); analogWrite(PROPELLER4, 0);
+		BeginInitialize(forceColdStart);
+		while (StepInitialize() < MINIQUAD_INIT_DONE) {;}
+		return (_initStage == MINIQUAD_INIT_DONE);
+	}
 
-		// Initialize the MPU6050
-		Wire.begin();
-		_mpu.initialize();
-		while(!_mpu.testConnection()) {;} // Stop: if MPU6050 connect failed
+	// @Params:			forceColdStart: Whether the DMP is initialized even if it is already running
+	// @Return:			(void)
+	// @Function:		Start the staged initialization of the quadaxis copter, which is then carried
+	//					on by StepInitialize() from the loop of the sketch.
+	void BeginInitialize(bool forceColdStart = false)
+	{
+		_initStage = MINIQUAD_INIT_IDLE;
+		_initStageStart = millis();
+		_initForceColdStart = forceColdStart;
+		_initError = MINIQUAD_INIT_ERROR_NONE;
+		_initErrorStage = MINIQUAD_INIT_IDLE;
+		_calibrated = false;
+		for (uint8_t i = 0; i < MINIQUAD_INIT_STAGES; i++) _initStageTime[i] = 0;
 
-		// Initialize DMP for MPU6050
-		switch (_mpu.dmpInitialize())
+		// Forget the samples and the packet references of a previous initialization
+		_sampleNumber = 0;
+		_packetReference = false;
+		_packetSpikeRun = 0;
+		_packetInvalidRun = 0;
+		_packetAcceleration = VectorInt16();
+		_packetRotation = VectorInt16();
+		_enterInitStage(MINIQUAD_INIT_PROPELLERS);
+	}
+
+	// @Params:			(void)
+	// @Return:			An uint8_t indicating the current initialization stage (MINIQUAD_INIT_*)
+	// @Function:		Carry on the staged initialization by one step. A stage failing more than
+	//					MINIQUAD_INIT_RETRIES times stops the initialization at MINIQUAD_INIT_FAILED.
+	//					The DMP loading stage takes many steps, each writing one memory bank of the
+	//					firmware or one configuration record, and waits without blocking.
+	uint8_t StepInitialize()
+	{
+		uint8_t status;
+
+		switch (_initStage)
 		{
-		case 0: // Initialization successful
+		case MINIQUAD_INIT_PROPELLERS:
+			// Initialize the propeller motors
+			pinMode(PROPELLER1, OUTPUT); analogWrite(PROPELLER1, 0);
+			pinMode(PROPELLER2, OUTPUT); analogWrite(PROPELLER2, 0);
+			pinMode(PROPELLER3, OUTPUT); analogWrite(PROPELLER3, 0);
+			pinMode(PROPELLER4, OUTPUT); analogWrite(PROPELLER4, 0);
+			_enterInitStage(MINIQUAD_INIT_CONNECT);
+			break;
+
+		case MINIQUAD_INIT_CONNECT:
+			// Connect the MPU6050
+			Wire.begin();
+		#ifdef MINIQUAD_I2C_CLOCK_PROBE
+			if (I2Cdev::probeClock(MPU6050_DEFAULT_ADDRESS, MPU6050_RA_WHO_AM_I, MINIQUAD_I2C_CLOCK) == 0)
+			{
+				_retryInitStage(MINIQUAD_INIT_ERROR_CONNECTION);
+				break;
+			}
+		#else
+			I2Cdev::setClock(MINIQUAD_I2C_CLOCK);
+		#endif // MINIQUAD_I2C_CLOCK_PROBE
+			if (!_mpu.testConnection())
+			{
+				_retryInitStage(MINIQUAD_INIT_ERROR_CONNECTION);
+				break;
+			}
+
+			// Skip the DMP initialization if the DMP is still running (warm start)
+		#ifdef MINIQUAD_RAW_MODE
+			_dmpWarmStart = false; // the raw sensors are set up at every start
+		#else
+			_dmpWarmStart = !_initForceColdStart && _mpu.dmpIsConfigured(GyroRange);
+		#endif // MINIQUAD_RAW_MODE
+			if (_dmpWarmStart)
+			{
+				_mpu.dmpUploadTime = 0;
+				_enterInitStage(MINIQUAD_INIT_DMP_START);
+			}
+			else
+			{
+				_dmpLoadStep = MINIQUAD_DMP_LOAD_RESET;
+				_enterInitStage(MINIQUAD_INIT_DMP_LOAD);
+			}
+			break;
+
+		case MINIQUAD_INIT_DMP_LOAD:
+		#ifdef MINIQUAD_RAW_MODE
+			// Reset the MPU6050 (stopping a DMP left running), then initialize it for the raw
+			// sensor data instead of the DMP once it is out of reset
+			if (_dmpLoadStep == MINIQUAD_DMP_LOAD_RESET)
+			{
+				_mpu.reset();
+				_dmpLoadWait = millis();
+				_dmpLoadStep = MINIQUAD_DMP_LOAD_PREPARE;
+				break;
+			}
+			if (millis() - _dmpLoadWait < MINIQUAD_RAW_RESET_DELAY) break;
+			if (!_initializeRawSensors())
+			{
+				_dmpLoadStep = MINIQUAD_DMP_LOAD_RESET; // the next attempt starts over
+				_retryInitStage(MINIQUAD_INIT_ERROR_RAW_SETUP);
+				break;
+			}
+			_enterInitStage(MINIQUAD_INIT_DMP_START);
+			break;
+		#endif // MINIQUAD_RAW_MODE
+
+			// Initialize the MPU6050 and load the DMP firmware, a step at a time
+			status = _stepDMPLoad();
+			if (status != MINIQUAD_INIT_ERROR_NONE)
+			{
+				_dmpLoadStep = MINIQUAD_DMP_LOAD_RESET; // the next attempt starts over
+				_retryInitStage(status);
+				break;
+			}
+			if (_dmpLoadStep == MINIQUAD_DMP_LOAD_DONE) _enterInitStage(MINIQUAD_INIT_DMP_START);
+			break;
+
+		case MINIQUAD_INIT_DMP_START:
+		#ifdef MINIQUAD_CALIBRATION_EEPROM
+			// Apply the persisted sensor calibration before the data flows
+			LoadCalibration();
+		#endif // MINIQUAD_CALIBRATION_EEPROM
+
+		#ifdef MINIQUAD_RAW_MODE
+			// Start the estimator from the identity attitude
+			_estimator = MINIQUAD_RAW_ESTIMATOR(MINIQUAD_RAW_ESTIMATOR_GAINS);
+			_rawLastUpdate = micros();
+
+			// Enable Arduino interrupt detection (data ready)
+			attachInterrupt(MPU6050_INT_PIN, MpuDataReady, RISING);
+			_mpu.getIntStatus(); // clear the pending interrupt
+			memset(&_fifoStatistics, 0, sizeof(_fifoStatistics));
+			_enterInitStage(MINIQUAD_INIT_FIRST_DATA);
+			break;
+		#endif // MINIQUAD_RAW_MODE
+
+			// Set the full scale ranges, the DMP output rate and packet contents (this resets the FIFO)
+			if (!_setFullScaleRanges() || 
+				_mpu.dmpSetFIFORate(MINIQUAD_DMP_FIFO_RATE) != 0 || 
+				_mpu.dmpSetPacketContents(MINIQUAD_DMP_PACKET_CONTENTS) != 0)
+			{
+				_retryInitStage(MINIQUAD_INIT_ERROR_DMP_SETUP);
+				break;
+			}
+
 			// Turn on the DMP
 			_mpu.setDMPEnabled(true);
 
@@ -96,22 +480,66 @@ public:
 			attachInterrupt(MPU6050_INT_PIN, MpuDataReady, RISING);
 			_mpu.getIntStatus(); // ? test interrupt
 
-			// Get expected DMP packet size for later comparison
-			_mpuFIFOPacketSize = _mpu.dmpGetFIFOPacketSize();
+			// Get expected DMP packet size and layout for later comparison (the FIFO has been reset)
+			_refreshDMPPacketLayout();
+			_mpuFIFOCount = 0;
+			_packetInvalidRun = 0;
+			memset(&_fifoStatistics, 0, sizeof(_fifoStatistics));
+			_enterInitStage(MINIQUAD_INIT_FIRST_DATA);
+			break;
 
+		case MINIQUAD_INIT_FIRST_DATA:
 			// Get the first set of data
-			_refreshDMPData();
-			break;
-		case 1: // Initial memory load failed
-			while (true) {;}
-			break;
-		case 2: // DMP configuration updates failed
-			while (true) {;}
+			if (_tryRefreshData())
+			{
+				_enterInitStage(MINIQUAD_INIT_DONE);
+			}
+			else if (millis() - _initAttemptStart > MINIQUAD_INIT_DATA_TIMEOUT)
+			{
+				_retryInitStage(MINIQUAD_INIT_ERROR_NO_DATA);
+			}
 			break;
-		default: // Unexpected exception
-			while (true) {;}
+
+		default: // Idle, done or failed
 			break;
 		}
+
+		return _initStage;
+	}
+
+	// @Params:			(void)
+	// @Return:			An uint8_t indicating the current initialization stage (MINIQUAD_INIT_*)
+	// @Function:		Get the stage of the staged initialization.
+	uint8_t GetInitStage()
+	{
+		return _initStage;
+	}
+
+	// @Params:			stage: The initialization stage (MINIQUAD_INIT_PROPELLERS ~ MINIQUAD_INIT_FIRST_DATA)
+	// @Return:			An unsigned long indicating the time spent in the stage (milliseconds)
+	// @Function:		Get the elapsed time of an initialization stage, up to now if it is running.
+	uint32_t GetInitStageTime(uint8_t stage)
+	{
+		if (stage >= MINIQUAD_INIT_STAGES) return 0;
+		if (stage == _initStage) return millis() - _initStageStart;
+		return _initStageTime[stage];
+	}
+
+	// @Params:			(void)
+	// @Return:			An uint8_t indicating the last initialization error (MINIQUAD_INIT_ERROR_*)
+	// @Function:		Get the last error of the staged initialization, which is kept after a 
+	//					successful retry. See GetInitErrorStage() for the stage of the error.
+	uint8_t GetInitError()
+	{
+		return _initError;
+	}
+
+	// @Params:			(void)
+	// @Return:			An uint8_t indicating the stage of the last initialization error (MINIQUAD_INIT_*)
+	// @Function:		Get the stage in which the last initialization error occurred.
+	uint8_t GetInitErrorStage()
+	{
+		return _initErrorStage;
 	}
 
 
@@ -152,13 +580,329 @@ public:
 
 	// @Params:			(void)
 	// @Return:			(void)
-	// @Function:		Refresh the DMP necessary data of the quad copter
+	// @Function:		Refresh the DMP necessary data of the quad copter (blocking). In the raw mode
+	//					the data is estimated from the raw sensor data instead.
 	// @Contributor:	David Qiu (2013.7.10)
 	void RefreshDmpData()
 	{
 		_refreshDMPData();
 	}
 
+	// @Params:			(void)
+	// @Return:			A bool indicating whether a new DMP sample has been obtained
+	// @Function:		Refresh the DMP necessary data of the quad copter if the MPU6050 has
+	//					signalled new data, otherwise return immediately (non-blocking).
+	bool TryRefreshDmpData()
+	{
+		return _tryRefreshData();
+	}
+
+	// @Params:			divider: The DMP output rate divider, the output frequency is 200Hz / (1 + divider)
+	// @Return:			A bool indicating whether the DMP memory has been patched successfully
+	// @Function:		Set the output rate of the DMP at runtime.
+	bool SetDmpOutputRate(uint8_t divider)
+	{
+		return (_mpu.dmpSetFIFORate(divider) == 0);
+	}
+
+	// @Params:			contents: The bitmask of MPU6050_DMP_PACKET_GYRO and MPU6050_DMP_PACKET_ACCEL
+	// @Return:			A bool indicating whether the DMP memory has been patched successfully
+	// @Function:		Set the contents of the DMP FIFO packet besides the quaternion at runtime. The
+	//					rotation is read from the MPU6050 registers if it is not in the packet, and the
+	//					acceleration is zero if it is not in the packet. The FIFO is reset. If the DMP
+	//					memory is left in an unknown state, the initialization fails (GetInitStage()
+	//					returns MINIQUAD_INIT_FAILED) and the next Initialize() reloads the DMP.
+	bool SetDmpPacketContents(uint8_t contents)
+	{
+		uint8_t status = _mpu.dmpSetPacketContents(contents);
+		if (status == 0) _refreshDMPPacketLayout(); // the previous layout is kept otherwise
+
+		// The FIFO has been reset
+		_mpuFIFOCount = 0;
+		_packetInvalidRun = 0;
+
+		if (status == 2)
+		{
+			// The packet layout is unknown, the DMP has to be initialized again
+			_initError = MINIQUAD_INIT_ERROR_DMP_SETUP;
+			_initErrorStage = _initStage;
+			_enterInitStage(MINIQUAD_INIT_FAILED);
+		}
+		return (status == 0);
+	}
+
+	// @Params:			sample: The container for the latest sample
+	// @Return:			A bool indicating whether the sample has been copied (false only when called
+	//					from an interrupt which preempted a refreshment in progress)
+	// @Function:		Copy the latest published DMP sample, never mixing two different samples.
+	bool GetDmpSample(MiniquadSample& sample)
+	{
+		uint8_t sequence;
+		do
+		{
+			// Odd sequence means the publisher has been preempted in the middle of its update
+			sequence = _sampleSequence;
+			if (sequence & 0x01) return false;
+			MINIQUAD_MEMORY_BARRIER();
+
+			// Copy the sample
+			sample.quaternion = _quaternion;
+			sample.rotation = _rot_Int16_raw;
+			sample.acceleration = _accel_Int16_raw;
+			sample.timestamp = _sampleTimestamp;
+			sample.sequence = _sampleNumber;
+			MINIQUAD_MEMORY_BARRIER();
+		} while (sequence != _sampleSequence); // retry if a new sample has been published meanwhile
+
+		return true;
+	}
+
+	// @Params:			quaternion: The container for the quaternion of the latest sample
+	//					acceleration: The container for the raw Int16-form acceleration of the latest sample
+	//					rotation: The container for the raw Int16-form rotation of the latest sample
+	// @Return:			A bool indicating whether the snapshot has been taken (false only when called
+	//					from an interrupt which preempted a refreshment in progress)
+	// @Function:		Copy the latest published DMP sample, never mixing two different samples.
+	bool GetDmpSnapshot(Quaternion& quaternion, VectorInt16& acceleration, VectorInt16& rotation)
+	{
+		MiniquadSample sample;
+		if (!GetDmpSample(sample)) return false;
+
+		quaternion = sample.quaternion;
+		acceleration = sample.acceleration;
+		rotation = sample.rotation;
+		return true;
+	}
+
+	// @Params:			(void)
+	// @Return:			A MiniquadFifoStatistics& (!Reference) indicating the statistics of the DMP FIFO
+	// @Function:		Get the counts of packets read, dropped, rejected and of FIFO resets,
+	//					overflows and realignments.
+	MiniquadFifoStatistics& GetFifoStatistics()
+	{
+		return _fifoStatistics;
+	}
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the last initialization has been a warm start
+	// @Function:		Check if the DMP firmware upload has been skipped at initialization.
+	bool IsDmpWarmStart()
+	{
+		return _dmpWarmStart;
+	}
+
+	// @Params:			(void)
+	// @Return:			An unsigned long indicating the DMP upload time (microseconds, 0 on warm start)
+	// @Function:		Get the time the DMP code and configuration upload took at initialization.
+	uint32_t GetDmpUploadTime()
+	{
+		return _mpu.dmpGetUploadTime();
+	}
+
+	// @Params:			(void)
+	// @Return:			An unsigned long indicating the I2C bus rate (Hz)
+	// @Function:		Get the I2C bus rate of the MPU6050, the one the connection probe settled on
+	//					with MINIQUAD_I2C_CLOCK_PROBE.
+	uint32_t GetBusClock()
+	{
+		return I2Cdev::getClock();
+	}
+
+#ifdef MINIQUAD_DMP_PROPAGATE
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the attitude has been propagated
+	// @Function:		Read the raw gyro and propagate the last DMP attitude to now. It returns
+	//					false without reading if called within MINIQUAD_PROPAGATE_INTERVAL of the
+	//					last propagation. Call it from the inner control loop, between refreshments.
+	bool PropagateAttitude()
+	{
+		uint32_t now = micros();
+		if (now - _propagateLast < MINIQUAD_PROPAGATE_INTERVAL) return false;
+
+		// Read the gyro
+		VectorInt16 rotReader;
+		_mpu.getRotation(&(rotReader.x), &(rotReader.y), &(rotReader.z));
+		float dt = (now - _propagateLast) * 1e-6f;
+		_propagateLast = now;
+
+		// Rotate the propagated attitude (gyro in rad/s)
+		const float rotationScale = GyroUnit::radianPerLsb();
+		_propagator.Update(rotReader.x * rotationScale, rotReader.y * rotationScale, rotReader.z * rotationScale, dt);
+		return true;
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quaternion& (!Reference) indicating the propagated attitude of the quad copter
+	// @Function:		Get the DMP attitude propagated with the raw gyro to the last call of
+	//					PropagateAttitude(). It is resynchronized with every new DMP sample.
+	Quaternion& GetPropagatedQuaternion()
+	{
+		return _propagator.GetQuaternion();
+	}
+
+	// @Params:			(void)
+	// @Return:			An unsigned long indicating the age of the DMP attitude anchor (microseconds)
+	// @Function:		Get the time since the DMP sample the propagated attitude is anchored to.
+	uint32_t GetAnchorAge()
+	{
+		return micros() - _sampleTimestamp;
+	}
+#endif // MINIQUAD_DMP_PROPAGATE
+
+	// @Params:			samples: Count of the samples averaged
+	// @Return:			A bool indicating whether the calibration has succeeded (false if the copter
+	//					has moved during the calibration)
+	// @Function:		Calibrate the gyroscope and accelerometer biases (blocking, takes about
+	//					2ms per sample). The copter has to stand still and level. The offset
+	//					registers are corrected so that the rotation reads 0 and the acceleration
+	//					reads 1g on the z-axis, and the offsets are persisted in the EEPROM. The FIFO
+	//					is reset afterwards.
+	bool CalibrateSensors(uint16_t samples = MINIQUAD_CALIBRATION_SAMPLES)
+	{
+		// The offset registers do not depend on the full scale ranges, the samples do
+		const uint8_t gyroRange = GyroRange;
+		const uint8_t accelRange = AccelRange;
+		int16_t motionLimit = (int16_t)((MINIQUAD_CALIBRATION_MOTION_LIMIT * 131) >> gyroRange);
+
+		// Average the stationary samples
+		int32_t accelSum[3] = { 0, 0, 0 };
+		int32_t gyroSum[3] = { 0, 0, 0 };
+		int16_t gyroMin[3] = { 32767, 32767, 32767 };
+		int16_t gyroMax[3] = { -32768, -32768, -32768 };
+		for (uint16_t i = 0; i < samples; i++)
+		{
+			int16_t a[3], g[3];
+			_mpu.getMotion6(&a[0], &a[1], &a[2], &g[0], &g[1], &g[2]);
+			for (uint8_t axis = 0; axis < 3; axis++)
+			{
+				accelSum[axis] += a[axis];
+				gyroSum[axis] += g[axis];
+				if (g[axis] < gyroMin[axis]) gyroMin[axis] = g[axis];
+				if (g[axis] > gyroMax[axis]) gyroMax[axis] = g[axis];
+			}
+			delay(2); // wait for a new sensor sample
+		}
+		for (uint8_t axis = 0; axis < 3; axis++)
+		{
+			if (gyroMax[axis] - gyroMin[axis] > 2 * motionLimit) return false;
+		}
+
+		// Expect 1g on the z-axis when level
+		accelSum[2] -= (int32_t)samples * (16384 >> accelRange);
+
+		// Correct the offsets, scaled from the full scale ranges to 2048 per g and 32.8 per degree/s
+		MiniquadCalibration calibration;
+		_getSensorOffsets(calibration);
+		for (uint8_t axis = 0; axis < 3; axis++)
+		{
+			int32_t accelMean = accelSum[axis] / (int32_t)samples;
+			int32_t gyroMean = gyroSum[axis] / (int32_t)samples;
+			int16_t accelOffset = calibration.accelOffset[axis] - (int16_t)(accelMean * (1 << accelRange) / 8);
+			calibration.accelOffset[axis] = (accelOffset & ~1) | (calibration.accelOffset[axis] & 1); // keep bit 0
+			calibration.gyroOffset[axis] -= (int16_t)(gyroMean * (1 << gyroRange) / 4);
+		}
+		_setSensorOffsets(calibration);
+		_calibration = calibration;
+		_calibrated = true;
+
+		// Drop the data measured during the calibration
+		_mpu.resetFIFO();
+		_mpuFIFOCount = 0;
+
+	#ifdef MINIQUAD_CALIBRATION_EEPROM
+		SaveCalibration();
+	#endif // MINIQUAD_CALIBRATION_EEPROM
+		return true;
+	}
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the sensor offsets are calibrated
+	// @Function:		Check if the sensor offsets have been calibrated or loaded from the EEPROM.
+	bool IsCalibrated()
+	{
+		return _calibrated;
+	}
+
+	// @Params:			(void)
+	// @Return:			A MiniquadCalibration& (!Reference) indicating the sensor offsets in use
+	// @Function:		Get the sensor offsets of the last calibration or EEPROM load.
+	MiniquadCalibration& GetCalibration()
+	{
+		return _calibration;
+	}
+
+	// @Params:			calibration: The sensor offsets
+	// @Return:			(void)
+	// @Function:		Apply sensor offsets (e.g. measured on another run) to the MPU6050.
+	void SetCalibration(const MiniquadCalibration& calibration)
+	{
+		_setSensorOffsets(calibration);
+		_calibration = calibration;
+		_calibrated = true;
+	}
+
+#ifdef MINIQUAD_CALIBRATION_EEPROM
+	// @Params:			(void)
+	// @Return:			A bool indicating whether a valid calibration has been found and applied
+	// @Function:		Load the sensor offsets from the EEPROM and apply them to the MPU6050.
+	bool LoadCalibration()
+	{
+		uint8_t record[MINIQUAD_CALIBRATION_RECORD_SIZE];
+		for (uint8_t i = 0; i < MINIQUAD_CALIBRATION_RECORD_SIZE; i++)
+		{
+			record[i] = EEPROM.read(MINIQUAD_CALIBRATION_ADDRESS + i);
+		}
+
+		// Check the magic and the checksum (an erased EEPROM reads 0xFF)
+		if (record[0] != MINIQUAD_CALIBRATION_MAGIC0 || record[1] != MINIQUAD_CALIBRATION_MAGIC1) return false;
+		if (record[MINIQUAD_CALIBRATION_RECORD_SIZE - 1] != _calibrationChecksum(record)) return false;
+
+		MiniquadCalibration calibration;
+		for (uint8_t axis = 0; axis < 3; axis++)
+		{
+			calibration.accelOffset[axis] = (int16_t)((record[2 + axis*2] << 8) | record[3 + axis*2]);
+			calibration.gyroOffset[axis] = (int16_t)((record[8 + axis*2] << 8) | record[9 + axis*2]);
+		}
+		SetCalibration(calibration);
+		return true;
+	}
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Persist the sensor offsets in use to the EEPROM (unchanged bytes are not
+	//					rewritten, saving EEPROM wear).
+	void SaveCalibration()
+	{
+		uint8_t record[MINIQUAD_CALIBRATION_RECORD_SIZE];
+		record[0] = MINIQUAD_CALIBRATION_MAGIC0;
+		record[1] = MINIQUAD_CALIBRATION_MAGIC1;
+		for (uint8_t axis = 0; axis < 3; axis++)
+		{
+			record[2 + axis*2] = (uint8_t)(_calibration.accelOffset[axis] >> 8);
+			record[3 + axis*2] = (uint8_t)(_calibration.accelOffset[axis]);
+			record[8 + axis*2] = (uint8_t)(_calibration.gyroOffset[axis] >> 8);
+			record[9 + axis*2] = (uint8_t)(_calibration.gyroOffset[axis]);
+		}
+		record[MINIQUAD_CALIBRATION_RECORD_SIZE - 1] = _calibrationChecksum(record);
+
+		for (uint8_t i = 0; i < MINIQUAD_CALIBRATION_RECORD_SIZE; i++)
+		{
+			if (EEPROM.read(MINIQUAD_CALIBRATION_ADDRESS + i) != record[i])
+			{
+				EEPROM.write(MINIQUAD_CALIBRATION_ADDRESS + i, record[i]);
+			}
+		}
+	}
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Invalidate the persisted sensor calibration (the offsets in use are kept).
+	void ClearCalibration()
+	{
+		EEPROM.write(MINIQUAD_CALIBRATION_ADDRESS, 0xFF);
+	}
+#endif // MINIQUAD_CALIBRATION_EEPROM
+
 	// @Params:			(void)
 	// @Return:			A float indicating the temperature (degree Celsius)
 	// @Function:		Get the temperature from the temperature sensor.
@@ -170,7 +914,7 @@ public:
 		// According to the datasheet: 
 		//   340 per degrees Celsius, -512 at 35 degrees.
 		// At 0 degrees: -512 - (340 * 35) = -12412
-		return ((((float)_mpu.getTemperature()) - MPU6050_TEMPERATURE_SKEWING) / MPU6050_TEMPERATURE_UNIT);
+		return ((((float)_mpu.getTemperature()) - MPU6050_TEMPERATURE_SKEWING) * (1.0f / MPU6050_TEMPERATURE_UNIT));
 	}
 
 	// @Params:			(void)
@@ -179,21 +923,17 @@ public:
 	// @Contributor:	David Qiu (2013.7.10), David Qiu (2013.8.13)
 	Rotation& GetRotation()
 	{
-		#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(!_rotation_cal)
-		{
-		#endif // MINIQUAD_DMP_KEEP_DATA
-			// Calculate the rotation
-			_rotation.setX((float)_rot_Int16_raw.x / MPU6050_ROTATION_UNIT);
-			_rotation.setY((float)_rot_Int16_raw.y / MPU6050_ROTATION_UNIT);
-			_rotation.setZ((float)_rot_Int16_raw.z / MPU6050_ROTATION_UNIT);
-		#ifdef MINIQUAD_DMP_KEEP_DATA
-			_rotation_cal = true;
-		}
-		#endif // MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(RotationNode::MASK)) return _rotation.value;
+
+		// Calculate the rotation (the scale of the gyro range)
+		const float rotationScale = GyroUnit::degreePerLsb();
+		_rotation.value.setX(_rot_Int16_raw.x * rotationScale);
+		_rotation.value.setY(_rot_Int16_raw.y * rotationScale);
+		_rotation.value.setZ(_rot_Int16_raw.z * rotationScale);
+		_fresh.Mark(RotationNode::MASK);
 
 		// Return the result
-		return _rotation;
+		return _rotation.value;
 	}
 
 	// @Params:			(void)
@@ -205,26 +945,58 @@ public:
 		return _quaternion;
 	}
 
+	// @Params:			(void)
+	// @Return:			A QuaternionQ14& (!Reference) indicating the current rotation information in Q14
+	// @Function:		Get the quaternion data of the quad copter in fixed point, as the DMP sends it
+	//					(see Miniquad_fixmath.h for the integer gravity, rotation and angles).
+	QuaternionQ14& GetQuaternionQ14()
+	{
+		return _quaternionQ14;
+	}
+
+	// @Params:			(void)
+	// @Return:			A float* indicating the row-major rotation matrix of the current quaternion
+	//					(9 floats, body to world frame)
+	// @Function:		Get the rotation matrix (direction cosine matrix) of the quad copter (DMP). It
+	//					is expanded once per sample and shared by the derived attitude data.
+	float* GetRotationMatrix()
+	{
+		if (_fresh.IsFresh(RotationMatrixNode::MASK)) return _rotationMatrix.value;
+
+		// Expand the quaternion
+		_quaternion.getRotationMatrix(_rotationMatrix.value);
+		_fresh.Mark(RotationMatrixNode::MASK);
+
+		// Return the result
+		return _rotationMatrix.value;
+	}
+
 	// @Params:			(void)
 	// @Return:			A EulerAngle& (!Reference) indicating the current rotation information of the quad copter
 	// @Function:		Get the Euler angle of the quad copter (DMP)
 	// @Contributor:	David Qiu (2013.7.10)
 	EulerAngle& GetEulerAngle()
 	{
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(_eulerAngle_cal) return _eulerAngle; // return immediately if calculated
-	#endif // !MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(EulerAngleNode::MASK)) return _eulerAngle.value; // return immediately if calculated
 
-		// Calculate the Euler angle
-		_eulerAngle.setPsi((180/M_PI) * atan2(2*_quaternion.x*_quaternion.y - 2*_quaternion.w*_quaternion.z, 2*_quaternion.w*_quaternion.w + 2*_quaternion.x*_quaternion.x - 1));
-		_eulerAngle.setTheta((180/M_PI) * (-asin(2*_quaternion.x*_quaternion.z + 2*_quaternion.w*_quaternion.y)));
-		_eulerAngle.setPhi((180/M_PI) * atan2(2*_quaternion.y*_quaternion.z - 2*_quaternion.w*_quaternion.x, 2*_quaternion.w*_quaternion.w + 2*_quaternion.z*_quaternion.z - 1));
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		_eulerAngle_cal = true;
-	#endif // MINIQUAD_DMP_KEEP_DATA
+	#ifdef MINIQUAD_FIXED_POINT
+		// Calculate the Euler angle in fixed point (0.01 degree)
+		int16_t euler[3];
+		_quaternionQ14.getEuler(euler);
+		_eulerAngle.value.setPsi(euler[0] * 0.01f);
+		_eulerAngle.value.setTheta(euler[1] * 0.01f);
+		_eulerAngle.value.setPhi(euler[2] * 0.01f);
+	#else
+		// Calculate the Euler angle from the rotation matrix (see MINIQUAD_FAST_MATH)
+		const float* m = GetRotationMatrix();
+		_eulerAngle.value.setPsi((180/M_PI) * AttitudeMath::atan2(m[1], m[0]));
+		_eulerAngle.value.setTheta((180/M_PI) * (-AttitudeMath::asin(m[2])));
+		_eulerAngle.value.setPhi((180/M_PI) * AttitudeMath::atan2(m[5], m[8]));
+	#endif // MINIQUAD_FIXED_POINT
+		_fresh.Mark(EulerAngleNode::MASK);
 
 		// Return the result
-		return _eulerAngle;
+		return _eulerAngle.value;
 	}
 
 	// @Params:			(void)
@@ -233,20 +1005,26 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	Gravity& GetGravity()
 	{
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(_gravity_cal) return _gravity;
-	#endif // MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(GravityNode::MASK)) return _gravity.value;
 
-		// Calculate the gravity
-		_gravity.setX(2 * (_quaternion.x*_quaternion.z - _quaternion.w*_quaternion.y));
-		_gravity.setY(2 * (_quaternion.w*_quaternion.x + _quaternion.y*_quaternion.z));
-		_gravity.setZ(_quaternion.w*_quaternion.w - _quaternion.x*_quaternion.x - _quaternion.y*_quaternion.y + _quaternion.z*_quaternion.z);
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		_gravity_cal = true;
-	#endif // MINIQUAD_DMP_KEEP_DATA
+	#ifdef MINIQUAD_FIXED_POINT
+		// Calculate the gravity in fixed point
+		VectorQ14 gravity;
+		_quaternionQ14.getGravity(gravity);
+		_gravity.value.setX(gravity.x * MPU6050_QUATERNION_SCALE);
+		_gravity.value.setY(gravity.y * MPU6050_QUATERNION_SCALE);
+		_gravity.value.setZ(gravity.z * MPU6050_QUATERNION_SCALE);
+	#else
+		// Calculate the gravity (the world z-axis in the body frame, last row of the rotation matrix)
+		const float* m = GetRotationMatrix();
+		_gravity.value.setX(m[6]);
+		_gravity.value.setY(m[7]);
+		_gravity.value.setZ(m[8]);
+	#endif // MINIQUAD_FIXED_POINT
+		_fresh.Mark(GravityNode::MASK);
 
 		// Return the result
-		return _gravity;
+		return _gravity.value;
 	}
 
 	// @Params:			(void)
@@ -255,27 +1033,27 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	YawPitchRoll& GetYawPitchRoll()
 	{
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(!_gravity_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			GetGravity(); // get the current gravity
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		}
-		if(!_ypr_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			// Calculate the yaw, pitch and roll angles
-			_ypr.setYaw((180/M_PI) * atan2(2*_quaternion.x*_quaternion.y - 2*_quaternion.w*_quaternion.z, 2*_quaternion.w*_quaternion.w + 2*_quaternion.x*_quaternion.x - 1));
-			_ypr.setPitch((180/M_PI) * atan(_gravity.getX() / sqrt(_gravity.getY()*_gravity.getY() + _gravity.getZ()*_gravity.getZ())));
-			_ypr.setRoll((180/M_PI) * atan(_gravity.getY() / sqrt(_gravity.getX()*_gravity.getX() + _gravity.getZ()*_gravity.getZ())));
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-			_ypr_cal = true;
-		}
-	#endif // MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(YawPitchRollNode::MASK)) return _ypr.value;
+
+	#ifdef MINIQUAD_FIXED_POINT
+		// Calculate the yaw, pitch and roll angles in fixed point (0.01 degree)
+		int16_t ypr[3];
+		_quaternionQ14.getYawPitchRoll(ypr);
+		_ypr.value.setYaw(ypr[0] * 0.01f);
+		_ypr.value.setPitch(ypr[1] * 0.01f);
+		_ypr.value.setRoll(ypr[2] * 0.01f);
+	#else
+		// Calculate the yaw, pitch and roll angles (see MINIQUAD_FAST_MATH)
+		const float* m = GetRotationMatrix();
+		Gravity& gravity = GetGravity();
+		_ypr.value.setYaw((180/M_PI) * AttitudeMath::atan2(m[1], m[0]));
+		_ypr.value.setPitch((180/M_PI) * AttitudeMath::atan(gravity.getX() / AttitudeMath::sqrt(gravity.getY()*gravity.getY() + gravity.getZ()*gravity.getZ())));
+		_ypr.value.setRoll((180/M_PI) * AttitudeMath::atan(gravity.getY() / AttitudeMath::sqrt(gravity.getX()*gravity.getX() + gravity.getZ()*gravity.getZ())));
+	#endif // MINIQUAD_FIXED_POINT
+		_fresh.Mark(YawPitchRollNode::MASK);
 
 		// Return the result
-		return _ypr;
+		return _ypr.value;
 	}
 
 	// @Params:			(void)
@@ -284,28 +1062,28 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	Acceleration& GetLinearAcceleration()
 	{
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(!_gravity_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			GetGravity(); // get the current gravity
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		}
-		if(!_acceleration_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			// Calculate the linear acceleration
-			// get rid of the gravity component (+1g = +8192 in standard DMP FIFO packet, sensitivity is 2g)
-			_acceleration.setX((float)_accel_Int16_raw.x/MPU6050_GRAVITY_UNIT - _gravity.getX());
-			_acceleration.setY((float)_accel_Int16_raw.y/MPU6050_GRAVITY_UNIT - _gravity.getY());
-			_acceleration.setZ((float)_accel_Int16_raw.z/MPU6050_GRAVITY_UNIT - _gravity.getZ());
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-			_acceleration_cal = true;
-		}
-	#endif // MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(AccelerationNode::MASK)) return _acceleration.value;
+
+	#ifdef MINIQUAD_FIXED_POINT
+		// Calculate the linear acceleration in fixed point
+		VectorQ13 acceleration;
+		_getLinearAccelerationQ13(acceleration);
+		_acceleration.value.setX(acceleration.x * MPU6050_GRAVITY_SCALE);
+		_acceleration.value.setY(acceleration.y * MPU6050_GRAVITY_SCALE);
+		_acceleration.value.setZ(acceleration.z * MPU6050_GRAVITY_SCALE);
+	#else
+		// Calculate the linear acceleration
+		// get rid of the gravity component (+1g = +8192 in standard DMP FIFO packet, sensitivity is 2g)
+		const float accelerationScale = AccelUnit::gPerLsb();
+		Gravity& gravity = GetGravity();
+		_acceleration.value.setX(_accel_Int16_raw.x * accelerationScale - gravity.getX());
+		_acceleration.value.setY(_accel_Int16_raw.y * accelerationScale - gravity.getY());
+		_acceleration.value.setZ(_accel_Int16_raw.z * accelerationScale - gravity.getZ());
+	#endif // MINIQUAD_FIXED_POINT
+		_fresh.Mark(AccelerationNode::MASK);
 
 		// Return the result
-		return _acceleration;
+		return _acceleration.value;
 	}
 
 	// @Params:			(void)
@@ -314,106 +1092,472 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	Acceleration& GetWorldAcceleration()
 	{
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		if(!_acceleration_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			GetLinearAcceleration(); // calculate the linear acceleration
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		}
-		if(!_accelerationW_cal)
-		{
-	#endif // MINIQUAD_DMP_KEEP_DATA
-			// Calculate the world acceleration in Int16 form
-			VectorInt16 accel_world;
-			accel_world.x = (int16_t)(_acceleration.getX() * MPU6050_GRAVITY_UNIT);
-			accel_world.y = (int16_t)(_acceleration.getY() * MPU6050_GRAVITY_UNIT);
-			accel_world.z = (int16_t)(_acceleration.getZ() * MPU6050_GRAVITY_UNIT);
-			accel_world.rotate(&_quaternion);
-			
-			// Convert the Int16 form into float form
-			_accelerationW.setX((float)accel_world.x/MPU6050_GRAVITY_UNIT);
-			_accelerationW.setY((float)accel_world.y/MPU6050_GRAVITY_UNIT);
-			_accelerationW.setZ((float)accel_world.z/MPU6050_GRAVITY_UNIT);
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-			_accelerationW_cal = true;
-		}
-	#endif // MINIQUAD_DMP_KEEP_DATA
+		if (_fresh.IsFresh(AccelerationWNode::MASK)) return _accelerationW.value;
+
+	#ifdef MINIQUAD_FIXED_POINT
+		// Calculate the world acceleration in fixed point
+		VectorQ13 acceleration;
+		_getLinearAccelerationQ13(acceleration);
+		_quaternionQ14.rotate(acceleration);
+		_accelerationW.value.setX(acceleration.x * MPU6050_GRAVITY_SCALE);
+		_accelerationW.value.setY(acceleration.y * MPU6050_GRAVITY_SCALE);
+		_accelerationW.value.setZ(acceleration.z * MPU6050_GRAVITY_SCALE);
+	#else
+		// Rotate the linear acceleration into the world frame (float, by the rotation matrix)
+		_accelerationW.value = GetLinearAcceleration();
+		Quaternion::rotateVector(GetRotationMatrix(), _accelerationW.value.GetArray());
+	#endif // MINIQUAD_FIXED_POINT
+		_fresh.Mark(AccelerationWNode::MASK);
 
 		// Return the result
-		return _accelerationW;
+		return _accelerationW.value;
 	}
 
 
 protected:
 	MPU6050 _mpu;					// The MPU6050
+	bool _dmpWarmStart;				// Indicates if the DMP initialization has been skipped
+	uint8_t _dmpLoadStep;			// The step of the DMP loading stage (MINIQUAD_DMP_LOAD_*)
+	uint16_t _dmpLoadPosition;		// The memory bank, configuration record or final pass of the step
+	uint32_t _dmpLoadWait;			// The time the current wait of the DMP loading has started (ms)
+	int8_t _dmpGyroOffsetTC[3];		// The gyro offset TCs kept over the DMP upload
+
+	uint8_t _initStage;				// The current initialization stage
+	uint8_t _initRetries;			// Failed attempts of the current initialization stage
+	uint8_t _initError;				// The last initialization error
+	uint8_t _initErrorStage;		// The stage of the last initialization error
+	bool _initForceColdStart;		// Indicates if the DMP initialization is forced
+	uint32_t _initStageStart;		// The time the current initialization stage has been entered (ms)
+	uint32_t _initAttemptStart;		// The time the current attempt of the stage has been started (ms)
+	uint32_t _initStageTime[MINIQUAD_INIT_STAGES];	// The elapsed time of each initialization stage (ms)
 	uint8_t _mpuInterruptStatus;	// Holds actual interrupt status byte from MPU
 	uint16_t _mpuFIFOPacketSize;	// Expected DMP packet size (default is 42 bytes)
 	uint16_t _mpuFIFOCount;			// Count of all bytes currently in FIFO
-	uint8_t _mpuFIFOBuffer[64];		// FIFO storage buffer
+	uint8_t _mpuFIFOGyroOffset;		// Offset of the gyro in the DMP packet (0 if not sent)
+	uint8_t _mpuFIFOAccelOffset;	// Offset of the acceleration in the DMP packet (0 if not sent)
+	uint8_t _mpuFIFOBuffer[MINIQUAD_FIFO_BURST_SIZE];	// FIFO storage buffer (one burst of packets)
+	MiniquadFifoStatistics _fifoStatistics;	// Statistics of the DMP FIFO draining
+	VectorInt16 _packetRotation;	// The raw rotation of the last accepted DMP packet (spike reference)
+	VectorInt16 _packetAcceleration;	// The raw acceleration of the last accepted DMP packet (spike reference)
+	uint8_t _packetSpikeRun;		// Count of the consecutive DMP packets rejected as spikes
+	uint8_t _packetInvalidRun;		// Count of the consecutive implausible DMP packets not realigned
+	bool _packetReference;			// Indicates if the spike and attitude references hold an accepted packet
 
-	Quaternion _quaternionReader;	// The quaternion obtained as the DMP data source (DMP)
+	QuaternionQ14 _quaternionReader;	// The quaternion obtained as the DMP data source (DMP, Q14)
 	Quaternion _quaternion;			// The last correct quaternion obtained from the quaternion reader (DMP)
-	EulerAngle _eulerAngle;			// The Euler Angle obtained (DMP)
-	Gravity _gravity;				// The gravity components of x-, y-, z-axes obtained (DMP)
-	YawPitchRoll _ypr;				// The yaw, pitch, roll angles obtained (DMP)
-	VectorInt16 _rot_Int16_raw;		// The raw Int16-form rotation data obtained as data source (raw)
-	Rotation _rotation;				// The rotation data obtained (DMP)
+	QuaternionQ14 _quaternionQ14;	// The last correct quaternion in Q14 (DMP)
+	VectorInt16 _rot_Int16_raw;		// The raw Int16-form rotation data obtained as data source (DMP)
 	VectorInt16 _accel_Int16_raw;	// The raw Int16-form acceleration data obtained as data source (DMP)
-	Acceleration _acceleration;		// The linear acceleration without gravity (DMP)
-	Acceleration _accelerationW;	// The world linear acceleration with gravity (DMP)
+	uint32_t _sampleTimestamp;		// The time the packet of the sample has been read (micros)
+	uint16_t _sampleNumber;			// The sequence number of the sample
+	volatile uint8_t _sampleSequence;	// Publication sequence of the sample (odd while being updated)
+#ifdef MINIQUAD_RAW_MODE
+	MINIQUAD_RAW_ESTIMATOR _estimator;	// The attitude estimator fed with the raw sensor data (raw mode)
+	uint32_t _rawLastUpdate;		// The time of the last raw sensor sample (micros)
+#endif // MINIQUAD_RAW_MODE
+	MiniquadCalibration _calibration;	// The sensor offsets in use
+	bool _calibrated;				// Indicates if the sensor offsets have been calibrated or loaded
+#ifdef MINIQUAD_DMP_PROPAGATE
+	GyroPropagator _propagator;		// The DMP attitude propagated with the raw gyro
+	uint32_t _propagateLast;		// The time of the last propagation step (micros)
+#endif // MINIQUAD_DMP_PROPAGATE
+
+	// Define: Spike limits of the DMP packets in the units of the ranges (LSB)
+	enum
+	{
+		GYRO_SPIKE_LSB = ((int32_t)MINIQUAD_DMP_GYRO_SPIKE * 131) >> GyroRange,
+		ACCEL_SPIKE_LSB = (int32_t)MINIQUAD_DMP_ACCEL_SPIKE * AccelUnit::LSB_PER_G
+	};
+
+	// Define: Dependency graph of the derived data (the inputs are the closures of their nodes)
+	typedef MiniquadNode<MINIQUAD_OUTPUT_ROTATION> RotationNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_ROTATION_MATRIX> RotationMatrixNode;
+#ifdef MINIQUAD_FIXED_POINT
+	typedef MiniquadNode<MINIQUAD_OUTPUT_GRAVITY> GravityNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_EULER_ANGLE> EulerAngleNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_YAW_PITCH_ROLL> YawPitchRollNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_LINEAR_ACCELERATION> AccelerationNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_WORLD_ACCELERATION> AccelerationWNode;
+#else
+	typedef MiniquadNode<MINIQUAD_OUTPUT_GRAVITY, RotationMatrixNode::CLOSURE> GravityNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_EULER_ANGLE, RotationMatrixNode::CLOSURE> EulerAngleNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_YAW_PITCH_ROLL, RotationMatrixNode::CLOSURE | GravityNode::CLOSURE> YawPitchRollNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_LINEAR_ACCELERATION, GravityNode::CLOSURE> AccelerationNode;
+	typedef MiniquadNode<MINIQUAD_OUTPUT_WORLD_ACCELERATION, RotationMatrixNode::CLOSURE | AccelerationNode::CLOSURE> AccelerationWNode;
+#endif // MINIQUAD_FIXED_POINT
+
+	// Define: Derived data needed by the outputs (MINIQUAD_DMP_OUTPUTS with all their inputs)
+	enum
+	{
+		NEEDED_DATA = 
+			MiniquadNeeded<RotationNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<RotationMatrixNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<GravityNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<EulerAngleNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<YawPitchRollNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<AccelerationNode, MINIQUAD_DMP_OUTPUTS>::VALUE | 
+			MiniquadNeeded<AccelerationWNode, MINIQUAD_DMP_OUTPUTS>::VALUE
+	};
+
+	MiniquadSlot<Rotation, (NEEDED_DATA & RotationNode::MASK) != 0> _rotation;					// The rotation data obtained (DMP)
+	MiniquadSlot<float[9], (NEEDED_DATA & RotationMatrixNode::MASK) != 0> _rotationMatrix;		// The rotation matrix of the quaternion, row-major (DMP)
+	MiniquadSlot<Gravity, (NEEDED_DATA & GravityNode::MASK) != 0> _gravity;						// The gravity components of x-, y-, z-axes obtained (DMP)
+	MiniquadSlot<EulerAngle, (NEEDED_DATA & EulerAngleNode::MASK) != 0> _eulerAngle;			// The Euler Angle obtained (DMP)
+	MiniquadSlot<YawPitchRoll, (NEEDED_DATA & YawPitchRollNode::MASK) != 0> _ypr;				// The yaw, pitch, roll angles obtained (DMP)
+	MiniquadSlot<Acceleration, (NEEDED_DATA & AccelerationNode::MASK) != 0> _acceleration;		// The linear acceleration without gravity (DMP)
+	MiniquadSlot<Acceleration, (NEEDED_DATA & AccelerationWNode::MASK) != 0> _accelerationW;	// The world linear acceleration with gravity (DMP)
 #ifdef MINIQUAD_DMP_KEEP_DATA
-	bool _acceleration_cal;			// Indicates if the _acceleration has been calculated
-	bool _accelerationW_cal;		// Indicates if the _accelerationW has been calculated
-	bool _eulerAngle_cal;			// Indicates if the _eulerAngle has been calculated
-	bool _ypr_cal;					// Indicates if the _ypr has been calculated
-	bool _gravity_cal;				// Indicates if the _gravity has been calculated
-	bool _rotation_cal;				// Indicates if the _rotation has been calculated
+	MiniquadFreshness<true> _fresh;		// The derived data calculated for the sample
+#else
+	MiniquadFreshness<false> _fresh;	// Every derived data is recalculated
 #endif // MINIQUAD_DMP_KEEP_DATA
 
 
+	// @Params:			stage: The initialization stage to enter
+	// @Return:			(_initStage, _initStageTime)
+	// @Function:		Finish the current initialization stage and enter the next one.
+	void _enterInitStage(uint8_t stage)
+	{
+		uint32_t now = millis();
+		if (_initStage < MINIQUAD_INIT_STAGES) _initStageTime[_initStage] = now - _initStageStart;
+		_initStage = stage;
+		_initStageStart = now;
+		_initAttemptStart = now;
+		_initRetries = 0;
+	}
+
+	// @Params:			error: The error of the failed attempt
+	// @Return:			(_initStage, _initError, _initErrorStage)
+	// @Function:		Record a failed attempt of the current initialization stage, and fail the
+	//					initialization if the stage has used up its attempts.
+	void _retryInitStage(uint8_t error)
+	{
+		_initError = error;
+		_initErrorStage = _initStage;
+		_initAttemptStart = millis();
+		if (++_initRetries >= MINIQUAD_INIT_RETRIES) _enterInitStage(MINIQUAD_INIT_FAILED);
+	}
+
 	// @Params:			(void)
-	// @Return:			(_mpuFIFOBuffer, _quaternion, _accel_Int16_raw)
-	// @Function:		Get the FIFO bytes from the MPU6050, put them to the buffer and convert them
-	//					into Quaternion and raw acceleration in Int16 form.
-	// @Contributor:	David Qiu (2013.7.1), David Qiu (2013.8.14)
-	void _refreshDMPData()
+	// @Return:			An uint8_t indicating the error of the step (MINIQUAD_INIT_ERROR_NONE, 1: code
+	//					upload failed, 2: DMP configuration failed, MINIQUAD_INIT_ERROR_NO_DATA)
+	//					(_dmpLoadStep, _dmpLoadPosition, _dmpLoadWait, _dmpGyroOffsetTC)
+	// @Function:		Carry on the DMP loading by one step of MPU6050::dmpInitialize(), a memory bank
+	//					of the code or a configuration record at a time. The waits for the MPU6050 are
+	//					polled instead of blocking. The loading is done at MINIQUAD_DMP_LOAD_DONE.
+	uint8_t _stepDMPLoad()
 	{
-		do 
+		uint32_t stepStart;
+
+		switch (_dmpLoadStep)
 		{
-			// Wait for MPU6050 to interrupt
-			while(!MpuInterrupt && _mpuFIFOCount < _mpuFIFOPacketSize) {;}
+		case MINIQUAD_DMP_LOAD_RESET:
+			// Reset the MPU6050, it takes a while to come up
+			_mpu.initialize();
+			_mpu.dmpBeginInitialize();
+			_mpu.dmpUploadTime = 0;
+			_dmpLoadWait = millis();
+			_dmpLoadStep = MINIQUAD_DMP_LOAD_PREPARE;
+			break;
+
+		case MINIQUAD_DMP_LOAD_PREPARE:
+			// Wake it up and reset its I2C master, which takes a while too
+			if (millis() - _dmpLoadWait < MPU6050_DMP_RESET_DELAY) break;
+			_mpu.dmpPrepareUpload(_dmpGyroOffsetTC);
+			_dmpLoadWait = millis();
+			_dmpLoadPosition = 0;
+			_dmpLoadStep = MINIQUAD_DMP_LOAD_CODE;
+			break;
 
-			// Reset interrupt flag
-			MpuInterrupt = false;
+		case MINIQUAD_DMP_LOAD_CODE:
+			// Upload a memory bank of the code
+			if (millis() - _dmpLoadWait < MPU6050_DMP_I2C_MASTER_DELAY) break;
+			stepStart = micros();
+			if (!_mpu.dmpUploadCode(_dmpLoadPosition)) return 1;
+			_mpu.dmpUploadTime += micros() - stepStart;
+			if (++_dmpLoadPosition == MPU6050_DMP_CODE_BANKS)
+			{
+				_dmpLoadPosition = 0;
+				_dmpLoadStep = MINIQUAD_DMP_LOAD_CONFIG;
+			}
+			break;
 
-			// Get current FIFO count
-			_mpuFIFOCount = _mpu.getFIFOCount();
-			_mpuInterruptStatus = _mpu.getIntStatus();
+		case MINIQUAD_DMP_LOAD_CONFIG:
+			// Upload a record of the configuration
+			stepStart = micros();
+			_dmpLoadPosition = _mpu.dmpUploadConfig(_dmpLoadPosition);
+			if (_dmpLoadPosition == 0) return 2;
+			_mpu.dmpUploadTime += micros() - stepStart;
+			if (_dmpLoadPosition >= MPU6050_DMP_CONFIG_SIZE) _dmpLoadStep = MINIQUAD_DMP_LOAD_CONFIGURE;
+			break;
+
+		case MINIQUAD_DMP_LOAD_CONFIGURE:
+			// Set up the sensors and start the DMP for the final updates
+			if (!_mpu.dmpConfigure(_dmpGyroOffsetTC)) return 2;
+			_dmpLoadWait = millis();
+			_dmpLoadPosition = 1;
+			_dmpLoadStep = MINIQUAD_DMP_LOAD_SETTLE;
+			break;
 
-			// Check for interrupt status and FIFO overflow
-			if ((_mpuInterruptStatus & 0x10) || _mpuFIFOCount == 1024)
+		case MINIQUAD_DMP_LOAD_SETTLE:
+			// Run a final pass once the DMP has filled the FIFO
+			if (_mpu.getFIFOCount() < MPU6050_DMP_SETTLE_FIFO_COUNT)
 			{
-				// Reset the FIFO
-				_mpu.resetFIFO();
+				if (millis() - _dmpLoadWait > MINIQUAD_INIT_DATA_TIMEOUT) return MINIQUAD_INIT_ERROR_NO_DATA;
+				break;
+			}
+			if (!_mpu.dmpFinishInitialize(_dmpLoadPosition)) return 2;
+			_dmpLoadWait = millis();
+			if (++_dmpLoadPosition > 2) _dmpLoadStep = MINIQUAD_DMP_LOAD_DONE;
+			break;
+
+		default: // Done
+			break;
+		}
+
+		return MINIQUAD_INIT_ERROR_NONE;
+	}
+
+	// @Params:			acceleration: The container for the linear acceleration (Q13, 8192 per g)
+	// @Return:			(void)
+	// @Function:		Calculate the acceleration without gravity in fixed point.
+	void _getLinearAccelerationQ13(VectorQ13& acceleration)
+	{
+		// Get rid of the gravity component (Q14 to Q13, the acceleration shifted to Q13)
+		VectorQ14 gravity;
+		_quaternionQ14.getGravity(gravity);
+		acceleration.x = VectorQ13::saturate(AccelUnit::toQ13(_accel_Int16_raw.x) - (gravity.x >> 1));
+		acceleration.y = VectorQ13::saturate(AccelUnit::toQ13(_accel_Int16_raw.y) - (gravity.y >> 1));
+		acceleration.z = VectorQ13::saturate(AccelUnit::toQ13(_accel_Int16_raw.z) - (gravity.z >> 1));
+	}
+
+	// @Params:			calibration: The container for the sensor offsets
+	// @Return:			(void)
+	// @Function:		Read the offset registers of the MPU6050.
+	void _getSensorOffsets(MiniquadCalibration& calibration)
+	{
+		calibration.accelOffset[0] = _mpu.getXAccelOffset();
+		calibration.accelOffset[1] = _mpu.getYAccelOffset();
+		calibration.accelOffset[2] = _mpu.getZAccelOffset();
+		calibration.gyroOffset[0] = _mpu.getXGyroOffset();
+		calibration.gyroOffset[1] = _mpu.getYGyroOffset();
+		calibration.gyroOffset[2] = _mpu.getZGyroOffset();
+	}
+
+	// @Params:			calibration: The sensor offsets
+	// @Return:			(void)
+	// @Function:		Write the offset registers of the MPU6050.
+	void _setSensorOffsets(const MiniquadCalibration& calibration)
+	{
+		_mpu.setXAccelOffset(calibration.accelOffset[0]);
+		_mpu.setYAccelOffset(calibration.accelOffset[1]);
+		_mpu.setZAccelOffset(calibration.accelOffset[2]);
+		_mpu.setXGyroOffset(calibration.gyroOffset[0]);
+		_mpu.setYGyroOffset(calibration.gyroOffset[1]);
+		_mpu.setZGyroOffset(calibration.gyroOffset[2]);
+	}
+
+	// @Params:			record: The calibration record
+	// @Return:			An uint8_t indicating the checksum of the record (without its last byte)
+	// @Function:		Calculate the XOR checksum of the calibration record, seeded so that an
+	//					all-zero record does not pass.
+	static uint8_t _calibrationChecksum(const uint8_t* record)
+	{
+		uint8_t checksum = 0xA5;
+		for (uint8_t i = 0; i < MINIQUAD_CALIBRATION_RECORD_SIZE - 1; i++) checksum ^= record[i];
+		return checksum;
+	}
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the full scale ranges have been set
+	// @Function:		Program the full scale ranges of the gyroscope and the accelerometer and
+	//					read them back.
+	bool _setFullScaleRanges()
+	{
+		_mpu.setFullScaleGyroRange(GyroRange);
+		_mpu.setFullScaleAccelRange(AccelRange);
+		return (_mpu.getFullScaleGyroRange() == GyroRange && _mpu.getFullScaleAccelRange() == AccelRange);
+	}
+
+	// @Params:			(void)
+	// @Return:			(_mpuFIFOPacketSize, _mpuFIFOGyroOffset, _mpuFIFOAccelOffset)
+	// @Function:		Get the DMP packet size and layout from the MPU6050 after its contents changed.
+	void _refreshDMPPacketLayout()
+	{
+		uint8_t contents = _mpu.dmpGetPacketContents();
+
+		// The optional blocks follow the 16-byte quaternion in order of gyro and acceleration
+		_mpuFIFOPacketSize = _mpu.dmpGetFIFOPacketSize();
+		_mpuFIFOGyroOffset = (contents & MPU6050_DMP_PACKET_GYRO) ? 16 : 0;
+		_mpuFIFOAccelOffset = (contents & MPU6050_DMP_PACKET_ACCEL) ? (_mpuFIFOGyroOffset ? 28 : 16) : 0;
+	}
+
+	// @Params:			packet: The DMP packet (at least the 16-byte quaternion)
+	//					quaternion: The container for the quaternion of the packet (Q14)
+	// @Return:			A bool indicating whether the quaternion is close to a unit quaternion
+	// @Function:		Take the quaternion from a DMP packet and check its squared magnitude in
+	//					integer (0.9 ~ 1.1, no square root).
+	bool _readDMPQuaternion(const uint8_t* packet, QuaternionQ14& quaternion)
+	{
+		quaternion.setFromPacket(packet);
+		uint32_t magnitude = quaternion.getMagnitudeSquared();
+		return (magnitude >= MPU6050_QUATERNION_MAGNITUDE_MIN && magnitude <= MPU6050_QUATERNION_MAGNITUDE_MAX);
+	}
+
+	// @Params:			a, b: The quaternions (Q14)
+	// @Return:			A bool indicating whether the quaternions are close attitudes
+	// @Function:		Check the consistency of two quaternions by their dot product (either sign,
+	//					q and -q are the same attitude).
+	bool _isDMPQuaternionConsistent(const QuaternionQ14& a, const QuaternionQ14& b)
+	{
+		int32_t dot = a.getDot(b);
+		return (dot >= MPU6050_QUATERNION_CONSISTENCY_MIN || dot <= -MPU6050_QUATERNION_CONSISTENCY_MIN);
+	}
+
+	// @Params:			length: Count of the bytes in the FIFO buffer
+	// @Return:			A uint8_t indicating the offset of the first whole packet (0 if not found)
+	// @Function:		Scan the FIFO buffer for the packet boundary after a read from the wrong
+	//					offset: a unit quaternion consistent with the last accepted attitude and with
+	//					the quaternion one packet later if the buffer holds it. The attitude check
+	//					rules out the shifted copies of the quaternion, which are unit quaternions
+	//					as well when the packet has zero components.
+	uint8_t _findDMPPacketOffset(uint8_t length)
+	{
+		QuaternionQ14 candidate;
+		QuaternionQ14 next;
+		for (uint8_t offset = 1; offset < _mpuFIFOPacketSize && offset + 16 <= length; offset++)
+		{
+			if (!_readDMPQuaternion(_mpuFIFOBuffer + offset, candidate)) continue;
+			if (_packetReference && !_isDMPQuaternionConsistent(candidate, _quaternionReader)) continue;
+			if (offset + _mpuFIFOPacketSize + 16 <= length)
+			{
+				if (!_readDMPQuaternion(_mpuFIFOBuffer + offset + _mpuFIFOPacketSize, next) || 
+					!_isDMPQuaternionConsistent(candidate, next)) continue;
+			}
+			else if (!_packetReference)
+			{
+				continue; // nothing to check the candidate against
 			}
+			return offset;
+		}
+		return 0;
+	}
+
+	// @Params:			value: The raw vector of the packet
+	//					last: The raw vector of the last accepted packet
+	//					limit: The largest change of a component (0 for no limit)
+	// @Return:			A bool indicating whether the change is a spike
+	// @Function:		Compare a raw vector with the one of the last accepted packet.
+	static bool _isDMPSpike(const VectorInt16& value, const VectorInt16& last, int32_t limit)
+	{
+		if (limit == 0) return false;
+		return (labs((int32_t)value.x - last.x) > limit || 
+			labs((int32_t)value.y - last.y) > limit || 
+			labs((int32_t)value.z - last.z) > limit);
+	}
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether a new sample has been published
+	// @Function:		Get a new sample from the DMP, or from the raw sensors in the raw mode.
+	bool _tryRefreshData()
+	{
+	#ifdef MINIQUAD_RAW_MODE
+		return _tryRefreshRawData();
+	#else
+		return _tryRefreshDMPData();
+	#endif // MINIQUAD_RAW_MODE
+	}
+
+	// @Params:			quaternion: The quaternion of the sample
+	//					quaternionQ14: The quaternion of the sample in Q14
+	//					acceleration: The raw Int16-form acceleration of the sample
+	//					rotation: The raw Int16-form rotation of the sample
+	//					timestamp: The time the sample has been read (micros)
+	// @Return:			(_quaternion, _quaternionQ14, _accel_Int16_raw, _rot_Int16_raw, _sampleTimestamp, _sampleNumber)
+	// @Function:		Publish a new sample and clear the calculated data of the previous one.
+	void _publishSample(const Quaternion& quaternion, const QuaternionQ14& quaternionQ14, 
+		const VectorInt16& acceleration, const VectorInt16& rotation, uint32_t timestamp)
+	{
+		// Publish the sample (odd sequence while the update is in progress)
+		_sampleSequence++;
+		MINIQUAD_MEMORY_BARRIER();
+		_quaternion = quaternion;
+		_quaternionQ14 = quaternionQ14;
+		_accel_Int16_raw = acceleration;
+		_rot_Int16_raw = rotation;
+		_sampleTimestamp = timestamp;
+		_sampleNumber++;
+		MINIQUAD_MEMORY_BARRIER();
+		_sampleSequence++;
+
+	#ifdef MINIQUAD_DMP_PROPAGATE
+		// Resynchronize the propagation with the new anchor
+		_propagator.Reset(quaternion);
+		_propagateLast = timestamp;
+	#endif // MINIQUAD_DMP_PROPAGATE
+
+		// Invalidate the derived data of the previous sample
+		_fresh.Invalidate();
+	}
+
+	// @Params:			(void)
+	// @Return:			(_mpuFIFOBuffer, _quaternion, _accel_Int16_raw, _rot_Int16_raw)
+	// @Function:		Wait until the FIFO bytes from the MPU6050 have been obtained and converted
+	//					into Quaternion, raw rotation and acceleration in Int16 form.
+	// @Contributor:	David Qiu (2013.7.1), David Qiu (2013.8.14)
+	void _refreshDMPData()
+	{
+		while (!_tryRefreshData()) {;}
+	}
 
-			// Check the status again
-			_mpuInterruptStatus = _mpu.getIntStatus();
-			_mpuFIFOCount = _mpu.getFIFOCount();
-		} while (!(_mpuInterruptStatus & 0x02));
-		
-		// Wait for correct available data length, should be a VERY short wait
-		while (_mpuFIFOCount < _mpuFIFOPacketSize) _mpuFIFOCount = _mpu.getFIFOCount();
+	// @Params:			(void)
+	// @Return:			A bool indicating whether a new sample has been published
+	//					(_mpuFIFOBuffer, _quaternion, _accel_Int16_raw, _rot_Int16_raw, _fifoStatistics)
+	// @Function:		Get the FIFO bytes from the MPU6050 if there are any, put them to the buffer 
+	//					and convert them into Quaternion, raw rotation and acceleration in Int16 form,
+	//					all from the same packet (see MINIQUAD_DMP_FIFO_ROTATION). With
+	//					MINIQUAD_DMP_DRAIN_FIFO all complete packets are read in bursts and the newest
+	//					one is kept (gyro and acceleration averaged with MINIQUAD_DMP_AVERAGE_DATA).
+	//					It never waits for the MPU6050.
+	bool _tryRefreshDMPData()
+	{
+		// Return immediately if the MPU6050 has not signalled and no packet is left over
+		if (!MpuInterrupt && _mpuFIFOCount < _mpuFIFOPacketSize) return false;
+
+		// Reset interrupt flag
+		MpuInterrupt = false;
 
-		// Read a packet from FIFO
-		_mpu.getFIFOBytes(_mpuFIFOBuffer, _mpuFIFOPacketSize);
+		// Get current interrupt status and FIFO count
+		_mpuInterruptStatus = _mpu.getIntStatus();
+		_mpuFIFOCount = _mpu.getFIFOCount();
 
-		// Track FIFO count here in case there is > 1 packet available
-		// (this lets us immediately read more without waiting for an interrupt)
-		_mpuFIFOCount -= _mpuFIFOPacketSize;
+		// Check for FIFO overflow
+		if ((_mpuInterruptStatus & 0x10) || _mpuFIFOCount == 1024)
+		{
+			// Account the packets thrown away
+			_fifoStatistics.dropped += _mpuFIFOCount / _mpuFIFOPacketSize;
+			if (_mpuInterruptStatus & 0x10) _fifoStatistics.overflows++;
+			_fifoStatistics.resets++;
 
-		// Default FIFO buffer data structure
+			// Reset the FIFO, new data comes with the next interrupt
+			_mpu.resetFIFO();
+			_mpuFIFOCount = 0;
+			return false;
+		}
+
+		// Check for a complete packet
+		if (_mpuFIFOCount < _mpuFIFOPacketSize) return false;
+
+		// Count the packets to read at this refreshment
+	#ifdef MINIQUAD_DMP_DRAIN_FIFO
+		uint16_t packets = _mpuFIFOCount / _mpuFIFOPacketSize;
+	#else
+		uint16_t packets = 1;
+	#endif // MINIQUAD_DMP_DRAIN_FIFO
+		uint8_t burstPackets = sizeof(_mpuFIFOBuffer) / _mpuFIFOPacketSize;
+
+		// Default FIFO buffer data structure (gyro and acceleration move up or are left out
+		// according to the packet contents, see _refreshDMPPacketLayout())
 		/* ================================================================================================ *
 		| Default MotionApps v2.0 42-byte FIFO packet structure:                                           |
 		|                                                                                                  |
@@ -424,37 +1568,198 @@ protected:
 		|  24  25  26  27  28  29  30  31  32  33  34  35  36  37  38  39  40  41                          |
 		* ================================================================================================ */
 
-		// Get Quaternion as DMP data source
-		_quaternionReader.w = (float)((_mpuFIFOBuffer[0] << 8) + _mpuFIFOBuffer[1]) / MPU6050_QUATERNION_UNIT;
-		_quaternionReader.x = (float)((_mpuFIFOBuffer[4] << 8) + _mpuFIFOBuffer[5]) / MPU6050_QUATERNION_UNIT;
-		_quaternionReader.y = (float)((_mpuFIFOBuffer[8] << 8) + _mpuFIFOBuffer[9]) / MPU6050_QUATERNION_UNIT;
-		_quaternionReader.z = (float)((_mpuFIFOBuffer[12] << 8) + _mpuFIFOBuffer[13]) / MPU6050_QUATERNION_UNIT;
-		if(_quaternionReader.getMagnitude()<0.9 || _quaternionReader.getMagnitude()>1.1) return;
-		_quaternion = _quaternionReader;
-
-		// Get Rotation as DMP data source
-		//_rot_Int16_raw.x = (_mpuFIFOBuffer[16] << 8) + _mpuFIFOBuffer[17];
-		//_rot_Int16_raw.y = (_mpuFIFOBuffer[20] << 8) + _mpuFIFOBuffer[21];
-		//_rot_Int16_raw.z = (_mpuFIFOBuffer[24] << 8) + _mpuFIFOBuffer[25];
-
-		// Get Acceleration as DMP data source
-		_accel_Int16_raw.x = (_mpuFIFOBuffer[28] << 8) + _mpuFIFOBuffer[29];
-		_accel_Int16_raw.y = (_mpuFIFOBuffer[32] << 8) + _mpuFIFOBuffer[33];
-		_accel_Int16_raw.z = (_mpuFIFOBuffer[36] << 8) + _mpuFIFOBuffer[37];
-
-		// Get Rotation from raw MPU6050
-		_mpu.getRotation(&(_rot_Int16_raw.x), &(_rot_Int16_raw.y), &(_rot_Int16_raw.z));
-
-	#ifdef MINIQUAD_DMP_KEEP_DATA
-		// Clear the calculation flags
-		_acceleration_cal = false;
-		_accelerationW_cal = false;
-		_eulerAngle_cal = false;
-		_ypr_cal = false;
-		_gravity_cal = false;
-		_rotation_cal = false;
-	#endif // MINIQUAD_DMP_KEEP_DATA
+		VectorInt16 rotReader;
+		VectorInt16 accelReader;
+		uint32_t timestamp = 0;
+		uint8_t valid = 0;
+	#ifdef MINIQUAD_DMP_AVERAGE_DATA
+		int32_t rotSum[3] = { 0, 0, 0 };
+		int32_t accelSum[3] = { 0, 0, 0 };
+	#endif // MINIQUAD_DMP_AVERAGE_DATA
+
+		bool resync = false;
+		while (packets > 0)
+		{
+			// Read the packets of the FIFO count, as many as the buffer holds, in a single stream
+			uint8_t burst = (packets < burstPackets) ? packets : burstPackets;
+			uint8_t length = burst * _mpuFIFOPacketSize;
+			_mpu.getFIFOBytes(_mpuFIFOBuffer, length);
+			uint32_t burstTimestamp = micros();
+
+			// Track FIFO count here in case there are more packets available
+			// (this lets us immediately read more without waiting for an interrupt)
+			_mpuFIFOCount -= length;
+			packets -= burst;
+			_fifoStatistics.packets += burst;
+
+			// Realign a burst read from the wrong offset (e.g. after a cut read on the bus): drop
+			// the bytes before the first whole packet and complete the last one from the FIFO
+			QuaternionQ14 quaternionReader;
+			if (!_readDMPQuaternion(_mpuFIFOBuffer, quaternionReader))
+			{
+				uint8_t offset = _findDMPPacketOffset(length);
+				if (offset != 0 && _mpuFIFOCount >= offset)
+				{
+					memmove(_mpuFIFOBuffer, _mpuFIFOBuffer + offset, length - offset);
+					_mpu.getFIFOBytes(_mpuFIFOBuffer + length - offset, offset);
+					_mpuFIFOCount -= offset;
+					if (packets > _mpuFIFOCount / _mpuFIFOPacketSize) packets = _mpuFIFOCount / _mpuFIFOPacketSize;
+					_fifoStatistics.realigned++;
+					_fifoStatistics.dropped++; // the cut packet
+				}
+			}
+
+			for (uint8_t i = 0; i < burst; i++)
+			{
+				uint8_t* packet = _mpuFIFOBuffer + i * _mpuFIFOPacketSize;
+
+				// Get Quaternion as DMP data source (Q14, checked in integer)
+				if (!_readDMPQuaternion(packet, quaternionReader))
+				{
+					_fifoStatistics.rejected++;
+					_fifoStatistics.dropped++;
+					if (++_packetInvalidRun >= MINIQUAD_DMP_RESYNC_LIMIT) resync = true;
+					continue;
+				}
+				_packetInvalidRun = 0;
+
+				// Get Acceleration and Rotation as DMP data source
+				VectorInt16 accelPacket = _packetAcceleration;
+				VectorInt16 rotPacket = _packetRotation;
+				if (_mpuFIFOAccelOffset)
+				{
+					uint8_t* accel = packet + _mpuFIFOAccelOffset;
+					accelPacket.x = (accel[0] << 8) + accel[1];
+					accelPacket.y = (accel[4] << 8) + accel[5];
+					accelPacket.z = (accel[8] << 8) + accel[9];
+				}
+				if (_mpuFIFOGyroOffset)
+				{
+					uint8_t* rot = packet + _mpuFIFOGyroOffset;
+					rotPacket.x = (rot[0] << 8) + rot[1];
+					rotPacket.y = (rot[4] << 8) + rot[5];
+					rotPacket.z = (rot[8] << 8) + rot[9];
+				}
+
+				// Reject a spike unless the jump has lasted for MINIQUAD_DMP_SPIKE_HOLD packets
+				if (_packetReference && _packetSpikeRun < MINIQUAD_DMP_SPIKE_HOLD && 
+					(_isDMPSpike(accelPacket, _packetAcceleration, ACCEL_SPIKE_LSB) || 
+					_isDMPSpike(rotPacket, _packetRotation, GYRO_SPIKE_LSB)))
+				{
+					_packetSpikeRun++;
+					_fifoStatistics.rejected++;
+					_fifoStatistics.dropped++;
+					continue;
+				}
+				_packetSpikeRun = 0;
+
+				// Accept the packet
+				_packetReference = true;
+				_quaternionReader = quaternionReader;
+				_packetAcceleration = accelPacket;
+				_packetRotation = rotPacket;
+				accelReader = accelPacket;
+				rotReader = rotPacket;
+				timestamp = burstTimestamp;
+
+			#ifdef MINIQUAD_DMP_AVERAGE_DATA
+				// Accumulate the batch
+				rotSum[0] += rotReader.x; rotSum[1] += rotReader.y; rotSum[2] += rotReader.z;
+				accelSum[0] += accelReader.x; accelSum[1] += accelReader.y; accelSum[2] += accelReader.z;
+			#endif // MINIQUAD_DMP_AVERAGE_DATA
+				valid++;
+			}
+
+			// Reset the FIFO if its packets stay implausible without a realignment
+			if (resync)
+			{
+				_fifoStatistics.dropped += _mpuFIFOCount / _mpuFIFOPacketSize;
+				_fifoStatistics.resets++;
+				_mpu.resetFIFO();
+				_mpuFIFOCount = 0;
+				_packetInvalidRun = 0;
+				break;
+			}
+		}
+
+		// Return if no packet in the batch is valid
+		if (valid == 0) return false;
+
+	#ifdef MINIQUAD_DMP_AVERAGE_DATA
+		// Average the gyro and acceleration of the batch
+		rotReader.x = (int16_t)(rotSum[0] / valid);
+		rotReader.y = (int16_t)(rotSum[1] / valid);
+		rotReader.z = (int16_t)(rotSum[2] / valid);
+		accelReader.x = (int16_t)(accelSum[0] / valid);
+		accelReader.y = (int16_t)(accelSum[1] / valid);
+		accelReader.z = (int16_t)(accelSum[2] / valid);
+	#endif // MINIQUAD_DMP_AVERAGE_DATA
+
+		// Get Rotation from raw MPU6050 if it is not in the packet
+		// (an extra I2C transaction, not in time with the packet)
+		if (!_mpuFIFOGyroOffset) _mpu.getRotation(&(rotReader.x), &(rotReader.y), &(rotReader.z));
+
+		// Publish the sample
+		_publishSample(_quaternionReader.toFloat(), _quaternionReader, accelReader, rotReader, timestamp);
+		return true;
+	}
+
+#ifdef MINIQUAD_RAW_MODE
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the raw sensors have been set up
+	// @Function:		Set the MPU6050 up for the raw sensor data after its reset: the full scale
+	//					ranges of the class and the data ready interrupt at the raw mode sample rate.
+	bool _initializeRawSensors()
+	{
+		_mpu.initialize();
+		_mpu.setDLPFMode(MINIQUAD_RAW_DLPF_MODE);
+		_mpu.setRate(MINIQUAD_RAW_RATE_DIVIDER);
+		_mpu.setIntEnabled(1 << MPU6050_INTERRUPT_DATA_RDY_BIT);
+
+		// Set the ranges and read the configuration back
+		return (_setFullScaleRanges() && _mpu.getRate() == MINIQUAD_RAW_RATE_DIVIDER);
+	}
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether a new sample has been published
+	//					(_estimator, _quaternion, _accel_Int16_raw, _rot_Int16_raw, _fifoStatistics)
+	// @Function:		Read the raw acceleration and rotation in a single burst if the MPU6050 has
+	//					signalled new data, and update the attitude estimator with them. Samples
+	//					missed between two refreshments are not recovered (the sensor registers
+	//					hold only the latest one), the estimator integrates over the elapsed time.
+	bool _tryRefreshRawData()
+	{
+		// Return immediately if the MPU6050 has not signalled
+		if (!MpuInterrupt) return false;
+
+		// Reset interrupt flag
+		MpuInterrupt = false;
+
+		// Get the raw sensor data (14-byte burst) and the time elapsed since the last sample
+		VectorInt16 rotReader;
+		VectorInt16 accelReader;
+		_mpu.getMotion6(&(accelReader.x), &(accelReader.y), &(accelReader.z), 
+			&(rotReader.x), &(rotReader.y), &(rotReader.z));
+		uint32_t timestamp = micros();
+		float dt = (timestamp - _rawLastUpdate) * 1e-6f;
+		_rawLastUpdate = timestamp;
+		_fifoStatistics.packets++;
+
+		// Update the attitude (gyro in rad/s, any acceleration unit)
+		const float rotationScale = GyroUnit::radianPerLsb();
+		_estimator.Update(rotReader.x * rotationScale, rotReader.y * rotationScale, rotReader.z * rotationScale, 
+			accelReader.x, accelReader.y, accelReader.z, dt);
+
+		// Publish the sample
+		QuaternionQ14 quaternionQ14;
+		quaternionQ14.setFromFloat(_estimator.GetQuaternion());
+		_publishSample(_estimator.GetQuaternion(), quaternionQ14, accelReader, rotReader, timestamp);
+		return true;
 	}
+#endif // MINIQUAD_RAW_MODE
 };
 
+// Define: Quadaxis copter "Miniquad" with the default full scale ranges
+typedef BasicMiniquad<> Miniquad;
+
 #endif // !_MINIQUADZERO_H_
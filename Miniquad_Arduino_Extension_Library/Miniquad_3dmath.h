@@ -8,6 +8,9 @@
 //					 _FloatVector_3D, EulerAngle, YawPitchRoll and Gravity; the class
 //					 Acceleration added by David Qiu <david@davidqiu.com>
 //		- 2013.7.9 : Class Rotation added by David Qiu <david@davidqiu.com>
+//		- 2026.10.16 : Rotation of _FloatVector_3D in cross-product form and its batch
+//					   variant added
+//		- 2026.10.16 : _FloatVector_3D based on the Vec3<float> template
 //
 // This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
 // the basic data structures needed for the further development.
@@ -22,23 +25,18 @@
 #include "helper_3dmath.h"
 
 
-// Class: 3D vector for floats. 
-class _FloatVector_3D
+// Class: 3D vector for floats, a Vec3<float> with the array access of the library. 
+class _FloatVector_3D : public Vec3<float>
 {
-protected:
-	float _array[3]; // The float array
-
 public:
 
 	// @Params:			(void)
 	// @Return:			(void)
 	// @Function:		Default constructor.
 	// @Contributor:	David Qiu (2013.7.2)
-	_FloatVector_3D()
+	_FloatVector_3D() : Vec3<float>()
 	{
-		_array[0] = 0;
-		_array[0] = 0;
-		_array[0] = 0;
+		;
 	}
 
 	// @Params:			x: The first value
@@ -47,20 +45,18 @@ public:
 	// @Return:			(void)
 	// @Function:		The constructor with initialization.
 	// @Contributor:	David Qiu (2013.7.2)
-	_FloatVector_3D(float x, float y, float z)
+	_FloatVector_3D(float x, float y, float z) : Vec3<float>(x, y, z)
 	{
-		_array[0] = x;
-		_array[1] = y;
-		_array[2] = z;
+		;
 	}
 
 	// @Params:			(void)
 	// @Return:			A float* indicating the starting address of the float array.
-	// @Function:		Get the array of the float vector.
+	// @Function:		Get the array of the float vector (x, y and z are contiguous).
 	// @Contributor:	David Qiu (2013.7.2)
 	float* GetArray()
 	{
-		return _array;
+		return &x;
 	}
 
 	// @Params:			(void)
@@ -69,19 +65,16 @@ public:
 	// @Contributor:	David Qiu (2013.7.2)
 	float GetMagnitude()
 	{
-		return sqrt(_array[0]*_array[0] + _array[1]*_array[1] + _array[2]*_array[2]);
+		return getMagnitude();
 	}
 
 	// @Params:			(void)
 	// @Return:			(Effect on itself)
-	// @Function:		Normalize the vector.
+	// @Function:		Normalize the vector (inverse square root of AttitudeMath).
 	// @Contributor:	David Qiu (2013.7.2)
 	void Normalize()
 	{
-		float moduli = GetMagnitude();
-		_array[0] = _array[0] / moduli;
-		_array[1] = _array[1] / moduli;
-		_array[2] = _array[2] / moduli;
+		normalize();
 	}
 
 	// @Params:			(void)
@@ -95,24 +88,34 @@ public:
 		return vec;
 	}
 
-	// @Params:			q: The referred rotation Quaternion
+	// @Params:			q: The referred rotation Quaternion (unit quaternion)
 	// @Return:			(Effect on itself)
-	// @Function:		Rotate the vector.
+	// @Function:		Rotate the vector (q * v * conj(q), in cross-product form).
 	// @Contributor:	David Qiu (2013.7.2)
 	void Rotate(Quaternion *q)
 	{
-		Quaternion p(0, _array[0], _array[1], _array[2]);
-
-		// quaternion multiplication: q * p, stored back in p
-		p = q -> getProduct(p);
-
-		// quaternion multiplication: p * conj(q), stored back in p
-		p = p.getProduct(q -> getConjugate());
+		q -> rotateVector(GetArray());
+	}
 
-		// p quaternion is now [0, x', y', z']
-		_array[0] = p.x;
-		_array[1] = p.y;
-		_array[2] = p.z;
+	// @Params:			vectors: The vectors to rotate (Effect on them)
+	//					count: Count of the vectors
+	//					q: The referred rotation Quaternion (unit quaternion)
+	// @Return:			(void)
+	// @Function:		Rotate several vectors by the same quaternion, expanding its rotation matrix
+	//					only once (cheaper than Rotate() from two vectors on).
+	static void RotateAll(_FloatVector_3D* vectors, uint8_t count, Quaternion *q)
+	{
+		if (count == 1)
+		{
+			vectors[0].Rotate(q);
+			return;
+		}
+		float m[9];
+		q -> getRotationMatrix(m);
+		for (uint8_t i = 0; i < count; i++)
+		{
+			Quaternion::rotateVector(m, vectors[i].GetArray());
+		}
 	}
 
 	// @Params:			q: The referred rotation Quaternion
@@ -127,6 +130,9 @@ public:
 	}
 };
 
+// Check: GetArray() needs the components without padding (the size fails to compile otherwise)
+typedef char _FloatVector_3D_Contiguous[(sizeof(_FloatVector_3D) == 3 * sizeof(float)) ? 1 : -1];
+
 
 // Class: Rotation
 class Rotation : public _FloatVector_3D
@@ -160,7 +166,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.9)
 	float getX()
 	{
-		return _array[0];
+		return x;
 	}
 	// @Attribute:		X
 	// @Params:			value: The new value of rotation of x-axis direction (degree)
@@ -169,7 +175,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.9)
 	void setX(float value)
 	{
-		_array[0] = value;
+		x = value;
 	}
 
 	// @Attribute:		Y
@@ -179,7 +185,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	float getY()
 	{
-		return _array[1];
+		return y;
 	}
 	// @Attribute:		Y
 	// @Params:			value: The new value of rotation of y-axis direction (degree)
@@ -188,7 +194,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	void setY(float value)
 	{
-		_array[1] = value;
+		y = value;
 	}
 
 	// @Attribute:		Z
@@ -198,7 +204,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	float getZ()
 	{
-		return _array[2];
+		return z;
 	}
 	// @Attribute:		Z
 	// @Params:			value: The new value of rotation of z-axis direction (degree)
@@ -207,7 +213,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.10)
 	void setZ(float value)
 	{
-		_array[2] = value;
+		z = value;
 	}
 };
 
@@ -244,7 +250,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getPsi()
 	{
-		return _array[0];
+		return x;
 	}
 	// @Attribute:		Psi
 	// @Params:			value: The new value of Psi (degree)
@@ -253,7 +259,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setPsi(float value)
 	{
-		_array[0] = value;
+		x = value;
 	}
 
 	// @Attribute:		Theta
@@ -263,7 +269,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getTheta()
 	{
-		return _array[1];
+		return y;
 	}
 	// @Attribute:		Theta
 	// @Params:			value: The new value of Theta (degree) 
@@ -272,7 +278,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setTheta(float value)
 	{
-		_array[1] = value;
+		y = value;
 	}
 
 	// @Attribute:		Phi
@@ -282,7 +288,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getPhi()
 	{
-		return _array[2];
+		return z;
 	}
 	// @Attribute:		Phi
 	// @Params:			value: The new value of Phi (degree)
@@ -291,7 +297,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setPhi(float value)
 	{
-		_array[2] = value;
+		z = value;
 	}
 };
 
@@ -328,7 +334,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2)
 	float getYaw()
 	{
-		return _array[0];
+		return x;
 	}
 	// @Attribute:		Yaw
 	// @Params:			value: The new value of the yaw angle (degree)
@@ -337,7 +343,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	void setYaw(float value)
 	{
-		_array[0] = value;
+		x = value;
 	}
 
 	// @Attribute:		Pitch
@@ -347,7 +353,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	float getPitch()
 	{
-		return _array[1];
+		return y;
 	}
 	// @Attribute:		Pitch
 	// @Params:			value: The new value of the pitch angle (degree)
@@ -356,7 +362,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	void setPitch(float value)
 	{
-		_array[1] = value;
+		y = value;
 	}
 
 	// @Attribute:		Roll
@@ -366,7 +372,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	float getRoll()
 	{
-		return _array[2];
+		return z;
 	}
 	// @Attribute:		Roll
 	// @Params:			value: The new value of the roll angle (degree)
@@ -375,7 +381,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	void setRoll(float value)
 	{
-		_array[2] = value;
+		z = value;
 	}
 };
 
@@ -412,7 +418,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	float getX()
 	{
-		return _array[0];
+		return x;
 	}
 	// @Attribute:		X
 	// @Params:			A float indicating the new value of the gravity component on x-axis (g)
@@ -421,7 +427,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	void setX(float value)
 	{
-		_array[0] = value;
+		x = value;
 	}
 
 	// @Attribute:		Y
@@ -431,7 +437,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	float getY()
 	{
-		return _array[1];
+		return y;
 	}
 	// @Attribute:		Y
 	// @Params:			value: The new value of the gravity component on y-axis (g)
@@ -440,7 +446,7 @@ public:
 	// @Contributor:	Jack Xu (2013.7.2), David Qiu (2013.7.4)
 	void setY(float value)
 	{
-		_array[1] = value;
+		y = value;
 	}
 
 	// @Attribute:		Z
@@ -450,7 +456,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getZ()
 	{
-		return _array[2];
+		return z;
 	}
 	// @Attribute:		Z
 	// @Params:			value: The new value of the gravity component on z-axis (g)
@@ -459,7 +465,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setZ(float value)
 	{
-		_array[2] = value;
+		z = value;
 	}
 };
 
@@ -496,7 +502,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getX()
 	{
-		return _array[0];
+		return x;
 	}
 	// @Attribute:		X
 	// @Params:			value: The new value of the acceleration component on x-axis (g)
@@ -505,7 +511,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setX(float value)
 	{
-		_array[0] = value;
+		x = value;
 	}
 
 	// @Attribute:		Y
@@ -515,7 +521,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getY()
 	{
-		return _array[1];
+		return y;
 	}
 	// @Attribute:		Y
 	// @Params:			value: The new value of the acceleration component on y-axis (g)
@@ -524,7 +530,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setY(float value)
 	{
-		_array[1] = value;
+		y = value;
 	}
 
 	// @Attribute:		Z
@@ -534,7 +540,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	float getZ()
 	{
-		return _array[2];
+		return z;
 	}
 	// @Attribute:		Z
 	// @Params:			value: The new value of the acceleration component on z-axis (g)
@@ -543,7 +549,7 @@ public:
 	// @Contributor:	David Qiu (2013.7.4)
 	void setZ(float value)
 	{
-		_array[2] = value;
+		z = value;
 	}
 };
 
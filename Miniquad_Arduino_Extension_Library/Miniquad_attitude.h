@@ -0,0 +1,255 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the attitude estimators fusing the raw gyroscope and accelerometer data of the MPU6050
+// into a quaternion, used instead of the DMP in the raw mode of Miniquad, and the gyro
+// propagation of the DMP attitude between its updates. They depend on nothing but the
+// quaternion of helper_3dmath.h and the inverse square root of AttitudeMath (fast under
+// MINIQUAD_FAST_MATH), and can be built on the host as well.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_ATTITUDE_H_
+#define _MINIQUAD_ATTITUDE_H_
+
+#include <math.h>
+#include "helper_3dmath.h"
+
+
+// Class: Mahony complementary filter (proportional and integral feedback of the gravity error)
+class MahonyEstimator
+{
+protected:
+	Quaternion _q;		// The attitude quaternion
+	float _twoKp;		// Twice the proportional gain
+	float _twoKi;		// Twice the integral gain
+	float _integralX;	// Integral of the gravity error scaled by Ki (x-axis)
+	float _integralY;	// Integral of the gravity error scaled by Ki (y-axis)
+	float _integralZ;	// Integral of the gravity error scaled by Ki (z-axis)
+
+public:
+
+	// @Params:			kp: The proportional gain
+	//					ki: The integral gain (0 to disable the gyro bias integration)
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	MahonyEstimator(float kp = 0.5f, float ki = 0.0f)
+	{
+		_twoKp = 2.0f * kp;
+		_twoKi = 2.0f * ki;
+		Reset();
+	}
+
+	// @Params:			(void)
+	// @Return:			(Effect on itself)
+	// @Function:		Reset the attitude to identity and clear the integral feedback.
+	void Reset()
+	{
+		_q = Quaternion();
+		_integralX = 0;
+		_integralY = 0;
+		_integralZ = 0;
+	}
+
+	// @Params:			gx, gy, gz: The angular rate (rad/s)
+	//					ax, ay, az: The acceleration (any unit, 0 if invalid)
+	//					dt: The time since the last update (s)
+	// @Return:			(Effect on itself)
+	// @Function:		Fuse one sample of gyroscope and accelerometer data into the attitude.
+	void Update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+	{
+		float qw = _q.w, qx = _q.x, qy = _q.y, qz = _q.z;
+
+		// Correct the gyro by the error between measured and estimated gravity
+		float norm = ax*ax + ay*ay + az*az;
+		if (norm > 0.0f)
+		{
+			float recipNorm = AttitudeMath::invSqrt(norm);
+			ax *= recipNorm;
+			ay *= recipNorm;
+			az *= recipNorm;
+
+			// Half of the estimated direction of gravity
+			float halfVx = qx*qz - qw*qy;
+			float halfVy = qw*qx + qy*qz;
+			float halfVz = qw*qw - 0.5f + qz*qz;
+
+			// Half of the error (cross product of measured and estimated gravity)
+			float halfEx = ay*halfVz - az*halfVy;
+			float halfEy = az*halfVx - ax*halfVz;
+			float halfEz = ax*halfVy - ay*halfVx;
+
+			if (_twoKi > 0.0f)
+			{
+				_integralX += _twoKi * halfEx * dt;
+				_integralY += _twoKi * halfEy * dt;
+				_integralZ += _twoKi * halfEz * dt;
+				gx += _integralX;
+				gy += _integralY;
+				gz += _integralZ;
+			}
+			gx += _twoKp * halfEx;
+			gy += _twoKp * halfEy;
+			gz += _twoKp * halfEz;
+		}
+
+		// Integrate the rate of change of the quaternion
+		gx *= 0.5f * dt;
+		gy *= 0.5f * dt;
+		gz *= 0.5f * dt;
+		_q.w = qw - qx*gx - qy*gy - qz*gz;
+		_q.x = qx + qw*gx + qy*gz - qz*gy;
+		_q.y = qy + qw*gy - qx*gz + qz*gx;
+		_q.z = qz + qw*gz + qx*gy - qy*gx;
+		_q.normalize();
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quaternion& (!Reference) indicating the estimated attitude
+	// @Function:		Get the estimated attitude.
+	Quaternion& GetQuaternion()
+	{
+		return _q;
+	}
+};
+
+
+// Class: Madgwick gradient descent filter (IMU form, without magnetometer)
+class MadgwickEstimator
+{
+protected:
+	Quaternion _q;		// The attitude quaternion
+	float _beta;		// The gradient descent gain
+
+public:
+
+	// @Params:			beta: The gradient descent gain
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	MadgwickEstimator(float beta = 0.1f)
+	{
+		_beta = beta;
+		Reset();
+	}
+
+	// @Params:			(void)
+	// @Return:			(Effect on itself)
+	// @Function:		Reset the attitude to identity.
+	void Reset()
+	{
+		_q = Quaternion();
+	}
+
+	// @Params:			gx, gy, gz: The angular rate (rad/s)
+	//					ax, ay, az: The acceleration (any unit, 0 if invalid)
+	//					dt: The time since the last update (s)
+	// @Return:			(Effect on itself)
+	// @Function:		Fuse one sample of gyroscope and accelerometer data into the attitude.
+	void Update(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+	{
+		float qw = _q.w, qx = _q.x, qy = _q.y, qz = _q.z;
+
+		// Rate of change of the quaternion from the gyro
+		float dw = 0.5f * (-qx*gx - qy*gy - qz*gz);
+		float dx = 0.5f * (qw*gx + qy*gz - qz*gy);
+		float dy = 0.5f * (qw*gy - qx*gz + qz*gx);
+		float dz = 0.5f * (qw*gz + qx*gy - qy*gx);
+
+		// Step against the gradient of the gravity error
+		float norm = ax*ax + ay*ay + az*az;
+		if (norm > 0.0f)
+		{
+			float recipNorm = AttitudeMath::invSqrt(norm);
+			ax *= recipNorm;
+			ay *= recipNorm;
+			az *= recipNorm;
+
+			float _2qw = 2.0f*qw, _2qx = 2.0f*qx, _2qy = 2.0f*qy, _2qz = 2.0f*qz;
+			float _4qw = 4.0f*qw, _4qx = 4.0f*qx, _4qy = 4.0f*qy;
+			float _8qx = 8.0f*qx, _8qy = 8.0f*qy;
+			float qwqw = qw*qw, qxqx = qx*qx, qyqy = qy*qy, qzqz = qz*qz;
+
+			float sw = _4qw*qyqy + _2qy*ax + _4qw*qxqx - _2qx*ay;
+			float sx = _4qx*qzqz - _2qz*ax + 4.0f*qwqw*qx - _2qw*ay - _4qx + _8qx*qxqx + _8qx*qyqy + _4qx*az;
+			float sy = 4.0f*qwqw*qy + _2qw*ax + _4qy*qzqz - _2qz*ay - _4qy + _8qy*qxqx + _8qy*qyqy + _4qy*az;
+			float sz = 4.0f*qxqx*qz - _2qx*ax + 4.0f*qyqy*qz - _2qy*ay;
+
+			norm = sw*sw + sx*sx + sy*sy + sz*sz;
+			if (norm > 0.0f)
+			{
+				recipNorm = _beta * AttitudeMath::invSqrt(norm);
+				dw -= sw * recipNorm;
+				dx -= sx * recipNorm;
+				dy -= sy * recipNorm;
+				dz -= sz * recipNorm;
+			}
+		}
+
+		// Integrate the rate of change of the quaternion
+		_q.w = qw + dw * dt;
+		_q.x = qx + dx * dt;
+		_q.y = qy + dy * dt;
+		_q.z = qz + dz * dt;
+		_q.normalize();
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quaternion& (!Reference) indicating the estimated attitude
+	// @Function:		Get the estimated attitude.
+	Quaternion& GetQuaternion()
+	{
+		return _q;
+	}
+};
+
+
+// Class: Attitude propagation by the gyro alone, anchored to an absolute attitude (e.g. DMP)
+class GyroPropagator
+{
+protected:
+	Quaternion _q;		// The propagated attitude quaternion
+
+public:
+
+	// @Params:			anchor: The absolute attitude to propagate from
+	// @Return:			(Effect on itself)
+	// @Function:		Resynchronize the propagated attitude with a new absolute attitude.
+	void Reset(const Quaternion& anchor)
+	{
+		_q = anchor;
+	}
+
+	// @Params:			gx, gy, gz: The angular rate (rad/s)
+	//					dt: The time since the last update (s)
+	// @Return:			(Effect on itself)
+	// @Function:		Rotate the attitude by the angular rate over the elapsed time.
+	void Update(float gx, float gy, float gz, float dt)
+	{
+		float qw = _q.w, qx = _q.x, qy = _q.y, qz = _q.z;
+
+		// Integrate the rate of change of the quaternion
+		gx *= 0.5f * dt;
+		gy *= 0.5f * dt;
+		gz *= 0.5f * dt;
+		_q.w = qw - qx*gx - qy*gy - qz*gz;
+		_q.x = qx + qw*gx + qy*gz - qz*gy;
+		_q.y = qy + qw*gy - qx*gz + qz*gx;
+		_q.z = qz + qw*gz + qx*gy - qy*gx;
+		_q.normalize();
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quaternion& (!Reference) indicating the propagated attitude
+	// @Function:		Get the propagated attitude.
+	Quaternion& GetQuaternion()
+	{
+		return _q;
+	}
+};
+
+
+#endif // !_MINIQUAD_ATTITUDE_H_
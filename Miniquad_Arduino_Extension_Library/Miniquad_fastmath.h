@@ -0,0 +1,157 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the fast float approximations of sqrt, 1/sqrt, atan, atan2 and asin used for the attitude
+// angles and the normalizations, each far cheaper than the libm function on the AVR.
+// AttitudeMath selects them or libm at compile time, and is used by the Euler and
+// yaw-pitch-roll getters of Miniquad and of the MPU6050 DMP and by the normalize() of the
+// vectors and quaternions. The max errors below are measured over the full float input range
+// ("make mathcheck" of the host tools enforces them).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_FASTMATH_H_
+#define _MINIQUAD_FASTMATH_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+
+// Config: If the attitude angles and the normalizations are calculated with the fast
+//         approximations instead of libm
+//#define MINIQUAD_FAST_MATH
+
+// Config: If the arctangent is interpolated from a flash table instead of a polynomial
+//         (faster, 260 bytes of flash)
+//#define MINIQUAD_FAST_MATH_TABLE
+
+// Define: Size of the arctangent table on [0, 1] (entries - 1)
+#define MINIQUAD_ATAN_TABLE_STEPS (64)
+
+// Define: Arctangent table, atan(i / 64) for i = 0 ~ 64 (rad)
+const float miniquadAtanTable[MINIQUAD_ATAN_TABLE_STEPS + 1] PROGMEM = {
+	0.00000000f, 0.01562373f, 0.03123983f, 0.04684071f, 0.06241881f, 0.07796663f, 0.09347678f, 0.10894196f,
+	0.12435499f, 0.13970887f, 0.15499674f, 0.17021193f, 0.18534795f, 0.20039855f, 0.21535770f, 0.23021959f,
+	0.24497866f, 0.25962963f, 0.27416745f, 0.28858736f, 0.30288487f, 0.31705575f, 0.33109608f, 0.34500218f,
+	0.35877067f, 0.37239845f, 0.38588267f, 0.39922077f, 0.41241044f, 0.42544964f, 0.43833656f, 0.45106966f,
+	0.46364761f, 0.47606933f, 0.48833395f, 0.50044081f, 0.51238946f, 0.52417963f, 0.53581124f, 0.54728438f,
+	0.55859932f, 0.56975645f, 0.58075635f, 0.59159971f, 0.60228735f, 0.61282020f, 0.62319933f, 0.63342588f,
+	0.64350111f, 0.65342634f, 0.66320299f, 0.67283255f, 0.68231655f, 0.69165662f, 0.70085441f, 0.70991162f,
+	0.71883000f, 0.72761133f, 0.73625743f, 0.74477013f, 0.75315128f, 0.76140277f, 0.76952648f, 0.77752431f,
+	0.78539816f
+};
+
+
+// Class: Fast float approximations (max errors for the whole input range)
+class FastMath
+{
+public:
+
+	// @Params:			x: The radicand (x > 0)
+	// @Return:			A float indicating 1 / sqrt(x) (max relative error 5e-6)
+	// @Function:		Calculate the inverse square root by the exponent trick and two Newton steps.
+	static float invSqrt(float x)
+	{
+		uint32_t bits;
+		float y;
+		memcpy(&bits, &x, sizeof(bits));
+		bits = 0x5F3759DF - (bits >> 1);
+		memcpy(&y, &bits, sizeof(y));
+		float halfX = 0.5f * x;
+		y = y * (1.5f - halfX * y * y);
+		y = y * (1.5f - halfX * y * y);
+		return y;
+	}
+
+	// @Params:			x: The radicand
+	// @Return:			A float indicating sqrt(x) (max relative error 5e-6, 0 for x <= 0)
+	// @Function:		Calculate the square root without division.
+	static float sqrt(float x)
+	{
+		if (x <= 0.0f) return 0.0f;
+		return x * invSqrt(x);
+	}
+
+	// @Params:			z: The tangent (0 <= z <= 1)
+	// @Return:			A float indicating atan(z) (rad, max error 2e-6 by polynomial, 2.1e-5 by table)
+	// @Function:		Calculate the arctangent on the first octant.
+	static float atanOctant(float z)
+	{
+	#ifdef MINIQUAD_FAST_MATH_TABLE
+		// Linear interpolation of the flash table
+		float position = z * MINIQUAD_ATAN_TABLE_STEPS;
+		uint8_t index = (uint8_t)position;
+		if (index >= MINIQUAD_ATAN_TABLE_STEPS) return pgm_read_float(&miniquadAtanTable[MINIQUAD_ATAN_TABLE_STEPS]);
+		float low = pgm_read_float(&miniquadAtanTable[index]);
+		float high = pgm_read_float(&miniquadAtanTable[index + 1]);
+		return low + (high - low) * (position - index);
+	#else
+		// Odd minimax polynomial of degree 11
+		float z2 = z * z;
+		return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f +
+			z2 * (0.05265332f - z2 * 0.01172120f)))));
+	#endif // MINIQUAD_FAST_MATH_TABLE
+	}
+
+	// @Params:			y: The y-coordinate
+	//					x: The x-coordinate
+	// @Return:			A float indicating the angle of (x, y) (rad, -PI ~ PI, errors of atanOctant())
+	// @Function:		Calculate atan2(y, x) by reduction to the first octant (one division).
+	static float atan2(float y, float x)
+	{
+		float ax = fabs(x);
+		float ay = fabs(y);
+		if (ax == 0.0f && ay == 0.0f) return 0.0f;
+
+		float angle = (ay > ax) ? ((float)M_PI_2 - atanOctant(ax / ay)) : atanOctant(ay / ax);
+		if (x < 0.0f) angle = (float)M_PI - angle;
+		return (y < 0.0f) ? -angle : angle;
+	}
+
+	// @Params:			z: The tangent
+	// @Return:			A float indicating atan(z) (rad, -PI/2 ~ PI/2, errors of atanOctant())
+	// @Function:		Calculate the arctangent.
+	static float atan(float z)
+	{
+		return atan2(z, 1.0f);
+	}
+
+	// @Params:			x: The sine (clamped to -1 ~ 1)
+	// @Return:			A float indicating asin(x) (rad, -PI/2 ~ PI/2, max error 4e-6, 2.2e-5 by table)
+	// @Function:		Calculate the arcsine as atan2(x, sqrt(1 - x^2)).
+	static float asin(float x)
+	{
+		if (x >= 1.0f) return (float)M_PI_2;
+		if (x <= -1.0f) return -(float)M_PI_2;
+		return atan2(x, sqrt((1.0f - x) * (1.0f + x)));
+	}
+};
+
+
+// Class: The libm functions with the interface of FastMath
+class StandardMath
+{
+public:
+	static float invSqrt(float x) { return 1.0f / ::sqrt(x); }
+	static float sqrt(float x) { return ::sqrt(x); }
+	static float atan(float z) { return ::atan(z); }
+	static float atan2(float y, float x) { return ::atan2(y, x); }
+	static float asin(float x) { return ::asin(x); }
+};
+
+
+// Define: The math functions for the attitude angles and the normalizations
+#ifdef MINIQUAD_FAST_MATH
+typedef FastMath AttitudeMath;
+#else
+typedef StandardMath AttitudeMath;
+#endif // MINIQUAD_FAST_MATH
+
+
+#endif // !_MINIQUAD_FASTMATH_H_
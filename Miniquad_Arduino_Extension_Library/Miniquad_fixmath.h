@@ -0,0 +1,330 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the fixed-point (Q format) quaternion and vector types and the integer implementations
+// of gravity, vector rotation and attitude angles, for the MCUs without FPU. A value v in
+// Q format with n fraction bits is stored as the integer v * 2^n, e.g. Q14 (the DMP
+// quaternion in int16_t) or Q30 (the full DMP quaternion in int32_t).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_FIXMATH_H_
+#define _MINIQUAD_FIXMATH_H_
+
+#include <stdint.h>
+#include "helper_3dmath.h"
+
+
+// Struct: Wider integer types for the intermediate products of a fixed-point storage type
+template <typename T> struct FixedWide {};
+template <> struct FixedWide<int16_t> { typedef int32_t Type; typedef uint32_t UType; };
+template <> struct FixedWide<int32_t> { typedef int64_t Type; typedef uint64_t UType; };
+
+
+// Class: Integer math kernels for the fixed-point types
+class FixedMath
+{
+public:
+
+	// @Params:			value: The radicand
+	// @Return:			An uint16_t indicating the integer square root (rounded down)
+	// @Function:		Calculate the square root of an unsigned integer (bitwise, no division).
+	static uint16_t sqrt(uint32_t value)
+	{
+		uint32_t root = 0;
+		uint32_t bit = (uint32_t)1 << 30;
+		while (bit > value) bit >>= 2;
+		while (bit != 0)
+		{
+			if (value >= root + bit)
+			{
+				value -= root + bit;
+				root = (root >> 1) + bit;
+			}
+			else
+			{
+				root >>= 1;
+			}
+			bit >>= 2;
+		}
+		return (uint16_t)root;
+	}
+
+	// @Params:			y: The y-coordinate
+	//					x: The x-coordinate (same scale as y)
+	// @Return:			An int16_t indicating the angle of (x, y) (0.01 degree, -18000 ~ 18000)
+	// @Function:		Calculate atan2(y, x) with the approximation atan(z) = z*(45 + 15.64*(1-z))
+	//					degree on the octant 0 <= z <= 1 (max error 0.22 degree).
+	static int16_t atan2(int32_t y, int32_t x)
+	{
+		if (x == 0 && y == 0) return 0;
+		uint32_t ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+		uint32_t ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+		uint32_t minimum = (ax < ay) ? ax : ay;
+		uint32_t maximum = (ax < ay) ? ay : ax;
+
+		// Ratio of the octant in Q15
+		while (maximum >= 0x10000) { maximum >>= 1; minimum >>= 1; }
+		uint32_t z = (minimum << 15) / maximum;
+
+		// Angle of the octant, then unfolded into the quadrants
+		int32_t angle = (int32_t)((z * (4500 + ((1564 * (32768 - z)) >> 15))) >> 15);
+		if (ay > ax) angle = 9000 - angle;
+		if (x < 0) angle = 18000 - angle;
+		if (y < 0) angle = -angle;
+		return (int16_t)angle;
+	}
+
+	// @Params:			value: The sine in Q format
+	//					q: The fraction bits of the value (up to 15)
+	// @Return:			An int16_t indicating the angle (0.01 degree, -9000 ~ 9000)
+	// @Function:		Calculate asin(value) as atan2(value, sqrt(1 - value^2)).
+	static int16_t asin(int32_t value, uint8_t q)
+	{
+		int32_t one = (int32_t)1 << q;
+		if (value > one) value = one;
+		if (value < -one) value = -one;
+		return atan2(value, sqrt((uint32_t)(one * one - value * value)));
+	}
+};
+
+
+// Class: 3D vector in Q format
+template <typename T, uint8_t Q>
+class FixedVector
+{
+public:
+	typedef typename FixedWide<T>::Type Wide;
+
+	T x;
+	T y;
+	T z;
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Default constructor (zero vector).
+	FixedVector()
+	{
+		x = 0;
+		y = 0;
+		z = 0;
+	}
+
+	// @Params:			nx, ny, nz: The components in Q format
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	FixedVector(T nx, T ny, T nz)
+	{
+		x = nx;
+		y = ny;
+		z = nz;
+	}
+
+	// @Params:			value: The value in the wide type
+	// @Return:			A T indicating the value clamped to the range of T
+	// @Function:		Saturate a wide intermediate value into the storage type.
+	static T saturate(Wide value)
+	{
+		const T maximum = (T)(((typename FixedWide<T>::UType)1 << (sizeof(T) * 8 - 1)) - 1);
+		if (value > maximum) return maximum;
+		if (value < -(Wide)maximum - 1) return -maximum - 1;
+		return (T)value;
+	}
+
+	// @Params:			(void)
+	// @Return:			A VectorFloat indicating the vector in float form
+	// @Function:		Convert the vector into float form.
+	VectorFloat toFloat() const
+	{
+		const float scale = 1.0f / (float)((uint32_t)1 << Q);
+		return VectorFloat(x * scale, y * scale, z * scale);
+	}
+};
+
+
+// Class: Quaternion in Q format (unit quaternion expected)
+template <typename T, uint8_t Q>
+class FixedQuaternion
+{
+public:
+	typedef typename FixedWide<T>::Type Wide;
+	typedef typename FixedWide<T>::UType UWide;
+
+	T w;
+	T x;
+	T y;
+	T z;
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Default constructor (identity).
+	FixedQuaternion()
+	{
+		w = (T)((Wide)1 << Q);
+		x = 0;
+		y = 0;
+		z = 0;
+	}
+
+	// @Params:			nw, nx, ny, nz: The components in Q format
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	FixedQuaternion(T nw, T nx, T ny, T nz)
+	{
+		w = nw;
+		x = nx;
+		y = ny;
+		z = nz;
+	}
+
+	// @Params:			packet: The DMP FIFO packet (quaternion as big-endian Q30 int32 at bytes 0 ~ 15)
+	// @Return:			(Effect on itself)
+	// @Function:		Take the quaternion from a DMP packet, keeping the upper Q + 2 bits.
+	void setFromPacket(const uint8_t* packet)
+	{
+		w = (T)(_readInt32(packet) >> (30 - Q));
+		x = (T)(_readInt32(packet + 4) >> (30 - Q));
+		y = (T)(_readInt32(packet + 8) >> (30 - Q));
+		z = (T)(_readInt32(packet + 12) >> (30 - Q));
+	}
+
+	// @Params:			q: The quaternion in float form
+	// @Return:			(Effect on itself)
+	// @Function:		Convert a float quaternion into Q format.
+	void setFromFloat(const Quaternion& q)
+	{
+		const float scale = (float)((uint32_t)1 << Q);
+		w = (T)(q.w * scale);
+		x = (T)(q.x * scale);
+		y = (T)(q.y * scale);
+		z = (T)(q.z * scale);
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quaternion indicating the quaternion in float form
+	// @Function:		Convert the quaternion into float form (a multiplication per component).
+	Quaternion toFloat() const
+	{
+		const float scale = 1.0f / (float)((uint32_t)1 << Q);
+		return Quaternion(w * scale, x * scale, y * scale, z * scale);
+	}
+
+	// @Params:			(void)
+	// @Return:			An unsigned wide integer indicating the squared magnitude (Q format with 2Q bits)
+	// @Function:		Get the squared magnitude, e.g. to check the validity of a DMP quaternion.
+	UWide getMagnitudeSquared() const
+	{
+		return (UWide)((Wide)w*w) + (UWide)((Wide)x*x) + (UWide)((Wide)y*y) + (UWide)((Wide)z*z);
+	}
+
+	// @Params:			q: The other quaternion
+	// @Return:			A wide integer indicating the dot product (Q format with 2Q bits)
+	// @Function:		Get the dot product, the cosine of half the angle between two attitudes.
+	Wide getDot(const FixedQuaternion& q) const
+	{
+		return (Wide)w*q.w + (Wide)x*q.x + (Wide)y*q.y + (Wide)z*q.z;
+	}
+
+	// @Params:			gravity: The container for the gravity direction (Q format, 1 = 1g)
+	// @Return:			(void)
+	// @Function:		Get the direction of gravity in the body frame.
+	void getGravity(FixedVector<T, Q>& gravity) const
+	{
+		gravity.x = (T)(((Wide)x*z - (Wide)w*y) >> (Q - 1));
+		gravity.y = (T)(((Wide)w*x + (Wide)y*z) >> (Q - 1));
+		gravity.z = (T)(((Wide)w*w - (Wide)x*x - (Wide)y*y + (Wide)z*z) >> Q);
+	}
+
+	// @Params:			v: The vector in any Q format (Effect on it)
+	// @Return:			(void)
+	// @Function:		Rotate a vector by the quaternion (q * v * conj(q)) as
+	//					v + 2w(u x v) + 2u x (u x v) with u = (x, y, z), saturating the result.
+	template <uint8_t R>
+	void rotate(FixedVector<T, R>& v) const
+	{
+		// t = u x v (format of v, kept wide)
+		Wide tx = ((Wide)y*v.z - (Wide)z*v.y) >> Q;
+		Wide ty = ((Wide)z*v.x - (Wide)x*v.z) >> Q;
+		Wide tz = ((Wide)x*v.y - (Wide)y*v.x) >> Q;
+
+		// v + 2wt + 2u x t
+		Wide rx = v.x + (((Wide)w*tx) >> (Q - 1)) + (((Wide)y*tz) >> (Q - 1)) - (((Wide)z*ty) >> (Q - 1));
+		Wide ry = v.y + (((Wide)w*ty) >> (Q - 1)) + (((Wide)z*tx) >> (Q - 1)) - (((Wide)x*tz) >> (Q - 1));
+		Wide rz = v.z + (((Wide)w*tz) >> (Q - 1)) + (((Wide)x*ty) >> (Q - 1)) - (((Wide)y*tx) >> (Q - 1));
+		v.x = FixedVector<T, R>::saturate(rx);
+		v.y = FixedVector<T, R>::saturate(ry);
+		v.z = FixedVector<T, R>::saturate(rz);
+	}
+
+	// @Params:			ypr: The container for yaw, pitch and roll (0.01 degree)
+	// @Return:			(void)
+	// @Function:		Get the yaw, pitch and roll angles, as Miniquad::GetYawPitchRoll().
+	void getYawPitchRoll(int16_t* ypr) const
+	{
+		FixedVector<T, Q> gravity;
+		getGravity(gravity);
+		ypr[0] = FixedMath::atan2(_reduce((Wide)x*y - (Wide)w*z), _reduce((Wide)w*w + (Wide)x*x - ((Wide)1 << (2*Q - 1))));
+		ypr[1] = FixedMath::atan2(_reduceVector(gravity.x),
+			FixedMath::sqrt(_square(_reduceVector(gravity.y)) + _square(_reduceVector(gravity.z))));
+		ypr[2] = FixedMath::atan2(_reduceVector(gravity.y),
+			FixedMath::sqrt(_square(_reduceVector(gravity.x)) + _square(_reduceVector(gravity.z))));
+	}
+
+	// @Params:			euler: The container for psi, theta and phi (0.01 degree)
+	// @Return:			(void)
+	// @Function:		Get the Euler angles, as Miniquad::GetEulerAngle().
+	void getEuler(int16_t* euler) const
+	{
+		euler[0] = FixedMath::atan2(_reduce((Wide)x*y - (Wide)w*z), _reduce((Wide)w*w + (Wide)x*x - ((Wide)1 << (2*Q - 1))));
+		euler[1] = -FixedMath::asin(_reduce((Wide)x*z + (Wide)w*y) >> 12, 15); // Q28 of xz + wy is Q27 of 2(xz + wy)
+		euler[2] = FixedMath::atan2(_reduce((Wide)y*z - (Wide)w*x), _reduce((Wide)w*w + (Wide)z*z - ((Wide)1 << (2*Q - 1))));
+	}
+
+protected:
+
+	// @Params:			bytes: Big-endian bytes
+	// @Return:			An int32_t indicating the value
+	// @Function:		Read a big-endian signed 32-bit integer.
+	static int32_t _readInt32(const uint8_t* bytes)
+	{
+		return (int32_t)(((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3]);
+	}
+
+	// @Params:			value: A sum of products of two components (Q format with 2Q bits, |value| < 2)
+	// @Return:			An int32_t indicating the value in Q28
+	// @Function:		Reduce a product to the precision of the integer kernels.
+	static int32_t _reduce(Wide value)
+	{
+		return (int32_t)(value >> (2*Q - 28));
+	}
+
+	// @Params:			value: A component (Q format)
+	// @Return:			An int32_t indicating the value in Q14
+	// @Function:		Reduce a component to the precision of the integer kernels.
+	static int32_t _reduceVector(T value)
+	{
+		return (int32_t)(value >> (Q - 14));
+	}
+
+	// @Params:			value: A value in Q14 (|value| <= 2^15)
+	// @Return:			An uint32_t indicating the square of the value in Q28
+	// @Function:		Square a reduced value.
+	static uint32_t _square(int32_t value)
+	{
+		return (uint32_t)(value * value);
+	}
+};
+
+
+// Define: Fixed-point types of the DMP quaternion and the derived vectors
+typedef FixedQuaternion<int16_t, 14> QuaternionQ14;
+typedef FixedQuaternion<int32_t, 30> QuaternionQ30;
+typedef FixedVector<int16_t, 14> VectorQ14;
+typedef FixedVector<int16_t, 13> VectorQ13; // Raw acceleration at 4g (8192 per g)
+
+
+#endif // !_MINIQUAD_FIXMATH_H_
@@ -0,0 +1,128 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the compile-time dependency graph of the lazily calculated data. Each derived value is
+// a node with a bit and the closure of the bits of its inputs, so that the values needed
+// by a set of outputs are known at compile time. The freshness of all the values is a
+// single bitmask, invalidated in one store, and the storage of a value outside the needed
+// set is compiled out.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_LAZY_H_
+#define _MINIQUAD_LAZY_H_
+
+#include <stdint.h>
+
+
+// Struct: Node of the dependency graph, with its bit and the closure of its inputs (the
+//         CLOSURE of each input node or'ed together, 0 for a node without inputs)
+template <uint8_t Mask, uint8_t Inputs = 0>
+struct MiniquadNode
+{
+	enum
+	{
+		MASK = Mask,				// The bit of the node
+		CLOSURE = Mask | Inputs		// The node and all the nodes it depends on
+	};
+};
+
+
+// Struct: Nodes needed for a node if it is among the wanted outputs (its closure, or none)
+template <typename Node, uint8_t Outputs>
+struct MiniquadNeeded
+{
+	enum { VALUE = (Outputs & Node::MASK) ? (uint8_t)Node::CLOSURE : 0 };
+};
+
+
+// Struct: Storage of a derived value, empty if the value is compiled out (any use of the
+//         value then fails to compile)
+template <typename T, bool Enabled>
+struct MiniquadSlot
+{
+	T value;	// The derived value
+};
+template <typename T>
+struct MiniquadSlot<T, false>
+{
+};
+
+
+// Class: Freshness of the derived values of a sample, one bit per node (up to 8 nodes)
+template <bool Keep>
+class MiniquadFreshness
+{
+public:
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Default constructor (nothing fresh).
+	MiniquadFreshness()
+	{
+		_fresh = 0;
+	}
+
+	// @Params:			mask: The bit of the node
+	// @Return:			A bool indicating whether the value of the node is calculated for the sample
+	// @Function:		Check the freshness of a value.
+	bool IsFresh(uint8_t mask)
+	{
+		return (_fresh & mask) != 0;
+	}
+
+	// @Params:			mask: The bit of the node
+	// @Return:			(void)
+	// @Function:		Mark a value as calculated for the sample.
+	void Mark(uint8_t mask)
+	{
+		_fresh |= mask;
+	}
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Invalidate all the values for a new sample (a single store).
+	void Invalidate()
+	{
+		_fresh = 0;
+	}
+
+protected:
+	uint8_t _fresh;	// The bits of the calculated values
+};
+
+// Class: Freshness without keeping the values (every value is recalculated on each use)
+template <>
+class MiniquadFreshness<false>
+{
+public:
+
+	// @Params:			mask: The bit of the node
+	// @Return:			A bool indicating whether the value is calculated (never)
+	// @Function:		Check the freshness of a value, constantly false.
+	bool IsFresh(uint8_t /* mask */)
+	{
+		return false;
+	}
+
+	// @Params:			mask: The bit of the node
+	// @Return:			(void)
+	// @Function:		Mark a value as calculated (nothing to do).
+	void Mark(uint8_t /* mask */)
+	{
+	}
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Invalidate all the values (nothing to do).
+	void Invalidate()
+	{
+	}
+};
+
+
+#endif // !_MINIQUAD_LAZY_H_
@@ -0,0 +1,84 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the unit conversions of the MPU6050 gyroscope and accelerometer for each full scale
+// range, selected at compile time. All the scale factors are constants, so the conversions
+// compile to a multiplication (float) or to shifts (fixed point) without any division.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_UNITS_H_
+#define _MINIQUAD_UNITS_H_
+
+#include <math.h>
+#include <stdint.h>
+
+
+// Class: Gyroscope units of a full scale range (MPU6050_GYRO_FS_*)
+template <uint8_t Range>
+class MiniquadGyroUnit
+{
+public:
+
+	// @Params:			(void)
+	// @Return:			A float indicating the sensitivity (LSB per degree/s, from the datasheet)
+	// @Function:		Get the sensitivity of the range: 131, 65.5, 32.8 or 16.4 for 250, 500,
+	//					1000 or 2000 degree/s.
+	static float lsbPerDegree()
+	{
+		return (Range == 0) ? 131.0f : (Range == 1) ? 65.5f : (Range == 2) ? 32.8f : 16.4f;
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the reciprocal sensitivity (degree/s per LSB)
+	// @Function:		Get the factor converting a raw rotation into degree/s.
+	static float degreePerLsb()
+	{
+		return 1.0f / lsbPerDegree();
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the reciprocal sensitivity (rad/s per LSB)
+	// @Function:		Get the factor converting a raw rotation into rad/s.
+	static float radianPerLsb()
+	{
+		return (float)M_PI / (180.0f * lsbPerDegree());
+	}
+};
+
+
+// Class: Accelerometer units of a full scale range (MPU6050_ACCEL_FS_*). The sensitivity
+//        is 16384 per g at 2g, halved by each range step and by each bit of Shift (the DMP
+//        packet carries the acceleration at half the register sensitivity, Shift = 1).
+template <uint8_t Range, uint8_t Shift>
+class MiniquadAccelUnit
+{
+public:
+
+	// Define: Sensitivity (LSB per g)
+	enum { LSB_PER_G = 16384 >> (Range + Shift) };
+
+	// @Params:			(void)
+	// @Return:			A float indicating the reciprocal sensitivity (g per LSB, a power of 2)
+	// @Function:		Get the factor converting a raw acceleration into g, which is exact.
+	static float gPerLsb()
+	{
+		return (float)(1 << (Range + Shift)) / 16384.0f;
+	}
+
+	// @Params:			value: The raw acceleration
+	// @Return:			An int32_t indicating the acceleration in Q13 (8192 per g, not saturated)
+	// @Function:		Convert a raw acceleration into Q13 by shifts, which is exact for all
+	//					ranges but the register data at 2g (loses its lowest bit).
+	static int32_t toQ13(int16_t value)
+	{
+		return ((int32_t)value * (1 << (Range + Shift))) >> 1;
+	}
+};
+
+
+#endif // !_MINIQUAD_UNITS_H_
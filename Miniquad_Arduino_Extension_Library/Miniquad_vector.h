@@ -0,0 +1,325 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is a standard library for the quadaxis copter "Miniquad Zero" (C). It includes
+// the 3D vector and quaternion templates shared by the whole library: VectorInt16,
+// VectorFloat and Quaternion of helper_3dmath.h are aliases of them, and _FloatVector_3D
+// of Miniquad_3dmath.h is built on Vec3<float>. The operations work in place and take
+// their arguments by reference, and the normalization uses the inverse square root of
+// AttitudeMath (libm, or the fast approximation under MINIQUAD_FAST_MATH).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_VECTOR_H_
+#define _MINIQUAD_VECTOR_H_
+
+#include <math.h>
+#include <stdint.h>
+#include "Miniquad_fastmath.h"
+
+
+// Class: Quaternion (w + xi + yj + zk), a unit quaternion for the rotations
+template <typename T>
+class Quat
+{
+public:
+	T w;
+	T x;
+	T y;
+	T z;
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Default constructor (identity).
+	Quat() : w(1), x(0), y(0), z(0)
+	{
+		;
+	}
+
+	// @Params:			nw, nx, ny, nz: The components
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	Quat(T nw, T nx, T ny, T nz) : w(nw), x(nx), y(ny), z(nz)
+	{
+		;
+	}
+
+	// @Params:			q: The right-hand quaternion
+	// @Return:			A Quat indicating the product this * q
+	// @Function:		Get the quaternion product.
+	Quat getProduct(const Quat& q) const
+	{
+		// (Q1 * Q2).w = (w1w2 - x1x2 - y1y2 - z1z2)
+		// (Q1 * Q2).x = (w1x2 + x1w2 + y1z2 - z1y2)
+		// (Q1 * Q2).y = (w1y2 - x1z2 + y1w2 + z1x2)
+		// (Q1 * Q2).z = (w1z2 + x1y2 - y1x2 + z1w2)
+		return Quat(
+			w*q.w - x*q.x - y*q.y - z*q.z,
+			w*q.x + x*q.w + y*q.z - z*q.y,
+			w*q.y - x*q.z + y*q.w + z*q.x,
+			w*q.z + x*q.y - y*q.x + z*q.w);
+	}
+
+	// @Params:			q: The right-hand quaternion
+	// @Return:			A Quat& (!Reference) indicating itself
+	// @Function:		Multiply by a quaternion in place (this = this * q).
+	Quat& operator*=(const Quat& q)
+	{
+		T nw = w*q.w - x*q.x - y*q.y - z*q.z;
+		T nx = w*q.x + x*q.w + y*q.z - z*q.y;
+		T ny = w*q.y - x*q.z + y*q.w + z*q.x;
+		z = w*q.z + x*q.y - y*q.x + z*q.w;
+		w = nw;
+		x = nx;
+		y = ny;
+		return *this;
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quat indicating the conjugate
+	// @Function:		Get the conjugate (the inverse rotation of a unit quaternion).
+	Quat getConjugate() const
+	{
+		return Quat(w, -x, -y, -z);
+	}
+
+	// @Params:			(void)
+	// @Return:			(Effect on itself)
+	// @Function:		Conjugate the quaternion in place.
+	void conjugate()
+	{
+		x = -x;
+		y = -y;
+		z = -z;
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the squared magnitude
+	// @Function:		Get the squared magnitude (no square root).
+	float getMagnitudeSquared() const
+	{
+		return (float)w*w + (float)x*x + (float)y*y + (float)z*z;
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the magnitude
+	// @Function:		Get the magnitude.
+	float getMagnitude() const
+	{
+		return sqrt(getMagnitudeSquared());
+	}
+
+	// @Params:			(void)
+	// @Return:			(Effect on itself)
+	// @Function:		Normalize the quaternion by the inverse square root of AttitudeMath (a zero
+	//					quaternion is left unchanged).
+	void normalize()
+	{
+		float m2 = getMagnitudeSquared();
+		if (m2 <= 0.0f) return;
+		float r = AttitudeMath::invSqrt(m2);
+		w = (T)(w * r);
+		x = (T)(x * r);
+		y = (T)(y * r);
+		z = (T)(z * r);
+	}
+
+	// @Params:			(void)
+	// @Return:			A Quat indicating the normalized quaternion
+	// @Function:		Get a normalized quaternion in respect to this.
+	Quat getNormalized() const
+	{
+		Quat r(*this);
+		r.normalize();
+		return r;
+	}
+
+	// @Params:			v: The vector (3 components, Effect on it)
+	// @Return:			(void)
+	// @Function:		Rotate a vector in place, the same as q * [0, v] * conj(q) for a unit
+	//					quaternion, in the cross-product form with u = [x, y, z]:
+	//						t = 2 * (u x v), v' = v + w * t + u x t
+	//					(15 multiplications instead of the 32 of two products).
+	void rotateVector(T* v) const
+	{
+		T tx = y*v[2] - z*v[1];
+		T ty = z*v[0] - x*v[2];
+		T tz = x*v[1] - y*v[0];
+		tx += tx;
+		ty += ty;
+		tz += tz;
+		v[0] += w*tx + y*tz - z*ty;
+		v[1] += w*ty + z*tx - x*tz;
+		v[2] += w*tz + x*ty - y*tx;
+	}
+
+	// @Params:			m: The container for the matrix (9 components, row-major)
+	// @Return:			(void)
+	// @Function:		Get the rotation matrix of the unit quaternion (12 multiplications), m * v
+	//					equals q * [0, v] * conj(q).
+	void getRotationMatrix(T* m) const
+	{
+		T xx = x*x, yy = y*y, zz = z*z;
+		T xy = x*y, xz = x*z, yz = y*z;
+		T wx = w*x, wy = w*y, wz = w*z;
+		m[0] = 1 - 2*(yy + zz); m[1] = 2*(xy - wz);     m[2] = 2*(xz + wy);
+		m[3] = 2*(xy + wz);     m[4] = 1 - 2*(xx + zz); m[5] = 2*(yz - wx);
+		m[6] = 2*(xz - wy);     m[7] = 2*(yz + wx);     m[8] = 1 - 2*(xx + yy);
+	}
+
+	// @Params:			m: The rotation matrix of getRotationMatrix()
+	//					v: The vector (3 components, Effect on it)
+	// @Return:			(void)
+	// @Function:		Rotate a vector in place by a rotation matrix (9 multiplications).
+	static void rotateVector(const T* m, T* v)
+	{
+		T vx = v[0], vy = v[1], vz = v[2];
+		v[0] = m[0]*vx + m[1]*vy + m[2]*vz;
+		v[1] = m[3]*vx + m[4]*vy + m[5]*vz;
+		v[2] = m[6]*vx + m[7]*vy + m[8]*vz;
+	}
+
+	// @Params:			v: The vectors stored as [x0, y0, z0, x1, ...] (Effect on them)
+	//					count: Count of the vectors
+	// @Return:			(void)
+	// @Function:		Rotate several vectors in place, expanding the rotation matrix only once.
+	void rotateVectors(T* v, uint16_t count) const
+	{
+		T m[9];
+		getRotationMatrix(m);
+		for (; count > 0; count--, v += 3) rotateVector(m, v);
+	}
+};
+
+
+// Class: 3D vector
+template <typename T>
+class Vec3
+{
+public:
+	T x;
+	T y;
+	T z;
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Default constructor (zero vector).
+	Vec3() : x(0), y(0), z(0)
+	{
+		;
+	}
+
+	// @Params:			nx, ny, nz: The components
+	// @Return:			(void)
+	// @Function:		The constructor with initialization.
+	Vec3(T nx, T ny, T nz) : x(nx), y(ny), z(nz)
+	{
+		;
+	}
+
+	// @Params:			v: The vector to add
+	// @Return:			A Vec3& (!Reference) indicating itself
+	// @Function:		Add a vector in place.
+	Vec3& operator+=(const Vec3& v)
+	{
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		return *this;
+	}
+
+	// @Params:			v: The vector to subtract
+	// @Return:			A Vec3& (!Reference) indicating itself
+	// @Function:		Subtract a vector in place.
+	Vec3& operator-=(const Vec3& v)
+	{
+		x -= v.x;
+		y -= v.y;
+		z -= v.z;
+		return *this;
+	}
+
+	// @Params:			s: The scale
+	// @Return:			A Vec3& (!Reference) indicating itself
+	// @Function:		Scale the vector in place (the integer vectors are truncated).
+	Vec3& operator*=(float s)
+	{
+		x = (T)(x * s);
+		y = (T)(y * s);
+		z = (T)(z * s);
+		return *this;
+	}
+
+	// @Params:			v: The other vector
+	// @Return:			A float indicating the dot product
+	// @Function:		Get the dot product.
+	float dot(const Vec3& v) const
+	{
+		return (float)x*v.x + (float)y*v.y + (float)z*v.z;
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the squared magnitude
+	// @Function:		Get the squared magnitude (no square root, no overflow for int16_t).
+	float getMagnitudeSquared() const
+	{
+		return dot(*this);
+	}
+
+	// @Params:			(void)
+	// @Return:			A float indicating the magnitude
+	// @Function:		Get the magnitude.
+	float getMagnitude() const
+	{
+		return sqrt(getMagnitudeSquared());
+	}
+
+	// @Params:			(void)
+	// @Return:			(Effect on itself)
+	// @Function:		Normalize the vector by the inverse square root of AttitudeMath (a zero vector
+	//					is left unchanged).
+	void normalize()
+	{
+		float m2 = getMagnitudeSquared();
+		if (m2 > 0.0f) *this *= AttitudeMath::invSqrt(m2);
+	}
+
+	// @Params:			(void)
+	// @Return:			A Vec3 indicating the normalized vector
+	// @Function:		Get a normalized vector in respect to this.
+	Vec3 getNormalized() const
+	{
+		Vec3 r(*this);
+		r.normalize();
+		return r;
+	}
+
+	// @Params:			q: The rotation quaternion (unit quaternion)
+	// @Return:			(Effect on itself)
+	// @Function:		Rotate the vector (q * v * conj(q), in float, the integer vectors are
+	//					truncated).
+	void rotate(const Quat<float>* q)
+	{
+		float v[3] = { (float)x, (float)y, (float)z };
+		q -> rotateVector(v);
+		x = (T)v[0];
+		y = (T)v[1];
+		z = (T)v[2];
+	}
+
+	// @Params:			q: The rotation quaternion (unit quaternion)
+	// @Return:			A Vec3 indicating the rotated vector
+	// @Function:		Get a rotated vector in respect to this.
+	Vec3 getRotated(const Quat<float>* q) const
+	{
+		Vec3 r(*this);
+		r.rotate(q);
+		return r;
+	}
+};
+
+
+#endif // !_MINIQUAD_VECTOR_H_
@@ -0,0 +1,139 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the micro-benchmark harness of the host tools of the quadaxis copter "Miniquad
+// Zero" (C). A kernel is a function running its operation a given count of times. The
+// harness sizes the count so that one repetition lasts at least the minimum time, runs
+// the warm-up repetitions, times the measured repetitions and reports the percentiles of
+// the time per operation (nanoseconds) over the repetitions.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_BENCHMARK_H_
+#define _MINIQUAD_BENCHMARK_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+// Define: Largest count of operations of one repetition (the calibration stops there)
+#define MINIQUAD_BENCH_MAX_ITERATIONS (1u << 30)
+
+
+// Type: Kernel of a benchmark, running its operation count times
+typedef void (*MiniquadBenchKernel)(uint32_t count);
+
+
+// Struct: Options of the measurement
+struct MiniquadBenchOptions
+{
+	uint16_t warmup;			// Count of the repetitions run before the measurement
+	uint16_t repetitions;		// Count of the measured repetitions
+	uint32_t minTime;			// Minimum duration of a repetition (microseconds)
+};
+
+
+// Struct: Result of a benchmark (time per operation in nanoseconds)
+struct MiniquadBenchResult
+{
+	const char* name;			// The name of the kernel
+	uint32_t iterations;		// Count of the operations per repetition
+	uint16_t repetitions;		// Count of the measured repetitions
+	double min;					// The fastest repetition
+	double p50;					// The median
+	double p90;
+	double p99;
+	double max;					// The slowest repetition
+	double mean;
+};
+
+
+// @Params:			kernel: The kernel
+//					iterations: The count of the operations
+// @Return:			A double indicating the elapsed time (nanoseconds)
+// @Function:		Time one repetition of a kernel on the monotonic clock.
+inline double MiniquadBenchTime(MiniquadBenchKernel kernel, uint32_t iterations)
+{
+	timespec start, stop;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	kernel(iterations);
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	return (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+}
+
+
+// @Params:			sorted: The times per operation in ascending order (not empty)
+//					percent: The percentile (0 ~ 100)
+// @Return:			A double indicating the percentile (nearest rank)
+// @Function:		Get a percentile of the measured repetitions.
+inline double MiniquadBenchPercentile(const std::vector<double>& sorted, double percent)
+{
+	size_t rank = (size_t)(percent / 100 * sorted.size() + 0.999999);
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+	return sorted[rank - 1];
+}
+
+
+// @Params:			name: The name of the kernel
+//					kernel: The kernel
+//					options: The options of the measurement
+// @Return:			A MiniquadBenchResult indicating the time per operation of the kernel
+// @Function:		Calibrate, warm up and measure a kernel.
+inline MiniquadBenchResult MiniquadBenchRun(const char* name, MiniquadBenchKernel kernel,
+	const MiniquadBenchOptions& options)
+{
+	// Double the operations until a repetition lasts the minimum time
+	uint32_t iterations = 16;
+	while (iterations < MINIQUAD_BENCH_MAX_ITERATIONS &&
+		MiniquadBenchTime(kernel, iterations) < options.minTime * 1e3)
+	{
+		iterations *= 2;
+	}
+
+	// Warm up the caches and the branch predictors
+	for (uint16_t i = 0; i < options.warmup; i++) MiniquadBenchTime(kernel, iterations);
+
+	// Measure
+	std::vector<double> times;
+	double sum = 0;
+	uint16_t repetitions = (options.repetitions > 0) ? options.repetitions : 1;
+	for (uint16_t i = 0; i < repetitions; i++)
+	{
+		double time = MiniquadBenchTime(kernel, iterations) / iterations;
+		times.push_back(time);
+		sum += time;
+	}
+	std::sort(times.begin(), times.end());
+
+	// Summarize the repetitions
+	MiniquadBenchResult result;
+	result.name = name;
+	result.iterations = iterations;
+	result.repetitions = repetitions;
+	result.min = times.front();
+	result.p50 = MiniquadBenchPercentile(times, 50);
+	result.p90 = MiniquadBenchPercentile(times, 90);
+	result.p99 = MiniquadBenchPercentile(times, 99);
+	result.max = times.back();
+	result.mean = sum / repetitions;
+	return result;
+}
+
+
+// @Params:			value: The result of an operation
+// @Return:			(void)
+// @Function:		Keep the result of an operation, so that the compiler neither removes the
+//					operation nor moves it out of the loop of the kernel.
+template <typename T>
+inline void MiniquadBenchKeep(T& value)
+{
+	__asm__ __volatile__ ("" : : "g"(&value) : "memory");
+}
+
+
+#endif // !_MINIQUAD_BENCHMARK_H_
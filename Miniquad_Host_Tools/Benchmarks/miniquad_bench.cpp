@@ -0,0 +1,987 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the micro-benchmark suite of the Miniquad Arduino Extension Library of the
+// quadaxis copter "Miniquad Zero" (C), built on Linux with the Arduino shim (see
+// Miniquad_benchmark.h and ReadMe.txt). It times the 3D math (helper_3dmath.h,
+// Miniquad_3dmath.h, Miniquad_fixmath.h), the attitude estimators of the raw mode, the DMP
+// packet decoders of the MPU6050 and the getters of Miniquad on a fresh sample, and reports
+// the time per operation as a table, CSV or JSON. With a baseline (CSV of an earlier run)
+// the medians slower than the threshold are reported as regressions. With --accuracy it reports instead the max and
+// mean errors of the fixed-point kernels and of the getters against the float math.
+//
+// The library configuration comes from Miniquad.h and the defines of the build
+// (BENCH_DEFINES of the Makefile, e.g. -DMINIQUAD_FAST_MATH or -DMINIQUAD_FIXED_POINT),
+// and it is reported with the results. The times are host times: they rank the kernels
+// and show the regressions, they are not the times of the ATmega328.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Miniquad_benchmark.h"
+#include <Wire.h>
+#include <EEPROM.h>
+#include "Miniquad.h"
+
+// Define: Count of the prepared inputs of each kind (power of 2, cycled by the kernels)
+#define MINIQUAD_BENCH_INPUTS (256)
+#define MINIQUAD_BENCH_INPUT_MASK (MINIQUAD_BENCH_INPUTS - 1)
+
+// Define: Size of the DMP packets of the inputs (quaternion, gyro and acceleration)
+#define MINIQUAD_BENCH_PACKET_SIZE (42)
+
+// Define: Count of the vectors rotated together by _FloatVector_3D::RotateAll()
+#define MINIQUAD_BENCH_ROTATE_ALL (4)
+
+// Define: Library configuration of the build (reported with the results)
+#ifdef MINIQUAD_FIXED_POINT
+#define MINIQUAD_BENCH_CONFIG_POINT "fixed"
+#else
+#define MINIQUAD_BENCH_CONFIG_POINT "float"
+#endif // MINIQUAD_FIXED_POINT
+#if defined(MINIQUAD_FAST_MATH_TABLE) && defined(MINIQUAD_FAST_MATH)
+#define MINIQUAD_BENCH_CONFIG_MATH "-fastmath-table"
+#elif defined(MINIQUAD_FAST_MATH)
+#define MINIQUAD_BENCH_CONFIG_MATH "-fastmath"
+#else
+#define MINIQUAD_BENCH_CONFIG_MATH ""
+#endif // MINIQUAD_FAST_MATH
+#ifdef MINIQUAD_DMP_KEEP_DATA
+#define MINIQUAD_BENCH_CONFIG_KEEP ""
+#else
+#define MINIQUAD_BENCH_CONFIG_KEEP "-nokeep"
+#endif // MINIQUAD_DMP_KEEP_DATA
+#define MINIQUAD_BENCH_CONFIG MINIQUAD_BENCH_CONFIG_POINT MINIQUAD_BENCH_CONFIG_MATH MINIQUAD_BENCH_CONFIG_KEEP
+
+
+// Global: Inputs of the kernels (random attitudes, sensor samples and their DMP packets)
+static Quaternion quaternions[MINIQUAD_BENCH_INPUTS];
+static Quaternion unnormalized[MINIQUAD_BENCH_INPUTS];
+static QuaternionQ14 quaternionsQ14[MINIQUAD_BENCH_INPUTS];
+static VectorInt16 accelerations[MINIQUAD_BENCH_INPUTS];
+static VectorInt16 rotations[MINIQUAD_BENCH_INPUTS];
+static VectorFloat floatVectors[MINIQUAD_BENCH_INPUTS];
+static _FloatVector_3D vectors[MINIQUAD_BENCH_INPUTS];
+static uint8_t packets[MINIQUAD_BENCH_INPUTS][MINIQUAD_BENCH_PACKET_SIZE];
+
+// Global: The MPU6050 of the decoders (not connected, the decoders only read the packets)
+static MPU6050 mpu;
+
+
+// Class: Miniquad fed with the prepared samples instead of the FIFO
+class BenchMiniquad : public Miniquad
+{
+public:
+
+	// @Params:			index: The index of the prepared sample
+	// @Return:			(void)
+	// @Function:		Publish a prepared sample as if it had been read from the FIFO.
+	void Publish(uint32_t index)
+	{
+		index &= MINIQUAD_BENCH_INPUT_MASK;
+		_publishSample(quaternions[index], quaternionsQ14[index], accelerations[index], rotations[index], index);
+	}
+};
+
+static BenchMiniquad copter;
+
+
+// @Params:			(void)
+// @Return:			A float indicating a random number in [-1, 1]
+// @Function:		Draw the inputs (fixed seed, the same inputs at each run).
+static float Random()
+{
+	return (float)rand() / RAND_MAX * 2 - 1;
+}
+
+
+// @Params:			bytes: The destination (4 bytes, big-endian)
+//					value: The value
+// @Return:			(void)
+// @Function:		Write an int32 into a DMP packet.
+static void WriteInt32(uint8_t* bytes, int32_t value)
+{
+	bytes[0] = (uint8_t)(value >> 24);
+	bytes[1] = (uint8_t)(value >> 16);
+	bytes[2] = (uint8_t)(value >> 8);
+	bytes[3] = (uint8_t)value;
+}
+
+
+// @Params:			(void)
+// @Return:			(The inputs)
+// @Function:		Prepare the inputs of the kernels: unit quaternions, the raw acceleration of
+//					the gravity plus up to 0.5g (DMP scale, 8192 per g), the raw rotation up to
+//					500 degree/s (2000 degree/s range) and the DMP packets holding them.
+static void PrepareInputs()
+{
+	srand(2013);
+	for (int i = 0; i < MINIQUAD_BENCH_INPUTS; i++)
+	{
+		Quaternion q(Random(), Random(), Random(), Random());
+		q.normalize();
+		quaternions[i] = q;
+		unnormalized[i] = Quaternion(q.w * 1.02f, q.x * 1.02f, q.y * 1.02f, q.z * 1.02f);
+
+		float m[9];
+		q.getRotationMatrix(m);
+		accelerations[i] = VectorInt16(
+			(int16_t)((m[6] + Random() * 0.5f) * 8192),
+			(int16_t)((m[7] + Random() * 0.5f) * 8192),
+			(int16_t)((m[8] + Random() * 0.5f) * 8192));
+		rotations[i] = VectorInt16((int16_t)(Random() * 8192), (int16_t)(Random() * 8192), (int16_t)(Random() * 8192));
+		floatVectors[i] = VectorFloat(Random(), Random(), Random());
+		vectors[i] = _FloatVector_3D(Random(), Random(), Random());
+
+		uint8_t* packet = packets[i];
+		memset(packet, 0, MINIQUAD_BENCH_PACKET_SIZE);
+		WriteInt32(packet, (int32_t)(q.w * 1073741823.0f));
+		WriteInt32(packet + 4, (int32_t)(q.x * 1073741823.0f));
+		WriteInt32(packet + 8, (int32_t)(q.y * 1073741823.0f));
+		WriteInt32(packet + 12, (int32_t)(q.z * 1073741823.0f));
+		WriteInt32(packet + 16, (int32_t)rotations[i].x << 16);
+		WriteInt32(packet + 20, (int32_t)rotations[i].y << 16);
+		WriteInt32(packet + 24, (int32_t)rotations[i].z << 16);
+		WriteInt32(packet + 28, (int32_t)accelerations[i].x << 16);
+		WriteInt32(packet + 32, (int32_t)accelerations[i].y << 16);
+		WriteInt32(packet + 36, (int32_t)accelerations[i].z << 16);
+		quaternionsQ14[i].setFromPacket(packet);
+	}
+	copter.Publish(0);
+}
+
+
+// Kernels: Reference (the loop, the input selection and the kept result)
+
+static void BenchLoop(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q = quaternions[i & MINIQUAD_BENCH_INPUT_MASK];
+		MiniquadBenchKeep(q);
+	}
+}
+
+
+// Kernels: 3D math (helper_3dmath.h, Miniquad_3dmath.h, Miniquad_fastmath.h)
+
+static void BenchQuaternionProduct(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q = quaternions[i & MINIQUAD_BENCH_INPUT_MASK].getProduct(quaternions[(i + 1) & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchQuaternionNormalize(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q = unnormalized[i & MINIQUAD_BENCH_INPUT_MASK];
+		q.normalize();
+		MiniquadBenchKeep(q);
+	}
+}
+
+// @Params:			q: The quaternion (Effect on it)
+//					r: The inverse magnitude
+// @Return:			(void)
+// @Function:		Scale the quaternion as Quaternion::normalize() does.
+static void ScaleQuaternion(Quaternion& q, float r)
+{
+	q.w *= r;
+	q.x *= r;
+	q.y *= r;
+	q.z *= r;
+}
+
+static void BenchQuaternionNormalizeStandard(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q = unnormalized[i & MINIQUAD_BENCH_INPUT_MASK];
+		ScaleQuaternion(q, StandardMath::invSqrt(q.getMagnitudeSquared()));
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchQuaternionNormalizeFast(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q = unnormalized[i & MINIQUAD_BENCH_INPUT_MASK];
+		ScaleQuaternion(q, FastMath::invSqrt(q.getMagnitudeSquared()));
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchQuaternionRotationMatrix(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		float m[9];
+		quaternions[i & MINIQUAD_BENCH_INPUT_MASK].getRotationMatrix(m);
+		MiniquadBenchKeep(m);
+	}
+}
+
+static void BenchQuaternionRotateMatrix(uint32_t count)
+{
+	float m[9];
+	quaternions[0].getRotationMatrix(m);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		_FloatVector_3D v = vectors[i & MINIQUAD_BENCH_INPUT_MASK];
+		Quaternion::rotateVector(m, v.GetArray());
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchVectorInt16Rotate(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorInt16 v = accelerations[i & MINIQUAD_BENCH_INPUT_MASK];
+		v.rotate(&quaternions[(i + 1) & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchVectorFloatRotate(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorFloat v = floatVectors[i & MINIQUAD_BENCH_INPUT_MASK];
+		v.rotate(&quaternions[(i + 1) & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchFloatVectorNormalize(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		_FloatVector_3D v = vectors[i & MINIQUAD_BENCH_INPUT_MASK];
+		v.Normalize();
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchFloatVectorMagnitude(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		float magnitude = vectors[i & MINIQUAD_BENCH_INPUT_MASK].GetMagnitude();
+		MiniquadBenchKeep(magnitude);
+	}
+}
+
+static void BenchFloatVectorRotate(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		_FloatVector_3D v = vectors[i & MINIQUAD_BENCH_INPUT_MASK];
+		v.Rotate(&quaternions[(i + 1) & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchFloatVectorRotateAll(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		_FloatVector_3D v[MINIQUAD_BENCH_ROTATE_ALL];
+		for (int k = 0; k < MINIQUAD_BENCH_ROTATE_ALL; k++) v[k] = vectors[(i + k) & MINIQUAD_BENCH_INPUT_MASK];
+		_FloatVector_3D::RotateAll(v, MINIQUAD_BENCH_ROTATE_ALL, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchAtan2(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Quaternion& q = quaternions[i & MINIQUAD_BENCH_INPUT_MASK];
+		float angle = AttitudeMath::atan2(q.x, q.w);
+		MiniquadBenchKeep(angle);
+	}
+}
+
+static void BenchAsin(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		float angle = AttitudeMath::asin(quaternions[i & MINIQUAD_BENCH_INPUT_MASK].x);
+		MiniquadBenchKeep(angle);
+	}
+}
+
+
+// Kernels: Fixed-point math (Miniquad_fixmath.h)
+
+static void BenchQ14Gravity(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorQ14 gravity;
+		quaternionsQ14[i & MINIQUAD_BENCH_INPUT_MASK].getGravity(gravity);
+		MiniquadBenchKeep(gravity);
+	}
+}
+
+static void BenchQ14Rotate(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const VectorInt16& a = accelerations[i & MINIQUAD_BENCH_INPUT_MASK];
+		VectorQ13 v(a.x, a.y, a.z);
+		quaternionsQ14[(i + 1) & MINIQUAD_BENCH_INPUT_MASK].rotate(v);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchQ14YawPitchRoll(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		int16_t ypr[3];
+		quaternionsQ14[i & MINIQUAD_BENCH_INPUT_MASK].getYawPitchRoll(ypr);
+		MiniquadBenchKeep(ypr);
+	}
+}
+
+
+// Kernels: Attitude estimators of the raw mode (Miniquad_attitude.h, 500 Hz samples)
+
+static void BenchMahonyUpdate(uint32_t count)
+{
+	static MahonyEstimator estimator(MINIQUAD_RAW_MAHONY_KP, MINIQUAD_RAW_MAHONY_KI);
+	const float rotationScale = Miniquad::GyroUnit::radianPerLsb();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const VectorInt16& g = rotations[i & MINIQUAD_BENCH_INPUT_MASK];
+		const VectorInt16& a = accelerations[i & MINIQUAD_BENCH_INPUT_MASK];
+		estimator.Update(g.x * rotationScale, g.y * rotationScale, g.z * rotationScale, a.x, a.y, a.z, 0.002f);
+		MiniquadBenchKeep(estimator.GetQuaternion());
+	}
+}
+
+static void BenchMadgwickUpdate(uint32_t count)
+{
+	static MadgwickEstimator estimator(MINIQUAD_RAW_MADGWICK_BETA);
+	const float rotationScale = Miniquad::GyroUnit::radianPerLsb();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const VectorInt16& g = rotations[i & MINIQUAD_BENCH_INPUT_MASK];
+		const VectorInt16& a = accelerations[i & MINIQUAD_BENCH_INPUT_MASK];
+		estimator.Update(g.x * rotationScale, g.y * rotationScale, g.z * rotationScale, a.x, a.y, a.z, 0.002f);
+		MiniquadBenchKeep(estimator.GetQuaternion());
+	}
+}
+
+
+// Kernels: DMP packet decoders (MPU6050_6Axis_MotionApps20.h, Miniquad_fixmath.h)
+
+static void BenchDmpQuaternionInt16(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		int16_t q[4];
+		mpu.dmpGetQuaternion(q, packets[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchDmpQuaternion(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Quaternion q;
+		mpu.dmpGetQuaternion(&q, packets[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchDmpQuaternionQ14(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		QuaternionQ14 q;
+		q.setFromPacket(packets[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(q);
+	}
+}
+
+static void BenchDmpAccel(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorInt16 v;
+		mpu.dmpGetAccel(&v, packets[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchDmpGyro(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		int16_t v[3];
+		mpu.dmpGetGyro(v, packets[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchDmpGravity(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorFloat gravity;
+		mpu.dmpGetGravity(&gravity, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(gravity);
+	}
+}
+
+static void BenchDmpEuler(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		float euler[3];
+		mpu.dmpGetEuler(euler, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(euler);
+	}
+}
+
+static void BenchDmpYawPitchRoll(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorFloat gravity;
+		float ypr[3];
+		mpu.dmpGetGravity(&gravity, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		mpu.dmpGetYawPitchRoll(ypr, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK], &gravity);
+		MiniquadBenchKeep(ypr);
+	}
+}
+
+static void BenchDmpLinearAccel(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorFloat gravity;
+		VectorInt16 v;
+		mpu.dmpGetGravity(&gravity, &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		mpu.dmpGetLinearAccel(&v, &accelerations[i & MINIQUAD_BENCH_INPUT_MASK], &gravity);
+		MiniquadBenchKeep(v);
+	}
+}
+
+static void BenchDmpLinearAccelInWorld(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		VectorInt16 v;
+		mpu.dmpGetLinearAccelInWorld(&v, &accelerations[i & MINIQUAD_BENCH_INPUT_MASK], &quaternions[i & MINIQUAD_BENCH_INPUT_MASK]);
+		MiniquadBenchKeep(v);
+	}
+}
+
+
+// Kernels: Miniquad getters on a fresh sample (the publication included, see Miniquad::publish)
+
+static void BenchMiniquadPublish(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+	}
+}
+
+static void BenchMiniquadRotation(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetRotation());
+	}
+}
+
+static void BenchMiniquadRotationMatrix(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		float* m = copter.GetRotationMatrix();
+		MiniquadBenchKeep(m);
+	}
+}
+
+static void BenchMiniquadEulerAngle(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetEulerAngle());
+	}
+}
+
+static void BenchMiniquadGravity(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetGravity());
+	}
+}
+
+static void BenchMiniquadYawPitchRoll(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetYawPitchRoll());
+	}
+}
+
+static void BenchMiniquadLinearAcceleration(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetLinearAcceleration());
+	}
+}
+
+static void BenchMiniquadWorldAcceleration(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetWorldAcceleration());
+	}
+}
+
+static void BenchMiniquadAll(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		copter.Publish(i);
+		MiniquadBenchKeep(copter.GetRotation());
+		MiniquadBenchKeep(copter.GetEulerAngle());
+		MiniquadBenchKeep(copter.GetYawPitchRoll());
+		MiniquadBenchKeep(copter.GetWorldAcceleration());
+		MiniquadBenchKeep(copter.GetLinearAcceleration());
+		MiniquadBenchKeep(copter.GetGravity());
+	}
+}
+
+static void BenchMiniquadCached(uint32_t count)
+{
+	copter.Publish(0);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		MiniquadBenchKeep(copter.GetYawPitchRoll());
+	}
+}
+
+
+// Global: The benchmarks in the order of the report
+static const struct
+{
+	const char* name;
+	MiniquadBenchKernel kernel;
+}
+benchmarks[] =
+{
+	{ "loop", BenchLoop },
+	{ "Quaternion::getProduct", BenchQuaternionProduct },
+	{ "Quaternion::normalize", BenchQuaternionNormalize },
+	{ "Quaternion::normalize(libm)", BenchQuaternionNormalizeStandard },
+	{ "Quaternion::normalize(fast)", BenchQuaternionNormalizeFast },
+	{ "Quaternion::getRotationMatrix", BenchQuaternionRotationMatrix },
+	{ "Quaternion::rotateVector(matrix)", BenchQuaternionRotateMatrix },
+	{ "VectorInt16::rotate", BenchVectorInt16Rotate },
+	{ "VectorFloat::rotate", BenchVectorFloatRotate },
+	{ "_FloatVector_3D::Normalize", BenchFloatVectorNormalize },
+	{ "_FloatVector_3D::GetMagnitude", BenchFloatVectorMagnitude },
+	{ "_FloatVector_3D::Rotate", BenchFloatVectorRotate },
+	{ "_FloatVector_3D::RotateAll(4)", BenchFloatVectorRotateAll },
+	{ "AttitudeMath::atan2", BenchAtan2 },
+	{ "AttitudeMath::asin", BenchAsin },
+	{ "QuaternionQ14::getGravity", BenchQ14Gravity },
+	{ "QuaternionQ14::rotate", BenchQ14Rotate },
+	{ "QuaternionQ14::getYawPitchRoll", BenchQ14YawPitchRoll },
+	{ "MahonyEstimator::Update", BenchMahonyUpdate },
+	{ "MadgwickEstimator::Update", BenchMadgwickUpdate },
+	{ "MPU6050::dmpGetQuaternion(int16)", BenchDmpQuaternionInt16 },
+	{ "MPU6050::dmpGetQuaternion(float)", BenchDmpQuaternion },
+	{ "QuaternionQ14::setFromPacket", BenchDmpQuaternionQ14 },
+	{ "MPU6050::dmpGetAccel", BenchDmpAccel },
+	{ "MPU6050::dmpGetGyro", BenchDmpGyro },
+	{ "MPU6050::dmpGetGravity", BenchDmpGravity },
+	{ "MPU6050::dmpGetEuler", BenchDmpEuler },
+	{ "MPU6050::dmpGetYawPitchRoll", BenchDmpYawPitchRoll },
+	{ "MPU6050::dmpGetLinearAccel", BenchDmpLinearAccel },
+	{ "MPU6050::dmpGetLinearAccelInWorld", BenchDmpLinearAccelInWorld },
+	{ "Miniquad::publish", BenchMiniquadPublish },
+	{ "Miniquad::GetRotation", BenchMiniquadRotation },
+	{ "Miniquad::GetRotationMatrix", BenchMiniquadRotationMatrix },
+	{ "Miniquad::GetEulerAngle", BenchMiniquadEulerAngle },
+	{ "Miniquad::GetGravity", BenchMiniquadGravity },
+	{ "Miniquad::GetYawPitchRoll", BenchMiniquadYawPitchRoll },
+	{ "Miniquad::GetLinearAcceleration", BenchMiniquadLinearAcceleration },
+	{ "Miniquad::GetWorldAcceleration", BenchMiniquadWorldAcceleration },
+	{ "Miniquad::all", BenchMiniquadAll },
+	{ "Miniquad::GetYawPitchRoll(cached)", BenchMiniquadCached }
+};
+
+
+// Define: Report formats
+#define MINIQUAD_BENCH_FORMAT_TEXT (0)
+#define MINIQUAD_BENCH_FORMAT_CSV (1)
+#define MINIQUAD_BENCH_FORMAT_JSON (2)
+
+
+// @Params:			file: The output
+//					format: The report format (MINIQUAD_BENCH_FORMAT_*)
+//					results: The results
+// @Return:			(void)
+// @Function:		Write the report of the benchmarks.
+static void WriteReport(FILE* file, int format, const std::vector<MiniquadBenchResult>& results)
+{
+	if (format == MINIQUAD_BENCH_FORMAT_CSV)
+	{
+		fprintf(file, "kernel,config,iterations,repetitions,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns\n");
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const MiniquadBenchResult& r = results[i];
+			fprintf(file, "%s,%s,%u,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", r.name, MINIQUAD_BENCH_CONFIG,
+				r.iterations, r.repetitions, r.min, r.p50, r.p90, r.p99, r.max, r.mean);
+		}
+	}
+	else if (format == MINIQUAD_BENCH_FORMAT_JSON)
+	{
+		fprintf(file, "{\n  \"config\": \"%s\",\n  \"unit\": \"ns\",\n  \"results\": [\n", MINIQUAD_BENCH_CONFIG);
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const MiniquadBenchResult& r = results[i];
+			fprintf(file, "    { \"kernel\": \"%s\", \"iterations\": %u, \"repetitions\": %u, "
+				"\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f }%s\n",
+				r.name, r.iterations, r.repetitions, r.min, r.p50, r.p90, r.p99, r.max, r.mean,
+				(i + 1 < results.size()) ? "," : "");
+		}
+		fprintf(file, "  ]\n}\n");
+	}
+	else
+	{
+		fprintf(file, "# configuration %s, nanoseconds per operation\n", MINIQUAD_BENCH_CONFIG);
+		fprintf(file, "%-36s %9s %9s %9s %9s %9s\n", "kernel", "min", "p50", "p90", "p99", "max");
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const MiniquadBenchResult& r = results[i];
+			fprintf(file, "%-36s %9.2f %9.2f %9.2f %9.2f %9.2f\n", r.name, r.min, r.p50, r.p90, r.p99, r.max);
+		}
+	}
+}
+
+
+// @Params:			path: The CSV report of an earlier run
+//					threshold: The tolerated slowdown of the median (percent)
+//					results: The results of this run
+// @Return:			An int indicating the count of the regressions (-1 if the baseline is unreadable)
+// @Function:		Compare the medians with a baseline of the same configuration.
+static int CompareBaseline(const char* path, double threshold, const std::vector<MiniquadBenchResult>& results)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot read the baseline %s\n", path);
+		return -1;
+	}
+
+	int regressions = 0;
+	int compared = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		char name[128], config[64];
+		double min, p50;
+		unsigned iterations, repetitions;
+		if (sscanf(line, "%127[^,],%63[^,],%u,%u,%lf,%lf", name, config, &iterations, &repetitions, &min, &p50) != 6) continue;
+		if (strcmp(config, MINIQUAD_BENCH_CONFIG) != 0) continue;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			if (strcmp(results[i].name, name) != 0) continue;
+			compared++;
+			double change = (results[i].p50 - p50) / p50 * 100;
+			if (change > threshold)
+			{
+				fprintf(stderr, "regression: %s %.2f ns -> %.2f ns (%+.1f%%)\n", name, p50, results[i].p50, change);
+				regressions++;
+			}
+		}
+	}
+	fclose(file);
+
+	fprintf(stderr, "baseline %s: %d kernels compared, %d regressions beyond %.0f%%\n", path, compared, regressions, threshold);
+	return regressions;
+}
+
+
+// Struct: Error of a getter against the double precision reference over the inputs
+struct BenchError
+{
+	const char* name;			// The name of the getter
+	const char* unit;			// The unit of the error
+	double max;					// The largest error of a component
+	double sum;					// The sum of the errors of the components (mean = sum / count)
+	uint32_t count;				// Count of the compared components
+};
+
+
+// @Params:			error: The error record (Effect on it)
+//					value: The value of the getter
+//					reference: The reference value
+//					period: The period of an angle (0 for the other values)
+// @Return:			(void)
+// @Function:		Add the error of a component, wrapped into half the period for the angles.
+static void AddError(BenchError& error, double value, double reference, double period)
+{
+	double difference = fabs(value - reference);
+	if (period > 0) difference = fmod(difference, period);
+	if (period > 0 && difference > period / 2) difference = period - difference;
+	if (difference > error.max) error.max = difference;
+	error.sum += difference;
+	error.count++;
+}
+
+
+// @Params:			index: The index of the prepared sample
+//					m: The container for the rotation matrix (9 components, double precision)
+// @Return:			(void)
+// @Function:		Calculate the reference rotation matrix of a prepared attitude, as
+//					Quaternion::getRotationMatrix() in double precision.
+static void ReferenceMatrix(uint32_t index, double* m)
+{
+	const Quaternion& q = quaternions[index];
+	double w = q.w, x = q.x, y = q.y, z = q.z;
+	m[0] = 1 - 2*(y*y + z*z); m[1] = 2*(x*y - w*z);     m[2] = 2*(x*z + w*y);
+	m[3] = 2*(x*y + w*z);     m[4] = 1 - 2*(x*x + z*z); m[5] = 2*(y*z - w*x);
+	m[6] = 2*(x*z - w*y);     m[7] = 2*(y*z + w*x);     m[8] = 1 - 2*(x*x + y*y);
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Compare the fixed-point kernels and the getters of Miniquad (of the configuration
+//					of the build) with the float math in double precision over the prepared inputs,
+//					and print the max and mean errors of each.
+static void ReportAccuracy()
+{
+	enum { QUATERNION, GRAVITY, ROTATE, YAW_PITCH_ROLL, EULER,
+		MINIQUAD_GRAVITY, MINIQUAD_YAW_PITCH_ROLL, MINIQUAD_EULER, MINIQUAD_LINEAR, MINIQUAD_WORLD, ERRORS };
+	BenchError errors[ERRORS] = {
+		{ "QuaternionQ14::setFromPacket", "1", 0, 0, 0 },
+		{ "QuaternionQ14::getGravity", "g", 0, 0, 0 },
+		{ "QuaternionQ14::rotate", "g", 0, 0, 0 },
+		{ "QuaternionQ14::getYawPitchRoll", "degree", 0, 0, 0 },
+		{ "QuaternionQ14::getEuler", "degree", 0, 0, 0 },
+		{ "Miniquad::GetGravity", "g", 0, 0, 0 },
+		{ "Miniquad::GetYawPitchRoll", "degree", 0, 0, 0 },
+		{ "Miniquad::GetEulerAngle", "degree", 0, 0, 0 },
+		{ "Miniquad::GetLinearAcceleration", "g", 0, 0, 0 },
+		{ "Miniquad::GetWorldAcceleration", "g", 0, 0, 0 }
+	};
+
+	for (uint32_t i = 0; i < MINIQUAD_BENCH_INPUTS; i++)
+	{
+		// The reference of the float math in double precision
+		double m[9];
+		ReferenceMatrix(i, m);
+		double gravity[3] = { m[6], m[7], m[8] };
+		double ypr[3] = {
+			atan2(m[1], m[0]) * (180 / M_PI),
+			atan(gravity[0] / sqrt(gravity[1]*gravity[1] + gravity[2]*gravity[2])) * (180 / M_PI),
+			atan(gravity[1] / sqrt(gravity[0]*gravity[0] + gravity[2]*gravity[2])) * (180 / M_PI) };
+		double euler[3] = {
+			atan2(m[1], m[0]) * (180 / M_PI),
+			-asin(m[2]) * (180 / M_PI),
+			atan2(m[5], m[8]) * (180 / M_PI) };
+		const VectorInt16& a = accelerations[i];
+		double raw[3] = { (double)a.x, (double)a.y, (double)a.z };
+		double linear[3], world[3], rotated[3];
+		for (int k = 0; k < 3; k++) linear[k] = raw[k] * Miniquad::AccelUnit::gPerLsb() - gravity[k];
+		for (int k = 0; k < 3; k++) world[k] = m[3*k]*linear[0] + m[3*k + 1]*linear[1] + m[3*k + 2]*linear[2];
+		for (int k = 0; k < 3; k++) rotated[k] = (m[3*k]*raw[0] + m[3*k + 1]*raw[1] + m[3*k + 2]*raw[2]) / 8192; // Q13
+
+		// The fixed-point kernels
+		const QuaternionQ14& q = quaternionsQ14[i];
+		const Quaternion& reference = quaternions[i];
+		Quaternion qFloat = q.toFloat();
+		AddError(errors[QUATERNION], qFloat.w, reference.w, 0);
+		AddError(errors[QUATERNION], qFloat.x, reference.x, 0);
+		AddError(errors[QUATERNION], qFloat.y, reference.y, 0);
+		AddError(errors[QUATERNION], qFloat.z, reference.z, 0);
+		VectorQ14 gravityQ14;
+		q.getGravity(gravityQ14);
+		VectorFloat gravityFloat = gravityQ14.toFloat();
+		AddError(errors[GRAVITY], gravityFloat.x, gravity[0], 0);
+		AddError(errors[GRAVITY], gravityFloat.y, gravity[1], 0);
+		AddError(errors[GRAVITY], gravityFloat.z, gravity[2], 0);
+		VectorQ13 rotatedQ13(a.x, a.y, a.z);
+		q.rotate(rotatedQ13);
+		VectorFloat rotatedFloat = rotatedQ13.toFloat();
+		AddError(errors[ROTATE], rotatedFloat.x, rotated[0], 0);
+		AddError(errors[ROTATE], rotatedFloat.y, rotated[1], 0);
+		AddError(errors[ROTATE], rotatedFloat.z, rotated[2], 0);
+		int16_t angles[3];
+		q.getYawPitchRoll(angles);
+		for (int k = 0; k < 3; k++) AddError(errors[YAW_PITCH_ROLL], angles[k] * 0.01, ypr[k], 360);
+		q.getEuler(angles);
+		for (int k = 0; k < 3; k++) AddError(errors[EULER], angles[k] * 0.01, euler[k], 360);
+
+		// The getters of Miniquad
+		copter.Publish(i);
+		Gravity& g = copter.GetGravity();
+		AddError(errors[MINIQUAD_GRAVITY], g.getX(), gravity[0], 0);
+		AddError(errors[MINIQUAD_GRAVITY], g.getY(), gravity[1], 0);
+		AddError(errors[MINIQUAD_GRAVITY], g.getZ(), gravity[2], 0);
+		YawPitchRoll& angle = copter.GetYawPitchRoll();
+		AddError(errors[MINIQUAD_YAW_PITCH_ROLL], angle.getYaw(), ypr[0], 360);
+		AddError(errors[MINIQUAD_YAW_PITCH_ROLL], angle.getPitch(), ypr[1], 360);
+		AddError(errors[MINIQUAD_YAW_PITCH_ROLL], angle.getRoll(), ypr[2], 360);
+		EulerAngle& e = copter.GetEulerAngle();
+		AddError(errors[MINIQUAD_EULER], e.getPsi(), euler[0], 360);
+		AddError(errors[MINIQUAD_EULER], e.getTheta(), euler[1], 360);
+		AddError(errors[MINIQUAD_EULER], e.getPhi(), euler[2], 360);
+		Acceleration& l = copter.GetLinearAcceleration();
+		AddError(errors[MINIQUAD_LINEAR], l.getX(), linear[0], 0);
+		AddError(errors[MINIQUAD_LINEAR], l.getY(), linear[1], 0);
+		AddError(errors[MINIQUAD_LINEAR], l.getZ(), linear[2], 0);
+		Acceleration& aw = copter.GetWorldAcceleration();
+		AddError(errors[MINIQUAD_WORLD], aw.getX(), world[0], 0);
+		AddError(errors[MINIQUAD_WORLD], aw.getY(), world[1], 0);
+		AddError(errors[MINIQUAD_WORLD], aw.getZ(), world[2], 0);
+	}
+
+	printf("# configuration %s, error against the float math in double precision (%d inputs)\n",
+		MINIQUAD_BENCH_CONFIG, MINIQUAD_BENCH_INPUTS);
+	printf("%-36s %12s %12s  %s\n", "getter", "max", "mean", "unit");
+	for (int k = 0; k < ERRORS; k++)
+	{
+		printf("%-36s %12.6f %12.6f  %s\n", errors[k].name, errors[k].max, errors[k].sum / errors[k].count, errors[k].unit);
+	}
+}
+
+
+// @Params:			program: The name of the program
+// @Return:			(void)
+// @Function:		Print the usage.
+static void PrintUsage(const char* program)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --filter TEXT         run the kernels whose name contains TEXT\n"
+		"  --list                list the kernels\n"
+		"  --accuracy            report the errors of the fixed-point kernels and of the\n"
+		"                        getters against the float math instead of the times\n"
+		"  --warmup N            warm-up repetitions of each kernel (default 3)\n"
+		"  --repetitions N       measured repetitions of each kernel (default 101)\n"
+		"  --min-time US         minimum duration of a repetition in microseconds (default 500)\n"
+		"  --format text|csv|json  report format (default text)\n"
+		"  --output FILE         write the report into FILE (default stdout)\n"
+		"  --baseline FILE       compare the medians with a CSV report of an earlier run,\n"
+		"                        fail on the regressions\n"
+		"  --threshold PERCENT   tolerated slowdown of a median (default 10)\n",
+		program);
+}
+
+
+int main(int argc, char** argv)
+{
+	MiniquadBenchOptions options;
+	options.warmup = 3;
+	options.repetitions = 101;
+	options.minTime = 500;
+	const char* filter = NULL;
+	const char* output = NULL;
+	const char* baseline = NULL;
+	double threshold = 10;
+	int format = MINIQUAD_BENCH_FORMAT_TEXT;
+	bool list = false;
+	bool accuracy = false;
+
+	// Parse the options
+	for (int i = 1; i < argc; i++)
+	{
+		const char* option = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (strcmp(option, "--list") == 0) { list = true; continue; }
+		if (strcmp(option, "--accuracy") == 0) { accuracy = true; continue; }
+		if (value == NULL || strncmp(option, "--", 2) != 0)
+		{
+			PrintUsage(argv[0]);
+			return 2;
+		}
+		i++;
+		if (strcmp(option, "--filter") == 0) filter = value;
+		else if (strcmp(option, "--warmup") == 0) options.warmup = (uint16_t)atoi(value);
+		else if (strcmp(option, "--repetitions") == 0) options.repetitions = (uint16_t)atoi(value);
+		else if (strcmp(option, "--min-time") == 0) options.minTime = (uint32_t)atol(value);
+		else if (strcmp(option, "--output") == 0) output = value;
+		else if (strcmp(option, "--baseline") == 0) baseline = value;
+		else if (strcmp(option, "--threshold") == 0) threshold = atof(value);
+		else if (strcmp(option, "--format") == 0 && strcmp(value, "text") == 0) format = MINIQUAD_BENCH_FORMAT_TEXT;
+		else if (strcmp(option, "--format") == 0 && strcmp(value, "csv") == 0) format = MINIQUAD_BENCH_FORMAT_CSV;
+		else if (strcmp(option, "--format") == 0 && strcmp(value, "json") == 0) format = MINIQUAD_BENCH_FORMAT_JSON;
+		else
+		{
+			PrintUsage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (list)
+	{
+		for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) printf("%s\n", benchmarks[i].name);
+		return 0;
+	}
+
+	// Run the benchmarks (or the comparison of the accuracy)
+	PrepareInputs();
+	if (accuracy)
+	{
+		ReportAccuracy();
+		return 0;
+	}
+	std::vector<MiniquadBenchResult> results;
+	for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+	{
+		if (filter != NULL && strstr(benchmarks[i].name, filter) == NULL) continue;
+		results.push_back(MiniquadBenchRun(benchmarks[i].name, benchmarks[i].kernel, options));
+	}
+
+	// Report
+	FILE* file = (output != NULL) ? fopen(output, "w") : stdout;
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot write %s\n", output);
+		return 1;
+	}
+	WriteReport(file, format, results);
+	if (file != stdout) fclose(file);
+
+	if (baseline != NULL)
+	{
+		int regressions = CompareBaseline(baseline, threshold, results);
+		if (regressions != 0) return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host library of the quadaxis copter "Miniquad Zero" (C) for the post-flight
+// analysis: the kernel selection and the scalar kernel, which uses the math of the
+// Miniquad Arduino Extension Library itself (build with MINIQUAD_FAST_MATH to follow a
+// firmware built with it). The samples short of a whole step of a SIMD kernel go through
+// the SIMD kernel on a single lane, so they take the arctangent polynomial of the lanes.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include "Miniquad_batch.h"
+#include "Miniquad_batch_kernel.h"
+#include "helper_3dmath.h"
+#include "Miniquad_fastmath.h"
+
+// Define: If the SIMD kernels are built (x86 processors)
+#if defined(__x86_64__) || defined(__i386__)
+#define MINIQUAD_BATCH_X86
+#endif
+
+
+// @Params:			log: The logged samples
+//					attitude: The containers for the converted data
+//					accelScale: The factor converting the raw acceleration into g
+//					begin, end: The range of the samples
+// @Return:			(void)
+// @Function:		Convert the samples one by one with the formulas of Miniquad::GetGravity(),
+//					GetYawPitchRoll() and GetWorldAcceleration() (float path).
+void MiniquadConvertScalar(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		// Rotation matrix of the sample (Miniquad::GetRotationMatrix())
+		Quaternion q(log.qw[i], log.qx[i], log.qy[i], log.qz[i]);
+		float m[9];
+		q.getRotationMatrix(m);
+
+		// Gravity, the last row of the rotation matrix
+		float gx = m[6];
+		float gy = m[7];
+		float gz = m[8];
+		attitude.gx[i] = gx;
+		attitude.gy[i] = gy;
+		attitude.gz[i] = gz;
+
+		// Yaw, pitch and roll angles
+		attitude.yaw[i] = (180/M_PI) * AttitudeMath::atan2(m[1], m[0]);
+		attitude.pitch[i] = (180/M_PI) * AttitudeMath::atan(gx / AttitudeMath::sqrt(gy*gy + gz*gz));
+		attitude.roll[i] = (180/M_PI) * AttitudeMath::atan(gy / AttitudeMath::sqrt(gx*gx + gz*gz));
+
+		// Linear acceleration rotated into the world frame
+		float v[3] = { log.ax[i] * accelScale - gx, log.ay[i] * accelScale - gy, log.az[i] * accelScale - gz };
+		Quaternion::rotateVector(m, v);
+		attitude.wx[i] = v[0];
+		attitude.wy[i] = v[1];
+		attitude.wz[i] = v[2];
+	}
+}
+
+
+// Struct: Lane operations of a single float (the tail of the SIMD kernels); the masks are
+//         1 where set and 0 elsewhere
+struct MiniquadLanesSingle
+{
+	typedef float Type;
+	enum { WIDTH = 1 };
+
+	static float set(float value) { return value; }
+	static float load(const float* p) { return *p; }
+	static void store(float* p, float v) { *p = v; }
+	static float add(float a, float b) { return a + b; }
+	static float sub(float a, float b) { return a - b; }
+	static float mul(float a, float b) { return a * b; }
+	static float div(float a, float b) { return a / b; }
+	static float sqrt(float a) { return sqrtf(a); }
+	static float min(float a, float b) { return (a < b) ? a : b; }
+	static float max(float a, float b) { return (a > b) ? a : b; }
+	static float abs(float a) { return fabsf(a); }
+	static float greater(float a, float b) { return (a > b) ? 1.0f : 0.0f; }
+	static float less(float a, float b) { return (a < b) ? 1.0f : 0.0f; }
+	static float select(float mask, float a, float b) { return (mask != 0.0f) ? a : b; }
+	static float loadInt16(const int16_t* p) { return (float)*p; }
+};
+
+
+bool MiniquadBatchConverter::IsKernelSupported(uint8_t kernel)
+{
+	switch (kernel)
+	{
+	case MINIQUAD_KERNEL_AUTO:
+	case MINIQUAD_KERNEL_SCALAR:
+		return true;
+#ifdef MINIQUAD_BATCH_X86
+	case MINIQUAD_KERNEL_SSE:
+		return __builtin_cpu_supports("sse2");
+	case MINIQUAD_KERNEL_AVX2:
+		return __builtin_cpu_supports("avx2");
+#endif // MINIQUAD_BATCH_X86
+	default:
+		return false;
+	}
+}
+
+
+uint8_t MiniquadBatchConverter::GetBestKernel()
+{
+	if (IsKernelSupported(MINIQUAD_KERNEL_AVX2)) return MINIQUAD_KERNEL_AVX2;
+	if (IsKernelSupported(MINIQUAD_KERNEL_SSE)) return MINIQUAD_KERNEL_SSE;
+	return MINIQUAD_KERNEL_SCALAR;
+}
+
+
+const char* MiniquadBatchConverter::GetKernelName(uint8_t kernel)
+{
+	switch (kernel)
+	{
+	case MINIQUAD_KERNEL_AUTO: return "auto";
+	case MINIQUAD_KERNEL_SCALAR: return "scalar";
+	case MINIQUAD_KERNEL_SSE: return "sse";
+	case MINIQUAD_KERNEL_AVX2: return "avx2";
+	default: return "unknown";
+	}
+}
+
+
+void MiniquadBatchConverter::Convert(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, uint8_t kernel)
+{
+	if (kernel == MINIQUAD_KERNEL_AUTO) kernel = GetBestKernel();
+	if (!IsKernelSupported(kernel)) kernel = MINIQUAD_KERNEL_SCALAR;
+
+	// The SIMD kernels take whole steps and convert the rest on a single lane
+#ifdef MINIQUAD_BATCH_X86
+	if (kernel == MINIQUAD_KERNEL_AVX2)
+	{
+		size_t done = log.count - log.count % 8;
+		MiniquadConvertAVX2(log, attitude, accelScale, 0, done);
+		MiniquadConvertLanes<MiniquadLanesSingle>(log, attitude, accelScale, done, log.count);
+		return;
+	}
+	if (kernel == MINIQUAD_KERNEL_SSE)
+	{
+		size_t done = log.count - log.count % 4;
+		MiniquadConvertSSE(log, attitude, accelScale, 0, done);
+		MiniquadConvertLanes<MiniquadLanesSingle>(log, attitude, accelScale, done, log.count);
+		return;
+	}
+#endif // MINIQUAD_BATCH_X86
+	MiniquadConvertScalar(log, attitude, accelScale, 0, log.count);
+}
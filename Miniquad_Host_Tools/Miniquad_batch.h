@@ -0,0 +1,109 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host library of the quadaxis copter "Miniquad Zero" (C) for the post-flight
+// analysis. It converts batches of logged samples (DMP quaternion and raw acceleration)
+// into the yaw, pitch and roll angles, the gravity and the world acceleration with the
+// formulas of Miniquad::GetYawPitchRoll(), GetGravity() and GetWorldAcceleration() (float
+// path). The batches are structures of arrays, converted by SSE or AVX2 kernels with a
+// portable scalar fallback.
+//
+// Tolerance of the SIMD kernels against the scalar kernel (the firmware formulas with
+// libm): 2e-4 degree for the angles (the arctangent polynomial of FastMath). The gravity
+// and the world acceleration take the same float operations in the same order and match
+// bit for bit as long as no multiply-add is contracted (the kernels are built with
+// -ffp-contract=off); the converter checks them against 1e-6 g and 1e-5 g. The samples
+// short of a whole step are converted by the SIMD kernel on a single lane, bit for bit as
+// on the lanes, so the result does not depend on the length of the batch.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_BATCH_H_
+#define _MINIQUAD_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Define: Kernels of the batch conversion
+#define MINIQUAD_KERNEL_AUTO (0)	// The fastest kernel supported by the processor
+#define MINIQUAD_KERNEL_SCALAR (1)	// Portable scalar kernel (the firmware formulas)
+#define MINIQUAD_KERNEL_SSE (2)		// SSE2 kernel, 4 samples per step
+#define MINIQUAD_KERNEL_AVX2 (3)	// AVX2 kernel, 8 samples per step
+
+
+// Struct: Batch of logged samples (structure of arrays, count entries each)
+struct MiniquadLogBatch
+{
+	size_t count;			// Count of the samples
+	const float* qw;		// The quaternion (DMP, unit quaternion)
+	const float* qx;
+	const float* qy;
+	const float* qz;
+	const int16_t* ax;		// The raw acceleration (sample units, see accelScale)
+	const int16_t* ay;
+	const int16_t* az;
+};
+
+
+// Struct: Converted attitude data of a batch (structure of arrays, count entries each)
+struct MiniquadAttitudeBatch
+{
+	float* yaw;				// The yaw, pitch and roll angles (degree)
+	float* pitch;
+	float* roll;
+	float* gx;				// The gravity components in the body frame (g)
+	float* gy;
+	float* gz;
+	float* wx;				// The world acceleration without gravity (g)
+	float* wy;
+	float* wz;
+};
+
+
+// Class: Batch conversion of the logged samples
+class MiniquadBatchConverter
+{
+public:
+
+	// @Params:			kernel: The kernel (MINIQUAD_KERNEL_*)
+	// @Return:			A bool indicating whether the kernel is built in and the processor supports it
+	// @Function:		Check a kernel before selecting it.
+	static bool IsKernelSupported(uint8_t kernel);
+
+	// @Params:			(void)
+	// @Return:			A uint8_t indicating the fastest supported kernel (MINIQUAD_KERNEL_*)
+	// @Function:		Select the kernel for MINIQUAD_KERNEL_AUTO.
+	static uint8_t GetBestKernel();
+
+	// @Params:			kernel: The kernel (MINIQUAD_KERNEL_*)
+	// @Return:			A const char* indicating the name of the kernel
+	// @Function:		Get the name of a kernel for the reports.
+	static const char* GetKernelName(uint8_t kernel);
+
+	// @Params:			log: The logged samples
+	//					attitude: The containers for the converted data (log.count entries each)
+	//					accelScale: The factor converting the raw acceleration into g
+	//								(MiniquadAccelUnit::gPerLsb(), 1 / 8192 for the DMP at 2g)
+	//					kernel: The kernel (MINIQUAD_KERNEL_*, unsupported kernels fall back to
+	//							the scalar kernel)
+	// @Return:			(void)
+	// @Function:		Convert a batch of logged samples.
+	static void Convert(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+		float accelScale, uint8_t kernel = MINIQUAD_KERNEL_AUTO);
+};
+
+
+// Kernels (ranges of samples, begin ~ end - 1)
+void MiniquadConvertScalar(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end);
+void MiniquadConvertSSE(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end);
+void MiniquadConvertAVX2(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end);
+
+
+#endif // !_MINIQUAD_BATCH_H_
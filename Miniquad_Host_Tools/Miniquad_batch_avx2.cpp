@@ -0,0 +1,60 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host library of the quadaxis copter "Miniquad Zero" (C) for the post-flight
+// analysis: the AVX2 kernel, 8 samples per step (built with -mavx2, empty elsewhere; only
+// called after the processor check of MiniquadBatchConverter).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include "Miniquad_batch_kernel.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+
+// Struct: Lane operations of AVX2 (8 floats)
+struct MiniquadLanesAVX2
+{
+	typedef __m256 Type;
+	enum { WIDTH = 8 };
+
+	static __m256 set(float value) { return _mm256_set1_ps(value); }
+	static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+	static __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+	static __m256 sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+	static __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+	static __m256 div(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+	static __m256 sqrt(__m256 a) { return _mm256_sqrt_ps(a); }
+	static __m256 min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+	static __m256 max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+	static __m256 abs(__m256 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static __m256 greater(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static __m256 less(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+	// Lanes of a where the mask is set, of b elsewhere
+	static __m256 select(__m256 mask, __m256 a, __m256 b)
+	{
+		return _mm256_blendv_ps(b, a, mask);
+	}
+
+	// 8 int16_t converted into floats (sign extended)
+	static __m256 loadInt16(const int16_t* p)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v));
+	}
+};
+
+
+void MiniquadConvertAVX2(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end)
+{
+	MiniquadConvertLanes<MiniquadLanesAVX2>(log, attitude, accelScale, begin, end);
+}
+
+#endif // __AVX2__
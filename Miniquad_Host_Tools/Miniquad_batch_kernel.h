@@ -0,0 +1,116 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host library of the quadaxis copter "Miniquad Zero" (C) for the post-flight
+// analysis: the SIMD kernel written once over the lanes of an instruction set. Each kernel
+// source defines the lane operations (Lanes::*) and instantiates the template with them.
+// The arctangent is the odd minimax polynomial of FastMath::atanOctant() with the same
+// octant reduction, evaluated on all the lanes without branches.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_BATCH_KERNEL_H_
+#define _MINIQUAD_BATCH_KERNEL_H_
+
+#include <math.h>
+#include "Miniquad_batch.h"
+
+
+// @Params:			y: The y-coordinates
+//					x: The x-coordinates
+// @Return:			The angles of (x, y) (rad, -PI ~ PI, 0 for (0, 0))
+// @Function:		Calculate atan2(y, x) on all the lanes as FastMath::atan2().
+template <class Lanes>
+typename Lanes::Type MiniquadLanesAtan2(typename Lanes::Type y, typename Lanes::Type x)
+{
+	typedef typename Lanes::Type V;
+	const V zero = Lanes::set(0.0f);
+	V ax = Lanes::abs(x);
+	V ay = Lanes::abs(y);
+
+	// Reduce to the first octant (the tangent of the smaller angle, 0 for the origin)
+	V steep = Lanes::greater(ay, ax);
+	V high = Lanes::max(ax, ay);
+	V z = Lanes::div(Lanes::min(ax, ay), high);
+	z = Lanes::select(Lanes::greater(high, zero), z, zero);
+
+	// Odd minimax polynomial of degree 11 (FastMath::atanOctant())
+	V z2 = Lanes::mul(z, z);
+	V p = Lanes::set(-0.01172120f);
+	p = Lanes::add(Lanes::mul(p, z2), Lanes::set(0.05265332f));
+	p = Lanes::add(Lanes::mul(p, z2), Lanes::set(-0.11643287f));
+	p = Lanes::add(Lanes::mul(p, z2), Lanes::set(0.19354346f));
+	p = Lanes::add(Lanes::mul(p, z2), Lanes::set(-0.33262347f));
+	p = Lanes::add(Lanes::mul(p, z2), Lanes::set(0.99997726f));
+	V angle = Lanes::mul(p, z);
+
+	// Back to the quadrants
+	angle = Lanes::select(steep, Lanes::sub(Lanes::set((float)M_PI_2), angle), angle);
+	angle = Lanes::select(Lanes::less(x, zero), Lanes::sub(Lanes::set((float)M_PI), angle), angle);
+	return Lanes::select(Lanes::less(y, zero), Lanes::sub(zero, angle), angle);
+}
+
+
+// @Params:			log: The logged samples
+//					attitude: The containers for the converted data
+//					accelScale: The factor converting the raw acceleration into g
+//					begin, end: The range of the samples (whole steps of Lanes::WIDTH)
+// @Return:			(void)
+// @Function:		Convert Lanes::WIDTH samples per step with the formulas of the scalar kernel.
+template <class Lanes>
+void MiniquadConvertLanes(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end)
+{
+	typedef typename Lanes::Type V;
+	const V one = Lanes::set(1.0f);
+	const V two = Lanes::set(2.0f);
+	const V degree = Lanes::set((float)(180/M_PI));
+	const V scale = Lanes::set(accelScale);
+
+	for (size_t i = begin; i < end; i += Lanes::WIDTH)
+	{
+		V w = Lanes::load(log.qw + i);
+		V x = Lanes::load(log.qx + i);
+		V y = Lanes::load(log.qy + i);
+		V z = Lanes::load(log.qz + i);
+
+		// Rotation matrix (Quaternion::getRotationMatrix())
+		V xx = Lanes::mul(x, x), yy = Lanes::mul(y, y), zz = Lanes::mul(z, z);
+		V xy = Lanes::mul(x, y), xz = Lanes::mul(x, z), yz = Lanes::mul(y, z);
+		V wx = Lanes::mul(w, x), wy = Lanes::mul(w, y), wz = Lanes::mul(w, z);
+		V m0 = Lanes::sub(one, Lanes::mul(two, Lanes::add(yy, zz)));
+		V m1 = Lanes::mul(two, Lanes::sub(xy, wz));
+		V m2 = Lanes::mul(two, Lanes::add(xz, wy));
+		V m3 = Lanes::mul(two, Lanes::add(xy, wz));
+		V m4 = Lanes::sub(one, Lanes::mul(two, Lanes::add(xx, zz)));
+		V m5 = Lanes::mul(two, Lanes::sub(yz, wx));
+		V gx = Lanes::mul(two, Lanes::sub(xz, wy));
+		V gy = Lanes::mul(two, Lanes::add(yz, wx));
+		V gz = Lanes::sub(one, Lanes::mul(two, Lanes::add(xx, yy)));
+		Lanes::store(attitude.gx + i, gx);
+		Lanes::store(attitude.gy + i, gy);
+		Lanes::store(attitude.gz + i, gz);
+
+		// Yaw, pitch and roll angles
+		V gxx = Lanes::mul(gx, gx), gyy = Lanes::mul(gy, gy), gzz = Lanes::mul(gz, gz);
+		V pitch = Lanes::div(gx, Lanes::sqrt(Lanes::add(gyy, gzz)));
+		V roll = Lanes::div(gy, Lanes::sqrt(Lanes::add(gxx, gzz)));
+		Lanes::store(attitude.yaw + i, Lanes::mul(degree, MiniquadLanesAtan2<Lanes>(m1, m0)));
+		Lanes::store(attitude.pitch + i, Lanes::mul(degree, MiniquadLanesAtan2<Lanes>(pitch, one)));
+		Lanes::store(attitude.roll + i, Lanes::mul(degree, MiniquadLanesAtan2<Lanes>(roll, one)));
+
+		// Linear acceleration rotated into the world frame
+		V lx = Lanes::sub(Lanes::mul(Lanes::loadInt16(log.ax + i), scale), gx);
+		V ly = Lanes::sub(Lanes::mul(Lanes::loadInt16(log.ay + i), scale), gy);
+		V lz = Lanes::sub(Lanes::mul(Lanes::loadInt16(log.az + i), scale), gz);
+		Lanes::store(attitude.wx + i, Lanes::add(Lanes::add(Lanes::mul(m0, lx), Lanes::mul(m1, ly)), Lanes::mul(m2, lz)));
+		Lanes::store(attitude.wy + i, Lanes::add(Lanes::add(Lanes::mul(m3, lx), Lanes::mul(m4, ly)), Lanes::mul(m5, lz)));
+		Lanes::store(attitude.wz + i, Lanes::add(Lanes::add(Lanes::mul(gx, lx), Lanes::mul(gy, ly)), Lanes::mul(gz, lz)));
+	}
+}
+
+
+#endif // !_MINIQUAD_BATCH_KERNEL_H_
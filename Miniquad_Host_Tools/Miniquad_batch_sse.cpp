@@ -0,0 +1,59 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host library of the quadaxis copter "Miniquad Zero" (C) for the post-flight
+// analysis: the SSE2 kernel, 4 samples per step (built with -msse2, empty elsewhere).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include "Miniquad_batch_kernel.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+
+// Struct: Lane operations of SSE2 (4 floats)
+struct MiniquadLanesSSE
+{
+	typedef __m128 Type;
+	enum { WIDTH = 4 };
+
+	static __m128 set(float value) { return _mm_set1_ps(value); }
+	static __m128 load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+	static __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+	static __m128 sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+	static __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+	static __m128 div(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+	static __m128 sqrt(__m128 a) { return _mm_sqrt_ps(a); }
+	static __m128 min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+	static __m128 max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+	static __m128 abs(__m128 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static __m128 greater(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+	static __m128 less(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
+
+	// Lanes of a where the mask is set, of b elsewhere
+	static __m128 select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	// 4 int16_t converted into floats (sign extended)
+	static __m128 loadInt16(const int16_t* p)
+	{
+		__m128i v = _mm_loadl_epi64((const __m128i*)p);
+		return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+	}
+};
+
+
+void MiniquadConvertSSE(const MiniquadLogBatch& log, const MiniquadAttitudeBatch& attitude,
+	float accelScale, size_t begin, size_t end)
+{
+	MiniquadConvertLanes<MiniquadLanesSSE>(log, attitude, accelScale, begin, end);
+}
+
+#endif // __SSE2__
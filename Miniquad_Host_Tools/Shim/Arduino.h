@@ -0,0 +1,147 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host shim of the Arduino core, so that the Miniquad Arduino Extension Library
+// builds on Linux. The time functions run on the monotonic clock of the host, or on a
+// simulated time advanced by the delays and the device models (Simulator). The pins do
+// nothing, the external interrupts are raised by the device models and the serial port is
+// discarded.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_SHIM_ARDUINO_H_
+#define _MINIQUAD_SHIM_ARDUINO_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH (1)
+#define LOW (0)
+#define INPUT (0)
+#define OUTPUT (1)
+#define CHANGE (1)
+#define FALLING (2)
+#define RISING (3)
+#define DEC (10)
+#define HEX (16)
+#define F(string) (string)
+
+
+// The minimum and maximum as templates (the macros of the core would break the C++ library)
+template <typename A, typename B> inline A min(A a, B b) { return (a < (A)b) ? a : (A)b; }
+template <typename A, typename B> inline A max(A a, B b) { return (a > (A)b) ? a : (A)b; }
+
+
+// Define: Count of the external interrupts (INT0 and INT1 of the ATmega328)
+#define MINIQUAD_SHIM_INTERRUPTS (2)
+
+
+// Global: Simulated time, which replaces the monotonic clock while it is enabled
+extern bool MiniquadShimTimeSimulated;			// Whether the time is simulated
+extern uint64_t MiniquadShimTime;				// The simulated time (microseconds)
+extern void (*MiniquadShimTimeListener)(void* context);	// Called after the simulated time advanced
+extern void* MiniquadShimTimeListenerContext;	// The context of the listener
+
+// Global: Handlers of the external interrupts (attachInterrupt())
+extern void (*MiniquadShimInterruptHandlers[MINIQUAD_SHIM_INTERRUPTS])();
+
+
+// @Params:			(void)
+// @Return:			A uint64_t indicating the time of the monotonic clock or the simulated time
+//					(microseconds)
+// @Function:		Read the clock behind millis() and micros().
+inline uint64_t MiniquadShimClock()
+{
+	if (MiniquadShimTimeSimulated) return MiniquadShimTime;
+
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+inline unsigned long millis() { return (unsigned long)(uint32_t)(MiniquadShimClock() / 1000); }
+inline unsigned long micros() { return (unsigned long)(uint32_t)MiniquadShimClock(); }
+
+
+// @Params:			us: The time to advance (microseconds)
+// @Return:			(void)
+// @Function:		Advance the simulated time and let the listener catch up with it (nothing
+//					happens on the monotonic clock).
+inline void MiniquadShimAdvance(uint64_t us)
+{
+	if (!MiniquadShimTimeSimulated) return;
+	MiniquadShimTime += us;
+	if (MiniquadShimTimeListener != 0) MiniquadShimTimeListener(MiniquadShimTimeListenerContext);
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+	if (MiniquadShimTimeSimulated) { MiniquadShimAdvance(us); return; }
+	timespec wait = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+	nanosleep(&wait, 0);
+}
+
+inline void delay(unsigned long ms)
+{
+	if (MiniquadShimTimeSimulated) { MiniquadShimAdvance((uint64_t)ms * 1000); return; }
+	timespec wait = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000 };
+	nanosleep(&wait, 0);
+}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline void analogWrite(uint8_t, int) {}
+inline void interrupts() {}
+inline void noInterrupts() {}
+
+inline void attachInterrupt(uint8_t interrupt, void (*handler)(), int)
+{
+	if (interrupt < MINIQUAD_SHIM_INTERRUPTS) MiniquadShimInterruptHandlers[interrupt] = handler;
+}
+
+inline void detachInterrupt(uint8_t interrupt)
+{
+	if (interrupt < MINIQUAD_SHIM_INTERRUPTS) MiniquadShimInterruptHandlers[interrupt] = 0;
+}
+
+
+// @Params:			interrupt: The external interrupt (0 or 1)
+// @Return:			(void)
+// @Function:		Signal an edge on the pin of an external interrupt: the attached handler runs
+//					at once (the trigger mode is not checked).
+inline void MiniquadShimInterrupt(uint8_t interrupt)
+{
+	if (interrupt < MINIQUAD_SHIM_INTERRUPTS && MiniquadShimInterruptHandlers[interrupt] != 0)
+	{
+		MiniquadShimInterruptHandlers[interrupt]();
+	}
+}
+
+
+// Class: Serial port (discarded, only the debug output of I2Cdev uses it)
+class MiniquadShimSerial
+{
+public:
+	void begin(unsigned long) {}
+	template <typename T> void print(const T&) {}
+	template <typename T> void print(const T&, int) {}
+	template <typename T> void println(const T&) {}
+	template <typename T> void println(const T&, int) {}
+	void println() {}
+};
+
+extern MiniquadShimSerial Serial;
+
+
+#endif // !_MINIQUAD_SHIM_ARDUINO_H_
@@ -0,0 +1,35 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host shim of the Arduino EEPROM library: 1024 bytes of memory, erased (0xFF)
+// at the start of the program.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_SHIM_EEPROM_H_
+#define _MINIQUAD_SHIM_EEPROM_H_
+
+#include "Arduino.h"
+
+#define MINIQUAD_SHIM_EEPROM_SIZE (1024)
+
+
+// Class: EEPROM in memory
+class EEPROMClass
+{
+public:
+	EEPROMClass() { memset(_memory, 0xFF, sizeof(_memory)); }
+	uint8_t read(int address) { return _memory[address % MINIQUAD_SHIM_EEPROM_SIZE]; }
+	void write(int address, uint8_t value) { _memory[address % MINIQUAD_SHIM_EEPROM_SIZE] = value; }
+
+private:
+	uint8_t _memory[MINIQUAD_SHIM_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+
+#endif // !_MINIQUAD_SHIM_EEPROM_H_
@@ -0,0 +1,25 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host shim of the Arduino core: the global devices and the state of the shim
+// headers.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "EEPROM.h"
+
+MiniquadShimSerial Serial;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+bool MiniquadShimTimeSimulated = false;
+uint64_t MiniquadShimTime = 0;
+void (*MiniquadShimTimeListener)(void* context) = 0;
+void* MiniquadShimTimeListenerContext = 0;
+
+void (*MiniquadShimInterruptHandlers[MINIQUAD_SHIM_INTERRUPTS])() = { 0, 0 };
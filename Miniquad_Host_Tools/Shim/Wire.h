@@ -0,0 +1,44 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host shim of the Arduino Wire library: an empty I2C bus. Every address is
+// refused and nothing is read, so the library builds and links on Linux while the code
+// under test never reaches the MPU6050. The simulated MPU6050 (Simulator) is reached
+// through the I2CDEV_HOST_SIMULATION implementation of I2Cdev instead, which leaves Wire
+// to the calls of Miniquad (Wire.begin()).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_SHIM_WIRE_H_
+#define _MINIQUAD_SHIM_WIRE_H_
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH (32)
+
+
+// Class: I2C master of the empty bus
+class TwoWire
+{
+public:
+	void begin() {}
+	void setClock(uint32_t) {}
+	void beginTransmission(uint8_t) {}
+	void beginTransmission(int) {}
+	uint8_t endTransmission() { return 2; }			// NACK on the address
+	uint8_t endTransmission(uint8_t) { return 2; }
+	uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+	uint8_t requestFrom(int, int) { return 0; }
+	size_t write(uint8_t) { return 1; }
+	size_t write(const uint8_t*, size_t length) { return length; }
+	int available() { return 0; }
+	int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+
+#endif // !_MINIQUAD_SHIM_WIRE_H_
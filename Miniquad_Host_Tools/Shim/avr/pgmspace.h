@@ -0,0 +1,22 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host shim of the AVR flash access, so that the headers of the Miniquad Arduino
+// Extension Library build on Linux. The flash is ordinary memory on the host.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_SHIM_PGMSPACE_H_
+#define _MINIQUAD_SHIM_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_float(address) (*(const float*)(address))
+
+#endif // !_MINIQUAD_SHIM_PGMSPACE_H_
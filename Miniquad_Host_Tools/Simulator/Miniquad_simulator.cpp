@@ -0,0 +1,775 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the simulated MPU6050 of the host tools of the quadaxis copter "Miniquad Zero"
+// (C): the scripted motion and the register level model (see Miniquad_simulator.h).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Miniquad_simulator.h"
+#include "MPU6050.h"
+
+// Define: Bits of the registers handled by the model
+#define MINIQUAD_SIM_INT_DATA_RDY (1 << MPU6050_INTERRUPT_DATA_RDY_BIT)
+#define MINIQUAD_SIM_INT_DMP (1 << MPU6050_INTERRUPT_DMP_INT_BIT)
+#define MINIQUAD_SIM_INT_FIFO_OFLOW (1 << MPU6050_INTERRUPT_FIFO_OFLOW_BIT)
+#define MINIQUAD_SIM_USER_DMP_EN (1 << MPU6050_USERCTRL_DMP_EN_BIT)
+#define MINIQUAD_SIM_USER_FIFO_EN (1 << MPU6050_USERCTRL_FIFO_EN_BIT)
+#define MINIQUAD_SIM_USER_DMP_RESET (1 << MPU6050_USERCTRL_DMP_RESET_BIT)
+#define MINIQUAD_SIM_USER_FIFO_RESET (1 << MPU6050_USERCTRL_FIFO_RESET_BIT)
+#define MINIQUAD_SIM_USER_RESETS (0x0F)				// The self-clearing reset bits
+#define MINIQUAD_SIM_PWR1_DEVICE_RESET (1 << MPU6050_PWR1_DEVICE_RESET_BIT)
+#define MINIQUAD_SIM_PWR1_SLEEP (1 << MPU6050_PWR1_SLEEP_BIT)
+#define MINIQUAD_SIM_BANK_USER (1 << MPU6050_BANKSEL_CFG_USER_BANK_BIT)
+#define MINIQUAD_SIM_BANK_MASK (0x1F)
+
+// Define: Power-on values of the registers which are not zero
+#define MINIQUAD_SIM_PWR_MGMT_1_DEFAULT (MINIQUAD_SIM_PWR1_SLEEP)
+#define MINIQUAD_SIM_WHO_AM_I_DEFAULT (0x68)
+
+// Define: Size of the largest DMP packet (quaternion, gyro, acceleration and the footer)
+#define MINIQUAD_SIM_PACKET_SIZE (42)
+
+
+// @Params:			value: The value
+//					limit: The bound of the result
+// @Return:			A double indicating the value rounded and limited to [-limit - 1, limit]
+// @Function:		Quantize a sensor value to an integer register.
+static double Quantize(double value, double limit)
+{
+	value = floor(value + 0.5);
+	if (value > limit) return limit;
+	if (value < -limit - 1) return -limit - 1;
+	return value;
+}
+
+
+// @Params:			bytes: The destination (4 bytes, big-endian)
+//					value: The value
+// @Return:			(void)
+// @Function:		Write an int32 into a DMP packet.
+static void WriteInt32(uint8_t* bytes, uint32_t value)
+{
+	bytes[0] = (uint8_t)(value >> 24);
+	bytes[1] = (uint8_t)(value >> 16);
+	bytes[2] = (uint8_t)(value >> 8);
+	bytes[3] = (uint8_t)value;
+}
+
+
+// Class: MiniquadSimTrajectory
+
+MiniquadSimTrajectory::MiniquadSimTrajectory()
+{
+	Clear();
+}
+
+
+void MiniquadSimTrajectory::Clear()
+{
+	_segments.clear();
+	Start();
+}
+
+
+void MiniquadSimTrajectory::Add(const MiniquadSimSegment& segment)
+{
+	_segments.push_back(segment);
+}
+
+
+bool MiniquadSimTrajectory::Load(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file) { perror(path); return false; }
+
+	char line[512];
+	unsigned long number = 0;
+	bool parsed = true;
+	while (parsed && fgets(line, sizeof(line), file))
+	{
+		number++;
+		char* p = line;
+		while (*p == ' ' || *p == '\t') p++;
+		if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+		// Duration, rate and the optional acceleration
+		double values[7] = { 0, 0, 0, 0, 0, 0, 0 };
+		int k = 0;
+		for (; k < 7; k++)
+		{
+			char* next;
+			values[k] = strtod(p, &next);
+			if (next == p) break;
+			p = next;
+			while (*p == ' ' || *p == '\t' || *p == ',') p++;
+		}
+		if ((k != 4 && k != 7) || values[0] < 0)
+		{
+			fprintf(stderr, "%s:%lu: expected 'duration rate_x rate_y rate_z [accel_x accel_y accel_z]'\n", path, number);
+			parsed = false;
+			break;
+		}
+
+		MiniquadSimSegment segment;
+		segment.duration = (uint32_t)values[0];
+		for (int i = 0; i < 3; i++)
+		{
+			segment.rate[i] = values[1 + i];
+			segment.accel[i] = values[4 + i];
+		}
+		Add(segment);
+	}
+	fclose(file);
+	return parsed;
+}
+
+
+void MiniquadSimTrajectory::Start()
+{
+	_q[0] = 1; _q[1] = 0; _q[2] = 0; _q[3] = 0;
+	_running = !_segments.empty();
+	_segment = 0;
+	_segmentTime = 0;
+	_time = 0;
+}
+
+
+void MiniquadSimTrajectory::Step(uint32_t us)
+{
+	while (us > 0 && _running)
+	{
+		const MiniquadSimSegment& segment = _segments[_segment];
+		uint64_t length = (uint64_t)segment.duration * 1000;
+		uint32_t dt = (length - _segmentTime < us) ? (uint32_t)(length - _segmentTime) : us;
+
+		// Rotate about the constant body rate: q = q * (cos(angle/2), axis * sin(angle/2))
+		double wx = segment.rate[0] * (M_PI / 180);
+		double wy = segment.rate[1] * (M_PI / 180);
+		double wz = segment.rate[2] * (M_PI / 180);
+		double rate = sqrt(wx*wx + wy*wy + wz*wz);
+		if (rate > 0 && dt > 0)
+		{
+			double half = rate * dt * 1e-6 / 2;
+			double s = sin(half) / rate;
+			double d[4] = { cos(half), wx * s, wy * s, wz * s };
+			double q[4] =
+			{
+				_q[0]*d[0] - _q[1]*d[1] - _q[2]*d[2] - _q[3]*d[3],
+				_q[0]*d[1] + _q[1]*d[0] + _q[2]*d[3] - _q[3]*d[2],
+				_q[0]*d[2] - _q[1]*d[3] + _q[2]*d[0] + _q[3]*d[1],
+				_q[0]*d[3] + _q[1]*d[2] - _q[2]*d[1] + _q[3]*d[0]
+			};
+			double norm = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+			for (int i = 0; i < 4; i++) _q[i] = q[i] / norm;
+		}
+
+		// Move on to the next segment
+		_segmentTime += dt;
+		_time += dt;
+		us -= dt;
+		if (_segmentTime >= length)
+		{
+			_segment++;
+			_segmentTime = 0;
+			if (_segment >= _segments.size()) _running = false;
+		}
+	}
+}
+
+
+bool MiniquadSimTrajectory::IsAccelerating() const
+{
+	if (!_running) return false;
+	const double* accel = _segments[_segment].accel;
+	return accel[0] != 0 || accel[1] != 0 || accel[2] != 0;
+}
+
+
+uint64_t MiniquadSimTrajectory::GetDuration() const
+{
+	uint64_t duration = 0;
+	for (size_t i = 0; i < _segments.size(); i++) duration += (uint64_t)_segments[i].duration * 1000;
+	return duration;
+}
+
+
+void MiniquadSimTrajectory::GetAttitude(double q[4]) const
+{
+	for (int i = 0; i < 4; i++) q[i] = _q[i];
+}
+
+
+void MiniquadSimTrajectory::GetRate(double rate[3]) const
+{
+	for (int i = 0; i < 3; i++) rate[i] = _running ? _segments[_segment].rate[i] : 0;
+}
+
+
+void MiniquadSimTrajectory::GetAcceleration(double accel[3]) const
+{
+	// The specific force in the world frame (gravity pointing down reads +1g on z)
+	double v[3];
+	for (int i = 0; i < 3; i++) v[i] = _running ? _segments[_segment].accel[i] : 0;
+	v[2] += 1;
+
+	// Rotated into the body frame, v_body = R^T * v_world (R maps the body to the world)
+	double w = _q[0], x = _q[1], y = _q[2], z = _q[3];
+	double m[9] =
+	{
+		1 - 2*(y*y + z*z), 2*(x*y - w*z), 2*(x*z + w*y),
+		2*(x*y + w*z), 1 - 2*(x*x + z*z), 2*(y*z - w*x),
+		2*(x*z - w*y), 2*(y*z + w*x), 1 - 2*(x*x + y*y)
+	};
+	for (int i = 0; i < 3; i++) accel[i] = m[i] * v[0] + m[3 + i] * v[1] + m[6 + i] * v[2];
+}
+
+
+// Class: MiniquadSimMPU6050
+
+MiniquadSimMPU6050::MiniquadSimMPU6050(MiniquadSimTrajectory& trajectory, uint8_t address, uint8_t interrupt)
+	: _trajectory(trajectory), _address(address), _interrupt(interrupt), _attached(false), _fifoIn(0)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		_accelBias[i] = 0;
+		_gyroBias[i] = 0;
+	}
+	ResetStatistics();
+	PowerOn();
+}
+
+
+MiniquadSimMPU6050::~MiniquadSimMPU6050()
+{
+	if (_attached) Detach();
+}
+
+
+void MiniquadSimMPU6050::Attach()
+{
+	I2Cdev::attachHostDevice(_address, this);
+	MiniquadShimTimeListener = _timeListener;
+	MiniquadShimTimeListenerContext = this;
+	_attached = true;
+}
+
+
+void MiniquadSimMPU6050::Detach()
+{
+	I2Cdev::detachHostDevice(_address);
+	if (MiniquadShimTimeListenerContext == this)
+	{
+		MiniquadShimTimeListener = 0;
+		MiniquadShimTimeListenerContext = 0;
+	}
+	_attached = false;
+}
+
+
+void MiniquadSimMPU6050::PowerOn()
+{
+	_reset();
+	_tickTime = MiniquadShimClock();
+	_busRemainder = 0;
+}
+
+
+void MiniquadSimMPU6050::Update()
+{
+	uint64_t now = MiniquadShimClock();
+	if (now < _tickTime) { _tickTime = now; return; } // the clock of the shim has been switched
+
+	uint32_t period = _tickPeriod();
+	while (now - _tickTime >= period)
+	{
+		_tickTime += period;
+		_trajectory.Step(period);
+		_tick();
+		period = _tickPeriod();
+	}
+}
+
+
+void MiniquadSimMPU6050::SetBias(const double accel[3], const double gyro[3])
+{
+	for (int i = 0; i < 3; i++)
+	{
+		_accelBias[i] = accel[i];
+		_gyroBias[i] = gyro[i];
+	}
+}
+
+
+void MiniquadSimMPU6050::ResetStatistics()
+{
+	memset(&_statistics, 0, sizeof(_statistics));
+}
+
+
+bool MiniquadSimMPU6050::GetPacketAttitude(double q[4]) const
+{
+	for (int i = 0; i < 4; i++) q[i] = _packetAttitude[i];
+	return _packetRead;
+}
+
+
+uint8_t MiniquadSimMPU6050::read(uint8_t regAddr, uint8_t length, uint8_t *data)
+{
+	Update();
+
+	_pointer = regAddr & 0x7F;
+	_readBurst(length, data);
+
+	// Start, address, register, repeated start, address, data and stop (9 bits per byte)
+	_transfer(9 * (length + 3) + 3);
+	return length;
+}
+
+
+uint8_t MiniquadSimMPU6050::readCurrent(uint8_t length, uint8_t *data)
+{
+	Update();
+
+	_readBurst(length, data);
+
+	// Start, address, data and stop (9 bits per byte)
+	_transfer(9 * (length + 1) + 2);
+	return length;
+}
+
+
+uint8_t MiniquadSimMPU6050::write(uint8_t regAddr, uint8_t length, const uint8_t *data)
+{
+	Update();
+
+	// FIFO_R_W and MEM_R_W stream to the same register, the others advance
+	_pointer = regAddr & 0x7F;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		_writeRegister(_pointer, data[i]);
+		if (_pointer != MPU6050_RA_FIFO_R_W && _pointer != MPU6050_RA_MEM_R_W) _pointer = (_pointer + 1) & 0x7F;
+	}
+	_statistics.writes++;
+	_statistics.bytes += length;
+
+	// Start, address, register, data and stop (9 bits per byte)
+	_transfer(9 * (length + 2) + 2);
+	return 0;
+}
+
+
+// @Params:			length: The count of the bytes to read
+//					data: The container for the bytes
+// @Return:			(_pointer, _statistics)
+// @Function:		Read a burst of registers from the register address: FIFO_R_W and MEM_R_W
+//					stream from the same register, the others advance.
+void MiniquadSimMPU6050::_readBurst(uint8_t length, uint8_t *data)
+{
+	for (uint8_t i = 0; i < length; i++)
+	{
+		data[i] = _readRegister(_pointer);
+		if (_pointer != MPU6050_RA_FIFO_R_W && _pointer != MPU6050_RA_MEM_R_W) _pointer = (_pointer + 1) & 0x7F;
+	}
+	_statistics.reads++;
+	_statistics.bytes += length;
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Reset the device (DEVICE_RESET): the registers take their power-on values and
+//					the FIFO and the DMP memory are cleared. The clock keeps running.
+void MiniquadSimMPU6050::_reset()
+{
+	memset(_registers, 0, sizeof(_registers));
+	_pointer = 0;
+	_registers[MPU6050_RA_PWR_MGMT_1] = MINIQUAD_SIM_PWR_MGMT_1_DEFAULT;
+	_registers[MPU6050_RA_WHO_AM_I] = MINIQUAD_SIM_WHO_AM_I_DEFAULT;
+	memset(_memory, 0, sizeof(_memory));
+	_clearFifo();
+	_fifoLast = 0;
+	_packetAttitude[0] = 1; _packetAttitude[1] = 0; _packetAttitude[2] = 0; _packetAttitude[3] = 0;
+	_ticks = 0;
+	_dmpSamples = 0;
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Count a gyro output and take a sample at the sample rate
+//					(gyro output rate / (1 + SMPLRT_DIV)) unless the device sleeps.
+void MiniquadSimMPU6050::_tick()
+{
+	if (++_ticks <= _registers[MPU6050_RA_SMPLRT_DIV]) return;
+	_ticks = 0;
+	if (_registers[MPU6050_RA_PWR_MGMT_1] & MINIQUAD_SIM_PWR1_SLEEP) return;
+	_sample();
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Sample the motion into the sensor registers, the FIFO (the FIFO_EN selection)
+//					and the DMP, and raise the interrupts.
+void MiniquadSimMPU6050::_sample()
+{
+	double rate[3], accel[3];
+	_trajectory.GetRate(rate);
+	_trajectory.GetAcceleration(accel);
+
+	// Sensor registers (big-endian): acceleration, temperature and rotation
+	int16_t values[7] =
+	{
+		_accelRaw(accel[0], 0), _accelRaw(accel[1], 1), _accelRaw(accel[2], 2),
+		(int16_t)Quantize((MINIQUAD_SIM_TEMPERATURE - 36.53) * 340, 32767),
+		_gyroRaw(rate[0], 0), _gyroRaw(rate[1], 1), _gyroRaw(rate[2], 2)
+	};
+	for (int i = 0; i < 7; i++)
+	{
+		_registers[MPU6050_RA_ACCEL_XOUT_H + 2*i] = (uint8_t)((uint16_t)values[i] >> 8);
+		_registers[MPU6050_RA_ACCEL_XOUT_H + 2*i + 1] = (uint8_t)values[i];
+	}
+	_statistics.samples++;
+	uint8_t status = MINIQUAD_SIM_INT_DATA_RDY;
+
+	uint8_t userControl = _registers[MPU6050_RA_USER_CTRL];
+	if (userControl & MINIQUAD_SIM_USER_FIFO_EN)
+	{
+		// Raw samples in the order of the register map: acceleration, temperature, x, y, z gyro
+		static const uint8_t selection[5][3] =
+		{
+			{ 1 << MPU6050_ACCEL_FIFO_EN_BIT, MPU6050_RA_ACCEL_XOUT_H, 6 },
+			{ 1 << MPU6050_TEMP_FIFO_EN_BIT, MPU6050_RA_TEMP_OUT_H, 2 },
+			{ 1 << MPU6050_XG_FIFO_EN_BIT, MPU6050_RA_GYRO_XOUT_H, 2 },
+			{ 1 << MPU6050_YG_FIFO_EN_BIT, MPU6050_RA_GYRO_YOUT_H, 2 },
+			{ 1 << MPU6050_ZG_FIFO_EN_BIT, MPU6050_RA_GYRO_ZOUT_H, 2 }
+		};
+		uint8_t bytes[14];
+		uint8_t length = 0;
+		for (int i = 0; i < 5; i++)
+		{
+			if (!(_registers[MPU6050_RA_FIFO_EN] & selection[i][0])) continue;
+			memcpy(bytes + length, _registers + selection[i][1], selection[i][2]);
+			length += selection[i][2];
+		}
+		if (length > 0) _push(bytes, length);
+	}
+
+	// DMP packet at the DMP output rate (sample rate / (1 + D_0_22))
+	if (userControl & MINIQUAD_SIM_USER_DMP_EN)
+	{
+		if (++_dmpSamples > _memory[MINIQUAD_SIM_DMP_RATE_BANK][MINIQUAD_SIM_DMP_RATE_ADDRESS + 1])
+		{
+			_dmpSamples = 0;
+			if (userControl & MINIQUAD_SIM_USER_FIFO_EN) _pushDmpPacket();
+			status |= MINIQUAD_SIM_INT_DMP;
+		}
+	}
+
+	_raise(status);
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Write a DMP packet of the true motion to the FIFO: the quaternion (q30), then
+//					the rotation and the acceleration blocks unless the DMP memory skips them
+//					(raw value with the bias and the offsets in the upper 16 bits, the acceleration
+//					at half the register scale), then the footer.
+void MiniquadSimMPU6050::_pushDmpPacket()
+{
+	PacketRecord record;
+	_trajectory.GetAttitude(record.q);
+	double rate[3], accel[3];
+	_trajectory.GetRate(rate);
+	_trajectory.GetAcceleration(accel);
+
+	uint8_t packet[MINIQUAD_SIM_PACKET_SIZE];
+	uint8_t length = 0;
+	for (int i = 0; i < 4; i++, length += 4)
+	{
+		WriteInt32(packet + length, (uint32_t)(int32_t)Quantize(record.q[i] * 1073741824.0, 2147483647.0));
+	}
+	if (_memory[MINIQUAD_SIM_DMP_GYRO_BANK][MINIQUAD_SIM_DMP_GYRO_ADDRESS] != MINIQUAD_SIM_DMP_SKIP)
+	{
+		for (int i = 0; i < 3; i++, length += 4)
+		{
+			WriteInt32(packet + length, (uint32_t)(uint16_t)_gyroRaw(rate[i], i) << 16);
+		}
+	}
+	if (_memory[MINIQUAD_SIM_DMP_ACCEL_BANK][MINIQUAD_SIM_DMP_ACCEL_ADDRESS] != MINIQUAD_SIM_DMP_SKIP)
+	{
+		for (int i = 0; i < 3; i++, length += 4)
+		{
+			WriteInt32(packet + length, (uint32_t)(uint16_t)(_accelRaw(accel[i], i) >> 1) << 16);
+		}
+	}
+	packet[length++] = 0;
+	packet[length++] = 0;
+
+	record.begin = _fifoIn;
+	record.end = _fifoIn + length;
+	_packets.push_back(record);
+	_statistics.packets++;
+	_push(packet, length);
+}
+
+
+// @Params:			bytes: The bytes
+//					length: The count of the bytes
+// @Return:			(void)
+// @Function:		Write to the FIFO. A full FIFO drops its oldest bytes and raises FIFO_OFLOW.
+void MiniquadSimMPU6050::_push(const uint8_t* bytes, uint16_t length)
+{
+	bool overflow = false;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		if (_fifoCount == MINIQUAD_SIM_FIFO_SIZE)
+		{
+			_fifoHead = (_fifoHead + 1) % MINIQUAD_SIM_FIFO_SIZE;
+			_fifoCount--;
+			_fifoOut++;
+			_statistics.lost++;
+			overflow = true;
+		}
+		_fifo[(_fifoHead + _fifoCount) % MINIQUAD_SIM_FIFO_SIZE] = bytes[i];
+		_fifoCount++;
+		_fifoIn++;
+	}
+
+	if (overflow)
+	{
+		// The packets cut by the overflow are lost
+		while (!_packets.empty() && _packets.front().begin < _fifoOut) _packets.pop_front();
+		_statistics.overflows++;
+		_raise(MINIQUAD_SIM_INT_FIFO_OFLOW);
+	}
+}
+
+
+// @Params:			(void)
+// @Return:			A uint8_t indicating the oldest byte of the FIFO (the last one read again if empty)
+// @Function:		Read from the FIFO, following the DMP packets read whole.
+uint8_t MiniquadSimMPU6050::_pop()
+{
+	if (_fifoCount == 0) return _fifoLast;
+
+	_fifoLast = _fifo[_fifoHead];
+	_fifoHead = (_fifoHead + 1) % MINIQUAD_SIM_FIFO_SIZE;
+	_fifoCount--;
+	_fifoOut++;
+	while (!_packets.empty() && _packets.front().end <= _fifoOut)
+	{
+		memcpy(_packetAttitude, _packets.front().q, sizeof(_packetAttitude));
+		_packetRead = true;
+		_packets.pop_front();
+	}
+	return _fifoLast;
+}
+
+
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Empty the FIFO (FIFO_RESET).
+void MiniquadSimMPU6050::_clearFifo()
+{
+	_fifoHead = 0;
+	_fifoCount = 0;
+	_fifoOut = _fifoIn;
+	_packets.clear();
+	_packetRead = false;
+}
+
+
+// @Params:			status: The INT_STATUS bits of the events
+// @Return:			(void)
+// @Function:		Latch the events in INT_STATUS (cleared when read) and pulse the interrupt
+//					pin if INT_ENABLE selects one of them.
+void MiniquadSimMPU6050::_raise(uint8_t status)
+{
+	_registers[MPU6050_RA_INT_STATUS] |= status;
+	if (status & _registers[MPU6050_RA_INT_ENABLE])
+	{
+		_statistics.interrupts++;
+		MiniquadShimInterrupt(_interrupt);
+	}
+}
+
+
+// @Params:			bits: The count of the bits of the transaction
+// @Return:			(void)
+// @Function:		Account the bus time of a transaction at I2Cdev::getClock(), and let it pass
+//					on the simulated time.
+void MiniquadSimMPU6050::_transfer(uint32_t bits)
+{
+	uint32_t clock = I2Cdev::getClock();
+	if (clock == 0) clock = I2CDEV_CLOCK_STANDARD;
+	uint64_t time = (uint64_t)bits * 1000000000ULL / clock;
+	_statistics.busTime += time;
+
+	_busRemainder += time;
+	uint32_t us = _busRemainder / 1000;
+	_busRemainder %= 1000;
+	if (us > 0) MiniquadShimAdvance(us);
+}
+
+
+// @Params:			regAddr: The register
+// @Return:			A uint8_t indicating the value read
+// @Function:		Read a register, with the side effects of INT_STATUS, the FIFO and MEM_R_W.
+uint8_t MiniquadSimMPU6050::_readRegister(uint8_t regAddr)
+{
+	uint8_t value;
+	uint8_t* cell;
+	switch (regAddr)
+	{
+	case MPU6050_RA_INT_STATUS:
+		value = _registers[regAddr];
+		_registers[regAddr] = 0;
+		return value;
+
+	case MPU6050_RA_FIFO_COUNTH:
+		return (uint8_t)(_fifoCount >> 8);
+
+	case MPU6050_RA_FIFO_COUNTL:
+		return (uint8_t)_fifoCount;
+
+	case MPU6050_RA_FIFO_R_W:
+		return _pop();
+
+	case MPU6050_RA_MEM_R_W:
+		cell = _memoryCell();
+		_registers[MPU6050_RA_MEM_START_ADDR]++; // wraps within the bank
+		return cell ? *cell : 0;
+
+	default:
+		return _registers[regAddr];
+	}
+}
+
+
+// @Params:			regAddr: The register
+//					value: The value
+// @Return:			(void)
+// @Function:		Write a register, with the resets, the FIFO and MEM_R_W. The read-only
+//					registers ignore the write.
+void MiniquadSimMPU6050::_writeRegister(uint8_t regAddr, uint8_t value)
+{
+	uint8_t* cell;
+	switch (regAddr)
+	{
+	case MPU6050_RA_PWR_MGMT_1:
+		if (value & MINIQUAD_SIM_PWR1_DEVICE_RESET) _reset();
+		else _registers[regAddr] = value;
+		return;
+
+	case MPU6050_RA_USER_CTRL:
+		if (value & MINIQUAD_SIM_USER_FIFO_RESET) _clearFifo();
+		if (value & MINIQUAD_SIM_USER_DMP_RESET) _dmpSamples = 0;
+		_registers[regAddr] = value & ~MINIQUAD_SIM_USER_RESETS;
+		return;
+
+	case MPU6050_RA_SIGNAL_PATH_RESET: // self-clearing, the model has no filter state
+		return;
+
+	case MPU6050_RA_FIFO_R_W:
+		_push(&value, 1);
+		return;
+
+	case MPU6050_RA_MEM_R_W:
+		cell = _memoryCell();
+		if (cell) *cell = value;
+		_registers[MPU6050_RA_MEM_START_ADDR]++;
+		return;
+
+	case MPU6050_RA_DMP_INT_STATUS:
+	case MPU6050_RA_FIFO_COUNTH:
+	case MPU6050_RA_FIFO_COUNTL:
+	case MPU6050_RA_WHO_AM_I:
+		return;
+
+	default:
+		// INT_STATUS, the sensor data and the external sensor data are read-only
+		if (regAddr >= MPU6050_RA_INT_STATUS && regAddr <= MPU6050_RA_EXT_SENS_DATA_23) return;
+		_registers[regAddr] = value;
+		return;
+	}
+}
+
+
+// @Params:			(void)
+// @Return:			A uint8_t* indicating the DMP memory at BANK_SEL and MEM_START_ADDR (NULL for the
+//					user banks and the banks beyond the memory, which read 0 and ignore writes)
+// @Function:		Locate the memory cell of MEM_R_W.
+uint8_t* MiniquadSimMPU6050::_memoryCell()
+{
+	uint8_t bank = _registers[MPU6050_RA_BANK_SEL];
+	if (bank & MINIQUAD_SIM_BANK_USER) return NULL;
+	bank &= MINIQUAD_SIM_BANK_MASK;
+	if (bank >= MINIQUAD_SIM_MEMORY_BANKS) return NULL;
+	return &_memory[bank][_registers[MPU6050_RA_MEM_START_ADDR]];
+}
+
+
+// @Params:			(void)
+// @Return:			A uint32_t indicating the gyro output period (microseconds)
+// @Function:		Get the gyro output period: 8kHz with the low pass filter off (DLPF_CFG 0 or 7),
+//					1kHz otherwise.
+uint32_t MiniquadSimMPU6050::_tickPeriod() const
+{
+	uint8_t filter = _registers[MPU6050_RA_CONFIG] & 0x07;
+	return (filter == 0 || filter == 7) ? MINIQUAD_SIM_TICK_UNFILTERED : MINIQUAD_SIM_TICK_FILTERED;
+}
+
+
+// @Params:			regAddr: The high byte register of the x-axis offset
+//					axis: The axis (0 ~ 2)
+// @Return:			An int16_t indicating the offset register of the axis
+// @Function:		Read an offset register pair (big-endian).
+int16_t MiniquadSimMPU6050::_offset(uint8_t regAddr, uint8_t axis) const
+{
+	return (int16_t)((_registers[regAddr + 2*axis] << 8) | _registers[regAddr + 2*axis + 1]);
+}
+
+
+// @Params:			rate: The angular rate (degree/s)
+//					axis: The axis (0 ~ 2)
+// @Return:			An int16_t indicating the gyro register at FS_SEL (131 per degree/s at 250)
+// @Function:		Convert a rotation into the raw gyro, with the bias of the axis and its
+//					XG_OFFS_USR (32.8 per degree/s, a quarter of the scale at 250 degree/s).
+int16_t MiniquadSimMPU6050::_gyroRaw(double rate, uint8_t axis) const
+{
+	uint8_t range = (_registers[MPU6050_RA_GYRO_CONFIG] >> 3) & 0x03;
+	double offset = _offset(MPU6050_RA_XG_OFFS_USRH, axis) * 4.0;
+	return (int16_t)Quantize(((rate + _gyroBias[axis]) * 131.0 + offset) / (1 << range), 32767);
+}
+
+
+// @Params:			accel: The acceleration (g)
+//					axis: The axis (0 ~ 2)
+// @Return:			An int16_t indicating the accelerometer register at AFS_SEL (16384 per g at 2g)
+// @Function:		Convert an acceleration into the raw accelerometer, with the bias of the axis
+//					and its XA_OFFS (2048 per g, an eighth of the scale at 2g, bit 0 reserved).
+int16_t MiniquadSimMPU6050::_accelRaw(double accel, uint8_t axis) const
+{
+	uint8_t range = (_registers[MPU6050_RA_ACCEL_CONFIG] >> 3) & 0x03;
+	double offset = (_offset(MPU6050_RA_XA_OFFS_H, axis) & ~1) * 8.0;
+	return (int16_t)Quantize(((accel + _accelBias[axis]) * 16384 + offset) / (1 << range), 32767);
+}
+
+
+// @Params:			context: The device
+// @Return:			(void)
+// @Function:		Catch up with the simulated time of the shim.
+void MiniquadSimMPU6050::_timeListener(void* context)
+{
+	((MiniquadSimMPU6050*)context)->Update();
+}
@@ -0,0 +1,300 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the simulated MPU6050 of the host tools of the quadaxis copter "Miniquad Zero"
+// (C), a register level model attached to the I2CDEV_HOST_SIMULATION implementation of
+// I2Cdev (build the library with -DI2CDEV_IMPLEMENTATION=I2CDEV_HOST_SIMULATION). It
+// answers WHO_AM_I and keeps the configuration registers, takes the DMP firmware upload
+// into its memory banks, samples a scripted motion at the configured rate into the sensor
+// registers and the FIFO (raw samples or DMP packets), and raises INT_STATUS, the FIFO
+// overflow and the interrupt pin as the device does. Every transaction takes its time on
+// the bus at I2Cdev::getClock(), so on the simulated time of the shim the sensor path of
+// the firmware runs at the pace of the ATmega328 bus.
+//
+// The model does not execute the DMP code: the packets carry the attitude, the rotation
+// and the acceleration of the script in the layout of MotionApps v2.0 (the blocks patched
+// by MPU6050::dmpSetPacketContents()), at the output rate patched by dmpSetFIFORate().
+// The sensors have no noise. A bias can be injected per axis (SetBias()), and the offset
+// registers XA_OFFS and XG_OFFS_USR are added to the raw samples and to the rotation and
+// acceleration blocks of the DMP packets, so a calibration of the offsets can be checked;
+// the quaternion of the packets stays the true attitude.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#ifndef _MINIQUAD_SIMULATOR_H_
+#define _MINIQUAD_SIMULATOR_H_
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include "I2Cdev.h"
+
+#if I2CDEV_IMPLEMENTATION != I2CDEV_HOST_SIMULATION
+#error "The simulator needs the library built with -DI2CDEV_IMPLEMENTATION=I2CDEV_HOST_SIMULATION"
+#endif
+
+// Define: Register map, FIFO and DMP memory of the device
+#define MINIQUAD_SIM_REGISTERS (128)
+#define MINIQUAD_SIM_FIFO_SIZE (1024)
+#define MINIQUAD_SIM_MEMORY_BANKS (8)
+#define MINIQUAD_SIM_MEMORY_BANK_SIZE (256)
+
+// Define: DMP memory read by the model (see MPU6050_6Axis_MotionApps20.h)
+#define MINIQUAD_SIM_DMP_RATE_BANK (0x02)		// D_0_22, the output rate divider in the second byte
+#define MINIQUAD_SIM_DMP_RATE_ADDRESS (0x16)
+#define MINIQUAD_SIM_DMP_GYRO_BANK (0x07)		// CFG_9, the FIFO constructor of the gyro block
+#define MINIQUAD_SIM_DMP_GYRO_ADDRESS (0x47)
+#define MINIQUAD_SIM_DMP_ACCEL_BANK (0x07)		// CFG_12, the FIFO constructor of the acceleration block
+#define MINIQUAD_SIM_DMP_ACCEL_ADDRESS (0x6C)
+#define MINIQUAD_SIM_DMP_SKIP (0xA3)			// The no-op filling a left out block
+
+// Define: Gyro output period with and without the low pass filter (microseconds)
+#define MINIQUAD_SIM_TICK_FILTERED (1000)
+#define MINIQUAD_SIM_TICK_UNFILTERED (125)
+
+// Define: Temperature of the die (degree Celsius)
+#define MINIQUAD_SIM_TEMPERATURE (25.0)
+
+
+// Struct: Segment of a scripted motion, held for its duration
+struct MiniquadSimSegment
+{
+	uint32_t duration;		// The duration (milliseconds)
+	double rate[3];			// The angular rate in the body frame (degree/s)
+	double accel[3];		// The linear acceleration in the world frame without gravity (g)
+};
+
+
+// Class: Scripted motion of the simulated MPU6050. The segments play one after another from
+//        the identity attitude once started; the attitude integrates the body rate (exact
+//        for the constant rate of a segment) and the accelerometer feels the linear
+//        acceleration plus gravity in the body frame. Before Start() and after the last
+//        segment the device stays still.
+class MiniquadSimTrajectory
+{
+public:
+	MiniquadSimTrajectory();
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Remove all the segments and stop at the identity attitude.
+	void Clear();
+
+	// @Params:			segment: The segment
+	// @Return:			(void)
+	// @Function:		Append a segment to the script.
+	void Add(const MiniquadSimSegment& segment);
+
+	// @Params:			path: The script file, lines of
+	//						duration rate_x rate_y rate_z [accel_x accel_y accel_z]
+	//					(milliseconds, degree/s in the body frame, g in the world frame; separated
+	//					by tabs, spaces or commas, '#' starts a comment line)
+	// @Return:			A bool indicating whether the script has been read (errors go to stderr)
+	// @Function:		Append the segments of a script file.
+	bool Load(const char* path);
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Play the script from its first segment at the identity attitude.
+	void Start();
+
+	// @Params:			us: The time to advance (microseconds)
+	// @Return:			(void)
+	// @Function:		Advance the motion (the device model steps it at each of its samples).
+	void Step(uint32_t us);
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the script is playing
+	// @Function:		Check whether the script has been started and not finished yet.
+	bool IsRunning() const { return _running; }
+
+	// @Params:			(void)
+	// @Return:			A bool indicating whether the current segment has a linear acceleration
+	// @Function:		Check whether the accelerometer feels more than gravity.
+	bool IsAccelerating() const;
+
+	// @Params:			(void)
+	// @Return:			A uint64_t indicating the length of the script (microseconds)
+	// @Function:		Get the total duration of the segments.
+	uint64_t GetDuration() const;
+
+	// @Params:			(void)
+	// @Return:			A uint64_t indicating the time played since Start() (microseconds)
+	// @Function:		Get the position in the script.
+	uint64_t GetTime() const { return _time; }
+
+	// @Params:			q: The container for the attitude (w, x, y, z, body to world)
+	// @Return:			(void)
+	// @Function:		Get the true attitude.
+	void GetAttitude(double q[4]) const;
+
+	// @Params:			rate: The container for the angular rate in the body frame (degree/s)
+	// @Return:			(void)
+	// @Function:		Get the true rotation (zero while still).
+	void GetRate(double rate[3]) const;
+
+	// @Params:			accel: The container for the acceleration felt in the body frame (g)
+	// @Return:			(void)
+	// @Function:		Get the true acceleration of the accelerometer, the linear acceleration
+	//					plus gravity rotated into the body frame.
+	void GetAcceleration(double accel[3]) const;
+
+private:
+	std::vector<MiniquadSimSegment> _segments;
+	bool _running;				// Whether the script is playing
+	size_t _segment;			// The current segment
+	uint64_t _segmentTime;		// The time played in the current segment (microseconds)
+	uint64_t _time;				// The time played since Start() (microseconds)
+	double _q[4];				// The attitude (w, x, y, z)
+};
+
+
+// Struct: Bus and data statistics of the simulated MPU6050
+struct MiniquadSimStatistics
+{
+	uint32_t reads;			// Count of the read transactions
+	uint32_t writes;		// Count of the write transactions
+	uint32_t bytes;			// Count of the data bytes moved (both directions)
+	uint64_t busTime;		// The time the bus has been busy (nanoseconds)
+	uint32_t samples;		// Count of the sensor samples
+	uint32_t packets;		// Count of the DMP packets written to the FIFO
+	uint32_t overflows;		// Count of the FIFO overflows
+	uint32_t lost;			// Count of the bytes lost in FIFO overflows
+	uint32_t interrupts;	// Count of the pulses of the interrupt pin
+};
+
+
+// Class: Simulated MPU6050 on the host bus. It catches up with the clock of the shim at
+//        each transaction (or Update()), and advances the simulated time of the shim by
+//        the bus time of each transaction. Attach() also makes it the listener of the
+//        simulated time, so the delays of the firmware let the samples flow.
+class MiniquadSimMPU6050 : public I2Cdev_HostDevice
+{
+public:
+
+	// @Params:			trajectory: The motion sampled by the device (stepped by the device)
+	//					address: The I2C address (7-bit, 0x68 with AD0 low)
+	//					interrupt: The external interrupt wired to the INT pin
+	// @Return:			(void)
+	// @Function:		Create the device in its power-on state, not attached yet.
+	MiniquadSimMPU6050(MiniquadSimTrajectory& trajectory, uint8_t address = 0x68, uint8_t interrupt = 0);
+	~MiniquadSimMPU6050();
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Attach the device to the bus of I2Cdev and to the simulated time.
+	void Attach();
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Detach the device, the address then nacks.
+	void Detach();
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Cycle the power: the registers, the FIFO and the DMP memory are cleared.
+	void PowerOn();
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Take the samples due up to the clock of the shim.
+	void Update();
+
+	// @Params:			accel: The accelerometer bias per axis (g)
+	//					gyro: The gyroscope bias per axis (degree/s)
+	// @Return:			(void)
+	// @Function:		Inject sensor biases, added to the samples before the offset registers.
+	//					They belong to the part and are kept over PowerOn().
+	void SetBias(const double accel[3], const double gyro[3]);
+
+	// @Params:			(void)
+	// @Return:			A MiniquadSimStatistics& (!Reference) indicating the statistics
+	// @Function:		Get the counts of transactions, samples and FIFO events, and the bus time.
+	MiniquadSimStatistics& GetStatistics() { return _statistics; }
+
+	// @Params:			(void)
+	// @Return:			(void)
+	// @Function:		Clear the statistics.
+	void ResetStatistics();
+
+	// @Params:			(void)
+	// @Return:			A uint16_t indicating the count of bytes in the FIFO
+	// @Function:		Look at the FIFO without a transaction.
+	uint16_t GetFifoCount() const { return _fifoCount; }
+
+	// @Params:			q: The container for the attitude (w, x, y, z)
+	// @Return:			A bool indicating whether a whole DMP packet has been read since the last
+	//					FIFO reset
+	// @Function:		Get the true attitude of the last DMP packet read from the FIFO, the one
+	//					the firmware should have decoded.
+	bool GetPacketAttitude(double q[4]) const;
+
+	// I2Cdev_HostDevice
+	uint8_t read(uint8_t regAddr, uint8_t length, uint8_t *data);
+	uint8_t readCurrent(uint8_t length, uint8_t *data);
+	uint8_t write(uint8_t regAddr, uint8_t length, const uint8_t *data);
+
+private:
+
+	// Struct: A DMP packet in the FIFO and its true attitude
+	struct PacketRecord
+	{
+		uint64_t begin;		// The position of the first byte in the FIFO stream
+		uint64_t end;		// The position after the last byte
+		double q[4];
+	};
+
+	void _reset();
+	void _tick();
+	void _sample();
+	void _pushDmpPacket();
+	void _push(const uint8_t* bytes, uint16_t length);
+	uint8_t _pop();
+	void _clearFifo();
+	void _raise(uint8_t status);
+	void _transfer(uint32_t bits);
+	void _readBurst(uint8_t length, uint8_t *data);
+	uint8_t _readRegister(uint8_t regAddr);
+	void _writeRegister(uint8_t regAddr, uint8_t value);
+	uint8_t* _memoryCell();
+	uint32_t _tickPeriod() const;
+	int16_t _offset(uint8_t regAddr, uint8_t axis) const;
+	int16_t _gyroRaw(double rate, uint8_t axis) const;
+	int16_t _accelRaw(double accel, uint8_t axis) const;
+	static void _timeListener(void* context);
+
+	MiniquadSimTrajectory& _trajectory;
+	uint8_t _address;
+	uint8_t _interrupt;
+	bool _attached;
+
+	double _accelBias[3];		// The injected accelerometer bias (g)
+	double _gyroBias[3];		// The injected gyroscope bias (degree/s)
+
+	uint8_t _registers[MINIQUAD_SIM_REGISTERS];
+	uint8_t _pointer;			// The register address of the next transfer
+	uint8_t _memory[MINIQUAD_SIM_MEMORY_BANKS][MINIQUAD_SIM_MEMORY_BANK_SIZE];
+
+	uint8_t _fifo[MINIQUAD_SIM_FIFO_SIZE];	// Ring of the FIFO bytes
+	uint16_t _fifoHead;						// The oldest byte
+	uint16_t _fifoCount;
+	uint8_t _fifoLast;						// The last byte read (repeated on an empty FIFO)
+	uint64_t _fifoIn;						// Count of the bytes written since power-on
+	uint64_t _fifoOut;						// Count of the bytes read or lost since power-on
+	std::deque<PacketRecord> _packets;		// The DMP packets in the FIFO
+	double _packetAttitude[4];
+	bool _packetRead;
+
+	uint64_t _tickTime;			// The time of the last gyro output (microseconds of the shim)
+	uint32_t _ticks;			// Count of the gyro outputs since the last sample
+	uint32_t _dmpSamples;		// Count of the samples since the last DMP packet
+	uint32_t _busRemainder;		// The bus time not advanced yet (nanoseconds)
+
+	MiniquadSimStatistics _statistics;
+};
+
+
+#endif // !_MINIQUAD_SIMULATOR_H_
@@ -0,0 +1,410 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the host simulation of the quadaxis copter "Miniquad Zero" (C), see
+// Miniquad_simulator.h and ReadMe.txt. It runs the firmware (Miniquad of the Arduino
+// Extension Library, configured by Miniquad.h and the defines of the build) against the
+// simulated MPU6050 on the simulated time: the staged initialization with the DMP upload,
+// then the refresh loop over a motion script. It reports the time of the initialization
+// stages, the bus traffic, the FIFO statistics and the attitude error against the true
+// motion, so the changes of the sensor path show up as bus time, lost packets or error.
+// With --calibrate the sensors get a bias (--bias), Miniquad::CalibrateSensors() corrects
+// the offset registers before the script and the bias left is reported.
+//
+// The times are simulated: the bus time follows the bus rate of I2Cdev, the computations
+// of the firmware take no time. The loop stepping the initialization and refreshing the
+// data takes the period of --loop instead (a polling loop which does not touch the bus
+// would never see the time pass).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include "Miniquad.h"
+#include "Miniquad_simulator.h"
+
+// Define: Default period of the refresh loop (microseconds)
+#define MINIQUAD_SIM_LOOP (1000)
+
+// Define: Time the loop keeps running after the script, still (microseconds)
+#define MINIQUAD_SIM_TAIL (100000)
+
+// Define: Default tolerance of the settled attitude and angles error (degree): the DMP packets
+// only lose the quantization, the raw mode follows the estimator, which leans toward a lasting
+// acceleration (the Madgwick filter converges to the 0.2g of the default script, atan(0.2) =
+// 11.3 degree) and is only verified once it has settled. On the default script the Madgwick
+// filter settles within 0.22 degree, the slower Mahony filter is still 2.7 degree off a
+// second after the acceleration
+#if defined(MINIQUAD_RAW_MODE) && defined(MINIQUAD_RAW_MADGWICK)
+#define MINIQUAD_SIM_TOLERANCE (0.3)
+#elif defined(MINIQUAD_RAW_MODE)
+#define MINIQUAD_SIM_TOLERANCE (3.0)
+#else
+#define MINIQUAD_SIM_TOLERANCE (0.1)
+#endif // MINIQUAD_RAW_MODE
+
+// Define: Error the fixed point angles add to the tolerance of the angles (degree): the max of
+// QuaternionQ14::getYawPitchRoll() against the float math is 0.268 degree (make microbench
+// BENCH_ARGS=--accuracy BENCH_DEFINES=-DMINIQUAD_FIXED_POINT)
+#ifdef MINIQUAD_FIXED_POINT
+#define MINIQUAD_SIM_ANGLES_MARGIN (0.27)
+#else
+#define MINIQUAD_SIM_ANGLES_MARGIN (0.0)
+#endif // MINIQUAD_FIXED_POINT
+
+// Define: Time the raw mode estimators get to settle after a linear acceleration of the script
+// before their error is verified (microseconds)
+#define MINIQUAD_SIM_SETTLE (1000000)
+
+// Define: Longest step of the staged initialization with --verify (microseconds): the DMP
+// upload writes a memory bank of 256 bytes and reads it back in a step (14 ms at 400kHz)
+#define MINIQUAD_SIM_STEP_LIMIT (20000)
+
+// Define: Count of the samples averaged to measure the bias left by the calibration
+#define MINIQUAD_SIM_RESIDUAL_SAMPLES (200)
+
+// Define: Largest bias left by the calibration with --verify: the offsets step by 1/1024 g
+// (bit 0 reserved) and 1/32.8 degree/s, and the means of the calibration are truncated to
+// the sample resolution
+#define MINIQUAD_SIM_RESIDUAL_ACCEL (0.002)		// g
+#define MINIQUAD_SIM_RESIDUAL_GYRO (0.1)		// degree/s
+
+
+// Global: Default sensor bias of --calibrate (accelerometer x, y, z in g, gyroscope x, y, z
+// in degree/s)
+static const double defaultBias[6] = { 0.05, -0.03, 0.04, 2.5, -1.5, 0.8 };
+
+// Global: Default motion script (still, roll, pitch while accelerating, half a yaw turn, a
+// fast manoeuvre and back)
+static const MiniquadSimSegment defaultScript[] =
+{
+	{ 500, { 0, 0, 0 }, { 0, 0, 0 } },
+	{ 1000, { 30, 0, 0 }, { 0, 0, 0 } },
+	{ 1000, { 0, 20, 0 }, { 0.2, 0, 0 } },
+	{ 2000, { 0, 0, 90 }, { 0, 0, 0 } },
+	{ 250, { 200, -150, 100 }, { 0, 0.3, -0.2 } },
+	{ 250, { -200, 150, -100 }, { 0, -0.3, 0.2 } },
+	{ 1000, { -30, -20, 0 }, { 0, 0, 0 } },
+	{ 500, { 0, 0, 0 }, { 0, 0, 0 } }
+};
+
+// Global: Names of the initialization stages (MINIQUAD_INIT_PROPELLERS ~ MINIQUAD_INIT_FIRST_DATA)
+static const char* stageNames[] = { "idle", "propellers", "connect", "dmp_load", "dmp_start", "first_data" };
+
+// Global: The copter
+static Miniquad copter;
+
+
+// @Params:			a, b: The quaternions (w, x, y, z)
+// @Return:			A double indicating the angle of the rotation between them (degree)
+// @Function:		Measure the attitude error (the magnitudes are divided out, the Q14 quaternion
+//					of the DMP is only a unit quaternion to its resolution).
+static double AttitudeError(const double* a, const double* b)
+{
+	double dot = fabs(a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3]);
+	dot /= sqrt((a[0]*a[0] + a[1]*a[1] + a[2]*a[2] + a[3]*a[3]) * (b[0]*b[0] + b[1]*b[1] + b[2]*b[2] + b[3]*b[3]));
+	if (dot > 1) dot = 1;
+	return 2 * acos(dot) * (180 / M_PI);
+}
+
+
+// @Params:			q: The quaternion (w, x, y, z)
+//					ypr: The container for the yaw, pitch and roll angles (degree)
+// @Return:			(void)
+// @Function:		Get the angles with the formulas of Miniquad::GetYawPitchRoll() in double.
+static void YawPitchRollOf(const double* q, double* ypr)
+{
+	double w = q[0], x = q[1], y = q[2], z = q[3];
+	double gx = 2*(x*z - w*y), gy = 2*(w*x + y*z), gz = w*w - x*x - y*y + z*z;
+	ypr[0] = (180 / M_PI) * atan2(2*(x*y - w*z), 1 - 2*(y*y + z*z));
+	ypr[1] = (180 / M_PI) * atan(gx / sqrt(gy*gy + gz*gz));
+	ypr[2] = (180 / M_PI) * atan(gy / sqrt(gx*gx + gz*gz));
+}
+
+
+// @Params:			name: The name of the traffic
+//					statistics: The statistics of the device
+//					time: The elapsed simulated time (microseconds)
+// @Return:			(void)
+// @Function:		Report the bus traffic of the device.
+static void ReportBus(const char* name, const MiniquadSimStatistics& statistics, uint64_t time)
+{
+	printf("%s\treads %lu\twrites %lu\tbytes %lu\tbusy %.3f ms\tutilization %.1f%%\n", name,
+		(unsigned long)statistics.reads, (unsigned long)statistics.writes, (unsigned long)statistics.bytes,
+		statistics.busTime / 1e6, (time > 0) ? statistics.busTime / 10.0 / time : 0.0);
+}
+
+
+// @Params:			residual: The container for the mean bias (accelerometer x, y, z in g with the
+//					gravity taken out, gyroscope x, y, z in degree/s)
+// @Return:			(void)
+// @Function:		Average the sensor registers of the still and level device, as
+//					Miniquad::CalibrateSensors() does, to measure the bias it has left.
+static void MeasureBias(double residual[6])
+{
+	MPU6050 sensor;
+	double sum[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int i = 0; i < MINIQUAD_SIM_RESIDUAL_SAMPLES; i++)
+	{
+		int16_t values[6];
+		sensor.getMotion6(&values[0], &values[1], &values[2], &values[3], &values[4], &values[5]);
+		for (int k = 0; k < 6; k++) sum[k] += values[k];
+		delay(2);
+	}
+	for (int k = 0; k < 3; k++)
+	{
+		residual[k] = sum[k] / MINIQUAD_SIM_RESIDUAL_SAMPLES * MiniquadAccelUnit<MINIQUAD_ACCEL_RANGE, 0>::gPerLsb();
+		residual[3 + k] = sum[3 + k] / MINIQUAD_SIM_RESIDUAL_SAMPLES * Miniquad::GyroUnit::degreePerLsb();
+	}
+	residual[2] -= 1;
+
+	// Drop the data queued meanwhile, as the calibration does
+	sensor.resetFIFO();
+}
+
+
+#ifdef I2CDEV_TRACE
+// @Params:			(void)
+// @Return:			(void)
+// @Function:		Report the traffic per register of the I2Cdev tracer.
+static void ReportRegisters()
+{
+	printf("# register\treads\twrites\tbytes\ttime_us\tmax_us\terrors\n");
+	for (uint8_t i = 0; i < I2Cdev::getRegisterStatsCount(); i++)
+	{
+		I2Cdev_RegisterStats stats;
+		if (!I2Cdev::getRegisterStats(i, &stats)) continue;
+		printf("0x%02X:0x%02X\t%lu\t%lu\t%lu\t%lu\t%u\t%u\n", stats.devAddr, stats.regAddr,
+			(unsigned long)stats.reads, (unsigned long)stats.writes, (unsigned long)stats.bytes,
+			(unsigned long)stats.time, stats.maxTime, stats.errors);
+	}
+}
+#endif // I2CDEV_TRACE
+
+
+// @Params:			program: The name of the program
+// @Return:			(void)
+// @Function:		Print the usage.
+static void PrintUsage(const char* program)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  --script FILE      motion script, lines of 'duration rate_x rate_y rate_z [accel_x accel_y accel_z]'\n"
+		"                     (milliseconds, degree/s in the body frame, g in the world frame; default built in)\n"
+		"  --loop US          period of the refresh loop (default %d microseconds)\n"
+		"  --tolerance DEG    largest settled attitude and angles error of --verify (default %g degree;\n"
+		"                     the raw mode settles %g ms after a linear acceleration)\n"
+		"  --bias AX,AY,AZ,GX,GY,GZ  sensor bias (g, degree/s)\n"
+		"  --calibrate        calibrate the offsets before the script (with the default bias\n"
+		"                     unless --bias is given) and report the bias left\n"
+		"  --verify           fail if the initialization fails or blocks beyond %g ms in a step, no\n"
+		"                     sample arrives, a packet is lost, the settled attitude or angles error\n"
+		"                     is beyond the tolerance or the calibration has left a bias beyond %g g or %g degree/s\n",
+		program, MINIQUAD_SIM_LOOP, MINIQUAD_SIM_TOLERANCE, MINIQUAD_SIM_SETTLE / 1e3, MINIQUAD_SIM_STEP_LIMIT / 1e3,
+		MINIQUAD_SIM_RESIDUAL_ACCEL, MINIQUAD_SIM_RESIDUAL_GYRO);
+}
+
+
+int main(int argc, char** argv)
+{
+	const char* script = NULL;
+	uint32_t loop = MINIQUAD_SIM_LOOP;
+	double tolerance = MINIQUAD_SIM_TOLERANCE;
+	bool verify = false;
+	bool calibrate = false;
+	bool biased = false;
+	double bias[6];
+	memcpy(bias, defaultBias, sizeof(bias));
+
+	// Parse the options
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) script = argv[++i];
+		else if (strcmp(argv[i], "--loop") == 0 && i + 1 < argc) loop = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "--verify") == 0) verify = true;
+		else if (strcmp(argv[i], "--calibrate") == 0) calibrate = true;
+		else if (strcmp(argv[i], "--bias") == 0 && i + 1 < argc &&
+			sscanf(argv[++i], "%lf,%lf,%lf,%lf,%lf,%lf", &bias[0], &bias[1], &bias[2], &bias[3], &bias[4], &bias[5]) == 6) biased = true;
+		else { PrintUsage(argv[0]); return 2; }
+	}
+	if (loop == 0) { PrintUsage(argv[0]); return 2; }
+
+	// The device on the simulated time, still until the script starts
+	MiniquadShimTimeSimulated = true;
+	MiniquadSimTrajectory trajectory;
+	if (script)
+	{
+		if (!trajectory.Load(script)) return 1;
+	}
+	else
+	{
+		for (size_t i = 0; i < sizeof(defaultScript) / sizeof(defaultScript[0]); i++) trajectory.Add(defaultScript[i]);
+	}
+	MiniquadSimMPU6050 device(trajectory, MPU6050_DEFAULT_ADDRESS, MPU6050_INT_PIN);
+	if (biased || calibrate) device.SetBias(bias, bias + 3);
+	device.Attach();
+
+	// Initialize the copter, one stage step per loop
+	uint64_t start = MiniquadShimClock();
+	uint64_t stepMax = 0;
+	uint32_t steps = 0;
+	copter.BeginInitialize(false);
+	for (;;)
+	{
+		uint64_t stepStart = MiniquadShimClock();
+		uint8_t stage = copter.StepInitialize();
+		uint64_t stepTime = MiniquadShimClock() - stepStart;
+		if (stepTime > stepMax) stepMax = stepTime;
+		steps++;
+		if (stage >= MINIQUAD_INIT_DONE) break;
+		MiniquadShimAdvance(loop);
+	}
+	bool initialized = (copter.GetInitStage() == MINIQUAD_INIT_DONE);
+	uint64_t initTime = MiniquadShimClock() - start;
+	printf("initialization\t%s\t%.3f ms\n", initialized ? "done" : "failed", initTime / 1e3);
+	printf("init steps\t%lu\tlongest %.3f ms\n", (unsigned long)steps, stepMax / 1e3);
+	for (uint8_t stage = MINIQUAD_INIT_PROPELLERS; stage <= MINIQUAD_INIT_FIRST_DATA; stage++)
+	{
+		printf("stage %s\t%lu ms\n", stageNames[stage], (unsigned long)copter.GetInitStageTime(stage));
+	}
+	printf("dmp upload\t%lu us\n", (unsigned long)copter.GetDmpUploadTime());
+	printf("bus clock\t%lu Hz\n", (unsigned long)copter.GetBusClock());
+	ReportBus("init bus", device.GetStatistics(), initTime);
+	if (!initialized)
+	{
+		printf("init error\t%u (stage %s)\n", copter.GetInitError(), stageNames[copter.GetInitErrorStage() % 6]);
+		return 1;
+	}
+
+	// Calibrate the offsets, still and level before the script
+	bool calibrated = true;
+	double residual[6] = { 0, 0, 0, 0, 0, 0 };
+	if (calibrate)
+	{
+		calibrated = copter.CalibrateSensors();
+		MeasureBias(residual);
+		MiniquadCalibration& offsets = copter.GetCalibration();
+		printf("bias\taccel %.4f %.4f %.4f g\tgyro %.3f %.3f %.3f degree/s\n", bias[0], bias[1], bias[2], bias[3], bias[4], bias[5]);
+		printf("calibration\t%s\taccel offsets %d %d %d\tgyro offsets %d %d %d\n", calibrated ? "done" : "failed",
+			offsets.accelOffset[0], offsets.accelOffset[1], offsets.accelOffset[2],
+			offsets.gyroOffset[0], offsets.gyroOffset[1], offsets.gyroOffset[2]);
+		printf("residual bias\taccel %.4f %.4f %.4f g\tgyro %.3f %.3f %.3f degree/s\n",
+			residual[0], residual[1], residual[2], residual[3], residual[4], residual[5]);
+	}
+
+	// Play the script in the refresh loop
+	device.ResetStatistics();
+	copter.GetFifoStatistics() = MiniquadFifoStatistics();
+	trajectory.Start();
+	start = MiniquadShimClock();
+	uint64_t end = start + trajectory.GetDuration() + MINIQUAD_SIM_TAIL;
+	uint32_t refreshes = 0;
+	double errorSum = 0, errorMax = 0, anglesMax = 0;
+	double settledMax = 0, settledAnglesMax = 0;
+	bool disturbed = false;
+	uint64_t disturbedTime = 0;
+	while (MiniquadShimClock() < end)
+	{
+		MiniquadShimAdvance(loop);
+		if (!copter.TryRefreshDmpData()) continue;
+
+		// The truth: the packet decoded by the firmware, or the motion now in the raw mode
+		double truth[4];
+	#ifdef MINIQUAD_RAW_MODE
+		trajectory.GetAttitude(truth);
+	#else
+		if (!device.GetPacketAttitude(truth)) continue;
+	#endif // MINIQUAD_RAW_MODE
+		refreshes++;
+
+		// The DMP packets are their own truth, the raw mode estimators are verified once settled
+	#ifdef MINIQUAD_RAW_MODE
+		if (trajectory.IsAccelerating())
+		{
+			disturbed = true;
+			disturbedTime = MiniquadShimClock();
+		}
+	#endif // MINIQUAD_RAW_MODE
+		bool settled = !disturbed || MiniquadShimClock() - disturbedTime >= MINIQUAD_SIM_SETTLE;
+
+		Quaternion& quaternion = copter.GetQuaternion();
+		double estimate[4] = { quaternion.w, quaternion.x, quaternion.y, quaternion.z };
+		double error = AttitudeError(estimate, truth);
+		errorSum += error;
+		if (error > errorMax) errorMax = error;
+		if (settled && error > settledMax) settledMax = error;
+
+		// The angles of the firmware against the same formulas in double
+		YawPitchRoll& ypr = copter.GetYawPitchRoll();
+		double angles[3], firmware[3] = { ypr.getYaw(), ypr.getPitch(), ypr.getRoll() };
+		YawPitchRollOf(truth, angles);
+		for (int k = 0; k < 3; k++)
+		{
+			double difference = fabs(firmware[k] - angles[k]);
+			if (difference > 180) difference = 360 - difference;
+			if (difference > anglesMax) anglesMax = difference;
+			if (settled && difference > settledAnglesMax) settledAnglesMax = difference;
+		}
+	}
+	uint64_t runTime = MiniquadShimClock() - start;
+
+	// Report the run
+	MiniquadSimStatistics& statistics = device.GetStatistics();
+	MiniquadFifoStatistics& fifo = copter.GetFifoStatistics();
+	printf("run\t%.3f s\tloop %lu us\n", runTime / 1e6, (unsigned long)loop);
+	printf("refreshes\t%lu\n", (unsigned long)refreshes);
+	printf("device\tsamples %lu\tpackets %lu\toverflows %lu\tlost %lu bytes\tinterrupts %lu\n",
+		(unsigned long)statistics.samples, (unsigned long)statistics.packets, (unsigned long)statistics.overflows,
+		(unsigned long)statistics.lost, (unsigned long)statistics.interrupts);
+	printf("fifo\tpackets %lu\tdropped %lu\tresets %u\toverflows %u\trejected %u\trealigned %u\n",
+		(unsigned long)fifo.packets, (unsigned long)fifo.dropped, fifo.resets, fifo.overflows, fifo.rejected, fifo.realigned);
+	ReportBus("run bus", statistics, runTime);
+	printf("attitude error\tmean %.4f\tmax %.4f degree\n", refreshes ? errorSum / refreshes : 0.0, errorMax);
+	printf("angles error\tmax %.4f degree\n", anglesMax);
+	printf("settled error\tmax %.4f\tangles max %.4f degree\n", settledMax, settledAnglesMax);
+#ifdef I2CDEV_TRACE
+	ReportRegisters();
+#endif // I2CDEV_TRACE
+
+	if (!verify) return 0;
+	bool passed = true;
+	if (refreshes == 0) { fprintf(stderr, "no sample has arrived\n"); passed = false; }
+	if (statistics.overflows > 0 || fifo.dropped > 0)
+	{
+		fprintf(stderr, "packets lost: %lu overflows, %lu dropped\n", (unsigned long)statistics.overflows, (unsigned long)fifo.dropped);
+		passed = false;
+	}
+	if (settledMax > tolerance)
+	{
+		fprintf(stderr, "settled attitude error %.4f degree beyond %g\n", settledMax, tolerance);
+		passed = false;
+	}
+	if (settledAnglesMax > tolerance + MINIQUAD_SIM_ANGLES_MARGIN)
+	{
+		fprintf(stderr, "settled angles error %.4f degree beyond %g\n", settledAnglesMax, tolerance + MINIQUAD_SIM_ANGLES_MARGIN);
+		passed = false;
+	}
+	if (stepMax > MINIQUAD_SIM_STEP_LIMIT)
+	{
+		fprintf(stderr, "initialization step of %.3f ms beyond %.3f\n", stepMax / 1e3, MINIQUAD_SIM_STEP_LIMIT / 1e3);
+		passed = false;
+	}
+	if (!calibrated) { fprintf(stderr, "the calibration has failed\n"); passed = false; }
+	for (int k = 0; k < 3; k++)
+	{
+		if (fabs(residual[k]) > MINIQUAD_SIM_RESIDUAL_ACCEL || fabs(residual[3 + k]) > MINIQUAD_SIM_RESIDUAL_GYRO)
+		{
+			fprintf(stderr, "residual bias of axis %d: %.4f g, %.3f degree/s\n", k, residual[k], residual[3 + k]);
+			passed = false;
+		}
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the command line converter of the logged samples of the quadaxis copter "Miniquad
+// Zero" (C), see Miniquad_batch.h and ReadMe.txt. It reads the samples as text lines
+//		timestamp qw qx qy qz ax ay az
+// (separated by tabs, spaces or commas, '#' starts a comment line) and writes
+//		timestamp yaw pitch roll gx gy gz wx wy wz
+// separated by tabs. It can also verify a kernel against the scalar kernel and measure the
+// throughput of all the kernels.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "Miniquad_batch.h"
+
+// Define: Tolerances of the SIMD kernels against the scalar kernel (see Miniquad_batch.h)
+#define MINIQUAD_TOLERANCE_ANGLE (2e-4f)		// degree
+#define MINIQUAD_TOLERANCE_GRAVITY (1e-6f)		// g
+#define MINIQUAD_TOLERANCE_ACCELERATION (1e-5f)	// g
+
+// Define: Count of the timed runs of each kernel in the benchmark (the best one is reported)
+#define MINIQUAD_BENCH_RUNS (7)
+
+
+// Class: Storage of a batch of logged samples and of its converted data
+class SampleStore
+{
+public:
+	std::vector<double> timestamp;
+	std::vector<float> q[4];
+	std::vector<int16_t> a[3];
+	std::vector<float> out[9];
+
+	// @Params:			(void)
+	// @Return:			A size_t indicating the count of the samples
+	// @Function:		Get the count of the samples.
+	size_t Count() const
+	{
+		return timestamp.size();
+	}
+
+	// @Params:			t: The timestamp
+	//					sample: The quaternion (w, x, y, z) and the raw acceleration (x, y, z)
+	// @Return:			(void)
+	// @Function:		Append a sample.
+	void Append(double t, const double* sample)
+	{
+		timestamp.push_back(t);
+		for (int k = 0; k < 4; k++) q[k].push_back((float)sample[k]);
+		for (int k = 0; k < 3; k++) a[k].push_back((int16_t)sample[4 + k]);
+	}
+
+	// @Params:			(void)
+	// @Return:			A MiniquadLogBatch indicating the samples
+	// @Function:		Get the batch of the samples for the converter.
+	MiniquadLogBatch GetLog()
+	{
+		MiniquadLogBatch log;
+		log.count = Count();
+		log.qw = q[0].data(); log.qx = q[1].data(); log.qy = q[2].data(); log.qz = q[3].data();
+		log.ax = a[0].data(); log.ay = a[1].data(); log.az = a[2].data();
+		return log;
+	}
+
+	// @Params:			(void)
+	// @Return:			A MiniquadAttitudeBatch indicating the containers of the converted data
+	// @Function:		Size the output arrays and get them for the converter.
+	MiniquadAttitudeBatch GetAttitude()
+	{
+		for (int k = 0; k < 9; k++) out[k].resize(Count());
+		MiniquadAttitudeBatch attitude;
+		attitude.yaw = out[0].data(); attitude.pitch = out[1].data(); attitude.roll = out[2].data();
+		attitude.gx = out[3].data(); attitude.gy = out[4].data(); attitude.gz = out[5].data();
+		attitude.wx = out[6].data(); attitude.wy = out[7].data(); attitude.wz = out[8].data();
+		return attitude;
+	}
+};
+
+
+// @Params:			file: The input
+//					store: The container for the samples
+// @Return:			A bool indicating whether all the lines have been parsed
+// @Function:		Read the logged samples.
+static bool ReadSamples(FILE* file, SampleStore& store)
+{
+	char line[512];
+	unsigned long number = 0;
+	while (fgets(line, sizeof(line), file))
+	{
+		number++;
+		char* p = line;
+		while (*p == ' ' || *p == '\t') p++;
+		if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+		// Timestamp and 7 values
+		double values[8];
+		int k = 0;
+		for (; k < 8; k++)
+		{
+			char* next;
+			values[k] = strtod(p, &next);
+			if (next == p) break;
+			p = next;
+			while (*p == ' ' || *p == '\t' || *p == ',') p++;
+		}
+		if (k < 8)
+		{
+			fprintf(stderr, "line %lu: expected 8 values (timestamp qw qx qy qz ax ay az)\n", number);
+			return false;
+		}
+		store.Append(values[0], values + 1);
+	}
+	return true;
+}
+
+
+// @Params:			file: The output
+//					store: The converted samples
+// @Return:			(void)
+// @Function:		Write the converted data.
+static void WriteSamples(FILE* file, const SampleStore& store)
+{
+	fprintf(file, "# timestamp\tyaw\tpitch\troll\tgx\tgy\tgz\twx\twy\twz\n");
+	for (size_t i = 0; i < store.Count(); i++)
+	{
+		fprintf(file, "%.15g", store.timestamp[i]);
+		for (int k = 0; k < 9; k++) fprintf(file, "\t%.9g", store.out[k][i]);
+		fputc('\n', file);
+	}
+}
+
+
+// @Params:			store: The samples
+//					kernel: The kernel to check (MINIQUAD_KERNEL_*)
+//					accelScale: The acceleration scale
+// @Return:			A bool indicating whether the kernel is within the tolerances
+// @Function:		Compare a kernel with the scalar kernel and report the largest differences,
+//					and check that the tail of a batch short of a whole step matches the lanes.
+static bool VerifyKernel(SampleStore& store, uint8_t kernel, float accelScale)
+{
+	SampleStore reference = store;
+	MiniquadBatchConverter::Convert(store.GetLog(), store.GetAttitude(), accelScale, kernel);
+	MiniquadBatchConverter::Convert(reference.GetLog(), reference.GetAttitude(), accelScale, MINIQUAD_KERNEL_SCALAR);
+
+	// Largest difference of the angles (yaw wraps at 180 degree), gravity and acceleration
+	float error[3] = { 0.0f, 0.0f, 0.0f };
+	for (size_t i = 0; i < store.Count(); i++)
+	{
+		for (int k = 0; k < 9; k++)
+		{
+			float d = fabsf(store.out[k][i] - reference.out[k][i]);
+			if (k < 3 && d > 180.0f) d = 360.0f - d;
+			if (d > error[k / 3]) error[k / 3] = d;
+		}
+	}
+
+	// One sample less leaves a tail short of a whole step, which has to match the lanes
+	SampleStore shortened = store;
+	size_t tailErrors = 0;
+	if (shortened.Count() > 0)
+	{
+		shortened.timestamp.pop_back();
+		for (int k = 0; k < 4; k++) shortened.q[k].pop_back();
+		for (int k = 0; k < 3; k++) shortened.a[k].pop_back();
+		MiniquadBatchConverter::Convert(shortened.GetLog(), shortened.GetAttitude(), accelScale, kernel);
+		for (size_t i = 0; i < shortened.Count(); i++)
+		{
+			for (int k = 0; k < 9; k++)
+			{
+				if (memcmp(&shortened.out[k][i], &store.out[k][i], sizeof(float)) != 0) tailErrors++;
+			}
+		}
+	}
+
+	bool passed = error[0] <= MINIQUAD_TOLERANCE_ANGLE && error[1] <= MINIQUAD_TOLERANCE_GRAVITY &&
+		error[2] <= MINIQUAD_TOLERANCE_ACCELERATION && tailErrors == 0;
+	fprintf(stderr, "verify %s against scalar: angle %.3g degree, gravity %.3g, acceleration %.3g g, "
+		"tail %lu different: %s\n", MiniquadBatchConverter::GetKernelName(kernel), error[0], error[1], error[2],
+		(unsigned long)tailErrors, passed ? "ok" : "FAILED");
+	return passed;
+}
+
+
+// @Params:			store: The container for the samples
+//					count: Count of the synthetic samples
+// @Return:			(void)
+// @Function:		Generate random attitudes and accelerations over the whole ranges.
+static void MakeSamples(SampleStore& store, size_t count)
+{
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+	{
+		double s[7];
+		double n = 0;
+		for (int k = 0; k < 4; k++) { s[k] = rand() / (double)RAND_MAX - 0.5; n += s[k] * s[k]; }
+		for (int k = 0; k < 4; k++) s[k] /= sqrt(n);
+		for (int k = 4; k < 7; k++) s[k] = rand() % 65536 - 32768;
+		store.Append((double)i, s);
+	}
+}
+
+
+// @Params:			store: The samples
+//					accelScale: The acceleration scale
+// @Return:			(void)
+// @Function:		Measure the throughput of each supported kernel (best of the timed runs after a
+//					warm-up run).
+static void RunBenchmark(SampleStore& store, float accelScale)
+{
+	MiniquadLogBatch log = store.GetLog();
+	MiniquadAttitudeBatch attitude = store.GetAttitude();
+
+	printf("kernel\tsamples\tseconds\tsamples_per_second\n");
+	for (uint8_t kernel = MINIQUAD_KERNEL_SCALAR; kernel <= MINIQUAD_KERNEL_AVX2; kernel++)
+	{
+		if (!MiniquadBatchConverter::IsKernelSupported(kernel)) continue;
+		MiniquadBatchConverter::Convert(log, attitude, accelScale, kernel);
+		double best = 1e30;
+		for (int run = 0; run < MINIQUAD_BENCH_RUNS; run++)
+		{
+			timespec start, stop;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			MiniquadBatchConverter::Convert(log, attitude, accelScale, kernel);
+			clock_gettime(CLOCK_MONOTONIC, &stop);
+			double seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) * 1e-9;
+			if (seconds < best) best = seconds;
+		}
+		printf("%s\t%lu\t%.6f\t%.4g\n", MiniquadBatchConverter::GetKernelName(kernel),
+			(unsigned long)log.count, best, log.count / best);
+	}
+}
+
+
+// @Params:			program: The name of the program
+// @Return:			(void)
+// @Function:		Print the usage.
+static void PrintUsage(const char* program)
+{
+	fprintf(stderr,
+		"usage: %s [options] [input [output]]\n"
+		"  --kernel auto|scalar|sse|avx2   conversion kernel (default auto)\n"
+		"  --accel-scale G                 g per LSB of the raw acceleration (default 1/8192, DMP at 2g)\n"
+		"  --verify                        compare the kernel (all of them with --bench) with the\n"
+		"                                  scalar kernel, fail beyond the tolerances\n"
+		"  --bench N                       measure the throughput of the kernels on N random samples\n"
+		"input: lines of 'timestamp qw qx qy qz ax ay az' (default stdin)\n"
+		"output: lines of 'timestamp yaw pitch roll gx gy gz wx wy wz' (default stdout)\n",
+		program);
+}
+
+
+int main(int argc, char** argv)
+{
+	uint8_t kernel = MINIQUAD_KERNEL_AUTO;
+	float accelScale = 1.0f / 8192.0f;
+	bool verify = false;
+	size_t bench = 0;
+	const char* files[2] = { NULL, NULL };
+	int fileCount = 0;
+
+	// Parse the options
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			for (kernel = MINIQUAD_KERNEL_AUTO; kernel <= MINIQUAD_KERNEL_AVX2; kernel++)
+			{
+				if (strcmp(name, MiniquadBatchConverter::GetKernelName(kernel)) == 0) break;
+			}
+			if (kernel > MINIQUAD_KERNEL_AVX2) { PrintUsage(argv[0]); return 2; }
+			if (!MiniquadBatchConverter::IsKernelSupported(kernel))
+			{
+				fprintf(stderr, "kernel %s is not supported here\n", name);
+				return 2;
+			}
+		}
+		else if (strcmp(argv[i], "--accel-scale") == 0 && i + 1 < argc) accelScale = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--verify") == 0) verify = true;
+		else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) bench = strtoul(argv[++i], NULL, 10);
+		else if (argv[i][0] != '-' && fileCount < 2) files[fileCount++] = argv[i];
+		else { PrintUsage(argv[0]); return 2; }
+	}
+
+	// Verify and time all the kernels on random samples
+	if (bench > 0)
+	{
+		SampleStore store;
+		MakeSamples(store, bench);
+		bool passed = true;
+		for (uint8_t k = MINIQUAD_KERNEL_SSE; verify && k <= MINIQUAD_KERNEL_AVX2; k++)
+		{
+			if (MiniquadBatchConverter::IsKernelSupported(k)) passed = VerifyKernel(store, k, accelScale) && passed;
+		}
+		RunBenchmark(store, accelScale);
+		return passed ? 0 : 1;
+	}
+
+	// Read, convert and write the samples
+	FILE* input = files[0] ? fopen(files[0], "r") : stdin;
+	if (!input) { perror(files[0]); return 1; }
+	SampleStore store;
+	bool parsed = ReadSamples(input, store);
+	if (input != stdin) fclose(input);
+	if (!parsed) return 1;
+
+	if (kernel == MINIQUAD_KERNEL_AUTO) kernel = MiniquadBatchConverter::GetBestKernel();
+	if (verify)
+	{
+		if (!VerifyKernel(store, kernel, accelScale)) return 1;
+	}
+	else
+	{
+		MiniquadBatchConverter::Convert(store.GetLog(), store.GetAttitude(), accelScale, kernel);
+	}
+
+	FILE* output = files[1] ? fopen(files[1], "w") : stdout;
+	if (!output) { perror(files[1]); return 1; }
+	WriteSamples(output, store);
+	if (output != stdout) fclose(output);
+	return 0;
+}
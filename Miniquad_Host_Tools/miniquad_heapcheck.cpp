@@ -0,0 +1,20 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+//
+// This is the heap check of the Miniquad Arduino Extension Library. The build explicitly
+// instantiates the whole Miniquad class and links it with I2Cdev and MPU6050 into one
+// relocatable object ("make heapcheck"), which must not reference malloc, calloc, realloc,
+// free nor the operators new and delete: on a 2 KB-RAM part every buffer of the library is
+// static or on the stack. The library sources also poison the allocation functions, so this
+// check mostly guards the header-only parts (Miniquad.h, the MotionApps) and operator new.
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include "Miniquad.h"
+
+// Every member of the default Miniquad, used or not by a sketch
+template class BasicMiniquad<>;
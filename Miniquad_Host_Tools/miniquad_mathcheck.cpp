@@ -0,0 +1,194 @@
+// Copyright (C) 2013 Robot Club, Sun Yat-Sen University. All rights reserved.
+// Update:
+//		- 2026.10.16 : Created
+//
+// This is the accuracy check of the fast math of the Miniquad Arduino Extension Library
+// (FastMath of Miniquad_fastmath.h, selected by MINIQUAD_FAST_MATH). It sweeps the attitudes
+// of the whole unit-quaternion domain through the formulas of the Euler and yaw-pitch-roll
+// getters, and the argument ranges of asin, atan, sqrt and 1/sqrt densely, compares each
+// approximation with libm in double precision and fails if an error exceeds the bound
+// documented in Miniquad_fastmath.h ("make mathcheck" builds it with the polynomial and with
+// the table arctangent).
+//
+// It is free to use this library within the Robot Club. The copyright belongs to
+// the Robot Club, and the right authorship of each part belongs to its contributers.
+// === [ Robot Club ] ===
+
+#include <math.h>
+#include <stdio.h>
+#include "Miniquad_fastmath.h"
+
+// Define: The max errors documented in Miniquad_fastmath.h
+#ifdef MINIQUAD_FAST_MATH_TABLE
+#define MINIQUAD_BOUND_ATAN (2.1e-5)		// rad
+#define MINIQUAD_BOUND_ASIN (2.2e-5)		// rad
+#define MINIQUAD_MATHCHECK_CONFIG "table"
+#else
+#define MINIQUAD_BOUND_ATAN (2e-6)			// rad
+#define MINIQUAD_BOUND_ASIN (4e-6)			// rad
+#define MINIQUAD_MATHCHECK_CONFIG "polynomial"
+#endif // MINIQUAD_FAST_MATH_TABLE
+#define MINIQUAD_BOUND_SQRT (5e-6)			// relative
+#define MINIQUAD_BOUND_INV_SQRT (5e-6)		// relative
+
+// Define: Step of the attitude sweep (degree) and count of the steps of the argument sweeps
+#define MINIQUAD_SWEEP_ANGLE_STEP (2.0)
+#define MINIQUAD_SWEEP_STEPS (1 << 20)
+
+
+// Struct: Largest error of a function and its argument
+struct MathError
+{
+	const char* name;			// The name of the function
+	const char* unit;			// The unit of the error
+	double bound;				// The documented max error
+	double max;					// The largest error of the sweep
+	double x;					// The first argument of the largest error
+	double y;					// The second argument of the largest error (atan2)
+};
+
+
+// @Params:			error: The error record (Effect on it)
+//					difference: The error of an evaluation
+//					x, y: The arguments of the evaluation
+// @Return:			(void)
+// @Function:		Keep the largest error.
+static void AddError(MathError& error, double difference, double x, double y)
+{
+	difference = fabs(difference);
+	if (difference <= error.max) return;
+	error.max = difference;
+	error.x = x;
+	error.y = y;
+}
+
+
+// @Params:			error: The errors of atan2 (Effect on it)
+//					y, x: The arguments
+// @Return:			(void)
+// @Function:		Compare FastMath::atan2() with libm.
+static void CheckAtan2(MathError& error, float y, float x)
+{
+	double difference = (double)FastMath::atan2(y, x) - atan2((double)y, (double)x);
+	if (difference > M_PI) difference -= 2 * M_PI;
+	if (difference < -M_PI) difference += 2 * M_PI;
+	AddError(error, difference, y, x);
+}
+
+
+// @Params:			error: The errors of atan (Effect on it)
+//					z: The argument
+// @Return:			(void)
+// @Function:		Compare FastMath::atan() with libm.
+static void CheckAtan(MathError& error, float z)
+{
+	AddError(error, (double)FastMath::atan(z) - atan((double)z), z, 0);
+}
+
+
+// @Params:			error: The errors of asin (Effect on it)
+//					x: The argument
+// @Return:			(void)
+// @Function:		Compare FastMath::asin() with libm.
+static void CheckAsin(MathError& error, float x)
+{
+	AddError(error, (double)FastMath::asin(x) - asin((double)x), x, 0);
+}
+
+
+// @Params:			error: The errors of sqrt (Effect on it)
+//					x: The argument (x > 0)
+// @Return:			(void)
+// @Function:		Compare FastMath::sqrt() with libm (relative error).
+static void CheckSqrt(MathError& error, float x)
+{
+	double exact = sqrt((double)x);
+	AddError(error, ((double)FastMath::sqrt(x) - exact) / exact, x, 0);
+}
+
+
+// @Params:			error: The errors of 1/sqrt (Effect on it)
+//					x: The argument (x > 0)
+// @Return:			(void)
+// @Function:		Compare FastMath::invSqrt() with libm (relative error).
+static void CheckInvSqrt(MathError& error, float x)
+{
+	double exact = 1 / sqrt((double)x);
+	AddError(error, ((double)FastMath::invSqrt(x) - exact) / exact, x, 0);
+}
+
+
+int main()
+{
+	enum { ATAN2, ATAN, ASIN, SQRT, INV_SQRT, ERRORS };
+	MathError errors[ERRORS] = {
+		{ "FastMath::atan2", "rad", MINIQUAD_BOUND_ATAN, 0, 0, 0 },
+		{ "FastMath::atan", "rad", MINIQUAD_BOUND_ATAN, 0, 0, 0 },
+		{ "FastMath::asin", "rad", MINIQUAD_BOUND_ASIN, 0, 0, 0 },
+		{ "FastMath::sqrt", "relative", MINIQUAD_BOUND_SQRT, 0, 0, 0 },
+		{ "FastMath::invSqrt", "relative", MINIQUAD_BOUND_INV_SQRT, 0, 0, 0 }
+	};
+
+	// The attitudes of the unit-quaternion domain (yaw, pitch and roll grid) through the formulas
+	// of Miniquad::GetEulerAngle() and Miniquad::GetYawPitchRoll()
+	for (double yaw = -180; yaw < 180; yaw += MINIQUAD_SWEEP_ANGLE_STEP)
+	{
+		for (double pitch = -90; pitch <= 90; pitch += MINIQUAD_SWEEP_ANGLE_STEP)
+		{
+			for (double roll = -180; roll < 180; roll += MINIQUAD_SWEEP_ANGLE_STEP)
+			{
+				double cy = cos(yaw * (M_PI / 360)), sy = sin(yaw * (M_PI / 360));
+				double cp = cos(pitch * (M_PI / 360)), sp = sin(pitch * (M_PI / 360));
+				double cr = cos(roll * (M_PI / 360)), sr = sin(roll * (M_PI / 360));
+				float w = (float)(cr*cp*cy + sr*sp*sy), x = (float)(sr*cp*cy - cr*sp*sy);
+				float y = (float)(cr*sp*cy + sr*cp*sy), z = (float)(cr*cp*sy - sr*sp*cy);
+
+				// The rotation matrix entries of the getters (Quaternion::getRotationMatrix())
+				float m0 = 1 - 2*(y*y + z*z), m1 = 2*(x*y - w*z), m2 = 2*(x*z + w*y);
+				float m5 = 2*(y*z - w*x), m6 = 2*(x*z - w*y), m7 = 2*(y*z + w*x), m8 = 1 - 2*(x*x + y*y);
+				CheckAtan2(errors[ATAN2], m1, m0);
+				CheckAtan2(errors[ATAN2], m5, m8);
+				CheckAsin(errors[ASIN], m2);
+				float gyz = m7*m7 + m8*m8, gxz = m6*m6 + m8*m8;
+				if (gyz > 0) CheckSqrt(errors[SQRT], gyz);
+				if (gxz > 0) CheckSqrt(errors[SQRT], gxz);
+				if (gyz > 0) CheckAtan(errors[ATAN], m6 / FastMath::sqrt(gyz));
+				if (gxz > 0) CheckAtan(errors[ATAN], m7 / FastMath::sqrt(gxz));
+				CheckInvSqrt(errors[INV_SQRT], w*w + x*x + y*y + z*z);
+			}
+		}
+	}
+
+	// The argument ranges: the circle for atan2, [-1, 1] for asin, the tangents for atan and
+	// 65536 mantissas of each octave of 2^-16 ~ 2^16 for sqrt and 1/sqrt
+	for (int i = 0; i <= MINIQUAD_SWEEP_STEPS; i++)
+	{
+		double t = (double)i / MINIQUAD_SWEEP_STEPS;
+		CheckAtan2(errors[ATAN2], (float)sin(2 * M_PI * t - M_PI), (float)cos(2 * M_PI * t - M_PI));
+		CheckAsin(errors[ASIN], (float)(2 * t - 1));
+		CheckAtan(errors[ATAN], (float)tan(M_PI * t - M_PI_2));
+	}
+	for (int e = -16; e < 16; e++)
+	{
+		for (int i = 0; i < MINIQUAD_SWEEP_STEPS; i += 16)
+		{
+			float x = (float)ldexp(1 + (double)i / MINIQUAD_SWEEP_STEPS, e);
+			CheckSqrt(errors[SQRT], x);
+			CheckInvSqrt(errors[INV_SQRT], x);
+		}
+	}
+
+	// Report
+	int failures = 0;
+	printf("# fast math (%s arctangent), max error against libm\n", MINIQUAD_MATHCHECK_CONFIG);
+	printf("%-20s %12s %12s  %-9s %s\n", "function", "max", "bound", "unit", "at");
+	for (int k = 0; k < ERRORS; k++)
+	{
+		const MathError& error = errors[k];
+		bool failed = error.max > error.bound;
+		printf("%-20s %12.3g %12.3g  %-9s (%.9g, %.9g)%s\n", error.name, error.max, error.bound, error.unit,
+			error.x, error.y, failed ? " FAILED" : "");
+		if (failed) failures++;
+	}
+	return (failures == 0) ? 0 : 1;
+}